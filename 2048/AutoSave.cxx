@@ -0,0 +1,265 @@
+// Զ浵Ĺע飨Linuxstress ڿӵͬʱע롰ͳύӳϲд룻
+// crash ӽдԶ浵д;ʱɱϵļĳύ
+// 룺g++ -std=c++20 -O2 -DNDEBUG -pthread AutoSave.cxx -o autosave
+
+#include "AutoSave.h"
+#include "GameEngine.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+struct AutoSaveOptions {
+    uint64_t moves = 200000;
+    uint64_t seed = 2048;
+    uint64_t failEvery = 7;     // stressÿٴдעһʧܣ0 ʾע
+    int coalesceMs = 2;
+    int rounds = 200;           // crashӽ̸
+};
+
+// עϵļϵͳʧܻǰдһݣģдһʱļ
+class FaultyFileSystem : public NativeFileSystem {
+private:
+    uint64_t failEvery;
+    uint64_t crashAt;           // ڼдʱ0 ʾ
+    bool crashBeforeReplace;    // ʱļд֮󡢸֮ǰ
+    uint64_t writes;
+
+public:
+    FaultyFileSystem(uint64_t failInterval, uint64_t crashWrite, bool beforeReplace)
+        : failEvery(failInterval), crashAt(crashWrite), crashBeforeReplace(beforeReplace), writes(0) {
+    }
+
+    void WriteDurable(const std::string& path, const void* data, size_t size) override {
+        writes++;
+        if (crashAt != 0 && writes == crashAt && !crashBeforeReplace) {
+            NativeFileSystem::WriteDurable(path, data, size / 2);
+            raise(SIGKILL);
+        }
+        if (failEvery != 0 && writes % failEvery == 0) {
+            NativeFileSystem::WriteDurable(path, data, size / 2);
+            throw std::runtime_error("No space left on device (injected)");
+        }
+        NativeFileSystem::WriteDurable(path, data, size);
+    }
+
+    void Replace(const std::string& from, const std::string& to) override {
+        if (crashAt != 0 && writes == crashAt && crashBeforeReplace) {
+            raise(SIGKILL);
+        }
+        NativeFileSystem::Replace(from, to);
+    }
+};
+
+typedef std::tuple<uint64_t, uint32_t, uint8_t> StateKey;
+
+// ȷԵĶԾУѡϷ򣬽ӿ¾֡visit  false ʱֹͣ
+template <typename Visit>
+static void PlayStates(uint64_t seed, uint64_t moves, Visit visit) {
+    GameEngine game(seed);
+    GameRandom policy(SplitMix64(seed));
+    game.NewGame();
+    uint64_t games = 0;
+    for (uint64_t i = 0; i < moves; i++) {
+        if (game.IsGameOver()) {
+            game.Seed(SplitMix64(seed + ++games));
+            game.NewGame();
+        }
+        else {
+            uint32_t legal = game.GetLegalMoves();
+            int index = RandomBelow(static_cast<uint32_t>(policy.Next() >> 32), std::popcount(legal));
+            game.Move(static_cast<Direction>(BitBoard::SelectBit(legal, index)));
+            game.AddRandomTile();
+            game.CheckGameOver();
+        }
+        if (!visit(SaveFormat::CreatePackedSnapshot(game))) return;
+    }
+}
+
+static StateKey KeyOf(const PackedGameState& state) {
+    return StateKey(state.board, state.score, state.flags);
+}
+
+static int RunStress(const std::string& path, const AutoSaveOptions& options) {
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<size_t>(options.moves));
+    PackedGameState last = {};
+    AutoSaveStatus status;
+    auto start = std::chrono::steady_clock::now();
+    {
+        AutoSaver saver(path, std::make_unique<FaultyFileSystem>(options.failEvery, 0, false),
+            std::chrono::milliseconds(options.coalesceMs), std::chrono::milliseconds(options.coalesceMs));
+        PlayStates(options.seed, options.moves, [&](const PackedGameState& state) {
+            auto before = std::chrono::steady_clock::now();
+            saver.Submit(state);
+            latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - before).count());
+            last = state;
+            return true;
+        });
+        status = saver.Close();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Close д״̬ʧʱԣȫʧʱļͣڸľ棬Close ״̬ᱨ
+    PackedGameState saved;
+    bool loaded = AutoSaver::Load(path, saved);
+    bool latest = loaded && KeyOf(saved) == KeyOf(last);
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+    printf("moves       : %zu in %.3f s, coalesce %d ms, injected failure every %llu writes\n", latencies.size(),
+        seconds, options.coalesceMs, static_cast<unsigned long long>(options.failEvery));
+    printf("writes      : %llu, %llu failed (%s)\n", static_cast<unsigned long long>(status.written),
+        static_cast<unsigned long long>(status.failed), status.lastError.empty() ? "none" : status.lastError.c_str());
+    printf("submit      : p50 %.2f us, p99 %.2f us, p99.9 %.2f us, max %.2f us\n", percentile(0.5), percentile(0.99),
+        percentile(0.999), latencies.back());
+    printf("close       : %s\n", status.lastFailed ? "final write failed after retries" : "final state written");
+    printf("final file  : %s\n", latest ? "latest state" : loaded ? "older state (final write failed)" : "missing or corrupt");
+    // ļͣھɾ Close ûбʧܣ˵״̬
+    return loaded && (latest || status.lastFailed) ? 0 : 2;
+}
+
+static int RunCrash(const std::string& path, const AutoSaveOptions& options) {
+    GameRandom random(options.seed);
+    int intact = 0;
+    int missing = 0;
+    int corrupt = 0;
+    int injected = 0;
+    int missed = 0;
+    for (int round = 0; round < options.rounds; round++) {
+        std::remove(path.c_str());
+        uint64_t seed = SplitMix64(options.seed + static_cast<uint64_t>(round));
+        // һִڵ crashAt д;ǰɱһɸʱɱ
+        bool selfCrash = round % 2 == 0;
+        uint64_t crashAt = selfCrash ? 1 + random.Next() % (std::min)(options.moves, uint64_t(50)) : 0;
+        bool beforeReplace = (random.Next() & 1) != 0;
+
+        pid_t child = fork();
+        if (child < 0) {
+            throw std::runtime_error("fork failed");
+        }
+        if (child == 0) {
+            AutoSaver saver(path, std::make_unique<FaultyFileSystem>(0, crashAt, beforeReplace),
+                std::chrono::milliseconds(0), std::chrono::milliseconds(0));
+            // ɱִÿύд߳дһÿύǡһд룬 crashAt дһᷢ
+            uint64_t submitted = 0;
+            PlayStates(seed, options.moves, [&](const PackedGameState& state) {
+                saver.Submit(state);
+                if (selfCrash) {
+                    submitted++;
+                    while (saver.GetStatus().written < submitted) {
+                        std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    }
+                }
+                return true;
+            });
+            // ɸɱִȴд߳ճдľ
+            while (!selfCrash) {
+                pause();
+            }
+            _exit(0);
+        }
+
+        if (!selfCrash) {
+            usleep(static_cast<useconds_t>(random.Next() % 20000));
+            kill(child, SIGKILL);
+        }
+        int exitStatus = 0;
+        waitpid(child, &exitStatus, 0);
+        if (selfCrash && WIFSIGNALED(exitStatus)) injected++;
+        else if (selfCrash) missed++;
+
+        PackedGameState saved;
+        if (!AutoSaver::Load(path, saved)) {
+            // һθ֮ǰɱʱûļļȴǴ
+            FILE* file = fopen(path.c_str(), "rb");
+            if (file) {
+                fclose(file);
+                corrupt++;
+            }
+            else {
+                missing++;
+            }
+            continue;
+        }
+
+        bool found = false;
+        StateKey key = KeyOf(saved);
+        PlayStates(seed, options.moves, [&](const PackedGameState& state) {
+            found = KeyOf(state) == key;
+            return !found;
+        });
+        if (found) intact++;
+        else corrupt++;
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".tmp").c_str());
+
+    printf("rounds      : %d (%d crashed inside the writer, %d missed the injected crash, the rest killed at random times)\n",
+        options.rounds, injected, missed);
+    printf("result      : %d intact submitted states, %d not yet written, %d corrupt\n", intact, missing, corrupt);
+    // עıûзʱһûмд·ϵıͬʧ
+    return corrupt || missed ? 2 : 0;
+}
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "usage: %s stress FILE [--moves N] [--seed N] [--fail-every N] [--coalesce MS]\n", program);
+    fprintf(stderr, "       %s crash FILE [--rounds N] [--moves N] [--seed N]\n", program);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::string command = argv[1];
+    AutoSaveOptions options;
+    for (int i = 3; i < argc; i += 2) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        if (strcmp(arg, "--moves") == 0) options.moves = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--fail-every") == 0) options.failEvery = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--coalesce") == 0) options.coalesceMs = atoi(value);
+        else if (strcmp(arg, "--rounds") == 0) options.rounds = atoi(value);
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.moves == 0 || options.coalesceMs < 0 || options.rounds <= 0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        if (command == "stress") return RunStress(argv[2], options);
+        if (command == "crash") return RunCrash(argv[2], options);
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "autosave failed: %s\n", e.what());
+        return 1;
+    }
+
+    PrintUsage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+#include "SaveFormat.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Զ浵ļֶ浵ͬļͷ汾ţ2 PackedGameStateֱáء
+const size_t AUTOSAVE_FILE_SIZE = sizeof(SAVE_FILE_HEADER) + sizeof(SAVE_FILE_VERSION) + sizeof(PackedGameState);
+
+// Զ浵õļʱ滻Ϊעϵʵ
+class AutoSaveFileSystem {
+public:
+    virtual ~AutoSaveFileSystem() = default;
+
+    // ض pathд data ̣ʧʱ׳쳣²ļ
+    virtual void WriteDurable(const std::string& path, const void* data, size_t size) = 0;
+
+    //  from ԭӵ滻 toĿ¼
+    virtual void Replace(const std::string& from, const std::string& to) = 0;
+
+    virtual void Remove(const std::string& path) noexcept = 0;
+};
+
+class NativeFileSystem : public AutoSaveFileSystem {
+public:
+#if defined(_WIN32)
+    void WriteDurable(const std::string& path, const void* data, size_t size) override {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("cannot create " + path);
+        }
+        DWORD written = 0;
+        bool ok = WriteFile(file, data, static_cast<DWORD>(size), &written, NULL) && written == size &&
+            FlushFileBuffers(file);
+        CloseHandle(file);
+        if (!ok) {
+            throw std::runtime_error("failed writing " + path);
+        }
+    }
+
+    void Replace(const std::string& from, const std::string& to) override {
+        if (!MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+            throw std::runtime_error("cannot replace " + to);
+        }
+    }
+
+    void Remove(const std::string& path) noexcept override {
+        DeleteFileA(path.c_str());
+    }
+#else
+    void WriteDurable(const std::string& path, const void* data, size_t size) override {
+        int file = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (file < 0) {
+            throw std::runtime_error("cannot create " + path + ": " + strerror(errno));
+        }
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t written = write(file, bytes, size);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) {
+                int error = written < 0 ? errno : EIO;
+                close(file);
+                throw std::runtime_error("failed writing " + path + ": " + strerror(error));
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        if (fsync(file) != 0) {
+            int error = errno;
+            close(file);
+            throw std::runtime_error("cannot sync " + path + ": " + strerror(error));
+        }
+        close(file);
+    }
+
+    // rename ԭӵģͬĿ¼֤󿴵ļ
+    void Replace(const std::string& from, const std::string& to) override {
+        if (rename(from.c_str(), to.c_str()) != 0) {
+            throw std::runtime_error("cannot replace " + to + ": " + strerror(errno));
+        }
+        size_t slash = to.find_last_of('/');
+        std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : to.substr(0, slash);
+        int handle = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (handle >= 0) {
+            fsync(handle);
+            close(handle);
+        }
+    }
+
+    void Remove(const std::string& path) noexcept override {
+        unlink(path.c_str());
+    }
+#endif
+};
+
+struct AutoSaveStatus {
+    uint64_t submitted = 0;     // Submit ô
+    uint64_t written = 0;       // ɹд벢滻ĴĶύϲΪһ
+    uint64_t failed = 0;
+    bool lastFailed = false;    // һдǷʧܣ֮ɹд
+    std::string lastError;
+};
+
+// ̨Զ浵ֻ߳״̬ƽǰ̨ʱһνṹ帴ƣ
+// д߳̽ǰ̨дʱļ̡ԭӸд߳յύٵ coalesceDelay
+// ڼύֻдһΣдʧʱ״̬retryDelay ԣиµύ
+// رʱһдʧܻԣʧ Close ص״̬棬߿ʾû
+class AutoSaver {
+public:
+    static const int FINAL_WRITE_ATTEMPTS = 3;
+
+private:
+    std::string path;
+    std::unique_ptr<AutoSaveFileSystem> fileSystem;
+    std::chrono::milliseconds coalesceDelay;
+    std::chrono::milliseconds retryDelay;
+
+    PackedGameState buffers[2];
+    int front;              // ߳дĻһд߳
+    bool dirty;             // ǰ̨δд״̬
+    bool stopping;
+    AutoSaveStatus status;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread writer;
+
+public:
+    explicit AutoSaver(const std::string& savePath, std::unique_ptr<AutoSaveFileSystem> files = nullptr,
+        std::chrono::milliseconds coalesce = std::chrono::milliseconds(200),
+        std::chrono::milliseconds retry = std::chrono::milliseconds(2000))
+        : path(savePath), fileSystem(files ? std::move(files) : std::make_unique<NativeFileSystem>()),
+        coalesceDelay(coalesce), retryDelay(retry), buffers(), front(0), dirty(false), stopping(false) {
+        writer = std::thread([this]() { WriterLoop(); });
+    }
+
+    // ֹͣд̲߳дһύ״̬Ψһȴ̵ĵطص lastFailed Ϊ true
+    // ʾľûд̣ļͣڸľ档֮ Submit дʱԶ
+    AutoSaveStatus Close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (writer.joinable()) {
+            writer.join();
+        }
+        return GetStatus();
+    }
+
+    ~AutoSaver() {
+        Close();
+    }
+
+    AutoSaver(const AutoSaver&) = delete;
+    AutoSaver& operator=(const AutoSaver&) = delete;
+
+    // κ I/Oֻǰ̨δд״̬ʱд߳ѱѣ֪ͨ
+    void Submit(const PackedGameState& state) {
+        bool wasDirty;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffers[front] = state;
+            wasDirty = dirty;
+            dirty = true;
+            status.submitted++;
+        }
+        if (!wasDirty) {
+            wake.notify_one();
+        }
+    }
+
+    AutoSaveStatus GetStatus() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return status;
+    }
+
+    // ȡУԶ浵ļڡУʧʱ false
+    static bool Load(const std::string& path, PackedGameState& state) {
+        std::ifstream file(path, std::ios::binary);
+        char header[sizeof(SAVE_FILE_HEADER)];
+        uint32_t version = 0;
+        if (!file.read(header, sizeof(header)) || memcmp(header, SAVE_FILE_HEADER, sizeof(header)) != 0 ||
+            !file.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != SAVE_FILE_VERSION_2 ||
+            !file.read(reinterpret_cast<char*>(&state), sizeof(state))) {
+            return false;
+        }
+        return state.checksum == SaveFormat::CalculateCrc(state) && SaveFormat::ValidatePackedState(state);
+    }
+
+private:
+    void WriterLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        int finalFailures = 0;
+        while (true) {
+            wake.wait(lock, [this]() { return dirty || stopping; });
+            if (!stopping) {
+                wake.wait_for(lock, coalesceDelay, [this]() { return stopping; });
+            }
+            if (!dirty) {
+                return;
+            }
+
+            // ߳дһ߳ռ back
+            int back = front;
+            front ^= 1;
+            dirty = false;
+            lock.unlock();
+
+            std::string error;
+            try {
+                Write(buffers[back]);
+            }
+            catch (const std::exception& e) {
+                error = e.what();
+            }
+
+            lock.lock();
+            if (error.empty()) {
+                status.written++;
+                status.lastFailed = false;
+                continue;
+            }
+
+            status.failed++;
+            status.lastFailed = true;
+            status.lastError = error;
+            if (!dirty) {
+                buffers[front] = buffers[back];
+                dirty = true;
+            }
+            // رʱٵ retryDelayԼ
+            if (stopping) {
+                if (++finalFailures >= FINAL_WRITE_ATTEMPTS) return;
+                continue;
+            }
+            wake.wait_for(lock, retryDelay, [this]() { return stopping; });
+        }
+    }
+
+    void Write(const PackedGameState& state) {
+        char data[AUTOSAVE_FILE_SIZE];
+        memcpy(data, SAVE_FILE_HEADER, sizeof(SAVE_FILE_HEADER));
+        memcpy(data + sizeof(SAVE_FILE_HEADER), &SAVE_FILE_VERSION, sizeof(SAVE_FILE_VERSION));
+        memcpy(data + sizeof(SAVE_FILE_HEADER) + sizeof(SAVE_FILE_VERSION), &state, sizeof(state));
+
+        std::string temporary = path + ".tmp";
+        try {
+            fileSystem->WriteDurable(temporary, data, sizeof(data));
+            fileSystem->Replace(temporary, path);
+        }
+        catch (...) {
+            fileSystem->Remove(temporary);
+            throw;
+        }
+    }
+};
@@ -0,0 +1,270 @@
+#pragma once
+
+#include "BitBoard.h"
+#include "CpuFeatures.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(CPU_FEATURES_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BATCH_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define BATCH_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BATCH_TARGET_SSE41
+#define BATCH_TARGET_AVX2
+#endif
+
+// ƶһεöԴ̸ִһƶṹΪļϣSoA
+// ʱͨ CPUID ѡ AVX2ÿָ 2 ̣SSE4.1 ʵ֣߽λһ¡
+// SIMD ں˰ÿչΪ 16 ֽڣֽű任ΪƣñȽϺͻѹϲ
+class BatchMove {
+public:
+    enum class Kernel {
+        Scalar,
+        Sse41,
+        Avx2
+    };
+
+    // ̷ֱָscores  moved Ϊ nullptr
+    static void Apply(const Board* boards, const uint8_t* directions, size_t count,
+        Board* results, uint32_t* scores, uint8_t* moved) {
+        Apply(GetKernel(), boards, directions, count, results, scores, moved);
+    }
+
+    static void Apply(Kernel kernel, const Board* boards, const uint8_t* directions, size_t count,
+        Board* results, uint32_t* scores, uint8_t* moved) {
+        size_t done = 0;
+#if defined(CPU_FEATURES_X86)
+        if (kernel == Kernel::Avx2) {
+            done = ApplyAvx2(boards, directions, count, results, scores);
+        }
+        else if (kernel == Kernel::Sse41) {
+            done = ApplySse41(boards, directions, count, results, scores);
+        }
+#endif
+        ApplyScalar(boards + done, directions + done, count - done, results + done, scores ? scores + done : nullptr);
+
+        if (moved) {
+            for (size_t i = 0; i < count; i++) {
+                moved[i] = results[i] != boards[i];
+            }
+        }
+    }
+
+    static Kernel GetKernel() {
+        static const Kernel kernel = DetectKernel();
+        return kernel;
+    }
+
+    static const char* GetKernelName(Kernel kernel) {
+        switch (kernel) {
+        case Kernel::Avx2: return "avx2";
+        case Kernel::Sse41: return "sse4.1";
+        default: return "scalar";
+        }
+    }
+
+    static Kernel DetectKernel() {
+        const CpuFeatures& features = CpuFeatures::Get();
+        if (features.avx2) return Kernel::Avx2;
+        if (features.sse41) return Kernel::Sse41;
+        return Kernel::Scalar;
+    }
+
+    static void ApplyScalar(const Board* boards, const uint8_t* directions, size_t count,
+        Board* results, uint32_t* scores) {
+        for (size_t i = 0; i < count; i++) {
+            MoveResult result = BitBoard::Move(boards[i], static_cast<Direction>(directions[i] & 3));
+            results[i] = result.board;
+            if (scores) scores[i] = result.score;
+        }
+    }
+
+#if defined(CPU_FEATURES_X86)
+private:
+    // չ row * 4 + col ֽΪøָPRE Ѹ任ΪƣPOST 任
+    alignas(16) static constexpr uint8_t SHUFFLE_PRE[DIRECTION_COUNT][16] = {
+        { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+        { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 },
+        { 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15 },
+        { 12, 8, 4, 0, 13, 9, 5, 1, 14, 10, 6, 2, 15, 11, 7, 3 }
+    };
+    alignas(16) static constexpr uint8_t SHUFFLE_POST[DIRECTION_COUNT][16] = {
+        { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+        { 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 },
+        { 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15 },
+        { 3, 7, 11, 15, 2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12 }
+    };
+    // ϲ󷽿ֵ 2^e ĵֽֽڣe = 0 λòǺϲΪ 0
+    alignas(16) static constexpr uint8_t POWER_LOW[16] = {
+        0, 2, 4, 8, 16, 32, 64, 128, 0, 0, 0, 0, 0, 0, 0, 0
+    };
+    alignas(16) static constexpr uint8_t POWER_HIGH[16] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, 128
+    };
+
+    // ÿ 32 λͨһУȥոٴϲϲµĿո
+    BATCH_TARGET_SSE41 static __m128i SlideLeft128(__m128i x, __m128i& scoreLow, __m128i& scoreHigh) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i maxExponent = _mm_set1_epi8(MAX_TILE_EXPONENT);
+
+        for (int i = 0; i < BOARD_SIZE - 1; i++) {
+            x = CompactStep128(x);
+        }
+
+        __m128i next = _mm_srli_epi32(x, 8);
+        __m128i equal = _mm_and_si128(_mm_cmpeq_epi8(x, next), _mm_cmpgt_epi8(x, zero));
+        equal = _mm_and_si128(equal, _mm_cmpgt_epi8(maxExponent, x));
+
+        // ͬһгʱֻпһȺϲ
+        __m128i merge = _mm_andnot_si128(_mm_slli_epi32(equal, 8), equal);
+        merge = _mm_andnot_si128(_mm_slli_epi32(merge, 8), equal);
+
+        x = _mm_sub_epi8(x, merge);
+        x = _mm_andnot_si128(_mm_slli_epi32(merge, 8), x);
+
+        __m128i merged = _mm_and_si128(x, merge);
+        scoreLow = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(POWER_LOW)), merged);
+        scoreHigh = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(POWER_HIGH)), merged);
+
+        return CompactStep128(x);
+    }
+
+    // ȥÿеһո񣺸ÿոҲĸһ
+    BATCH_TARGET_SSE41 static __m128i CompactStep128(__m128i x) {
+        __m128i empty = _mm_cmpeq_epi8(x, _mm_setzero_si128());
+        __m128i prefix = _mm_or_si128(empty, _mm_slli_epi32(empty, 8));
+        prefix = _mm_or_si128(prefix, _mm_slli_epi32(prefix, 16));
+        return _mm_blendv_epi8(x, _mm_srli_epi32(x, 8), prefix);
+    }
+
+    BATCH_TARGET_SSE41 static size_t ApplySse41(const Board* boards, const uint8_t* directions, size_t count,
+        Board* results, uint32_t* scores) {
+        const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+        const __m128i packWeights = _mm_set1_epi16(0x1001);
+
+        for (size_t i = 0; i < count; i++) {
+            int direction = directions[i] & 3;
+            __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&boards[i]));
+            __m128i cells = _mm_unpacklo_epi8(_mm_and_si128(packed, nibbleMask),
+                _mm_and_si128(_mm_srli_epi16(packed, 4), nibbleMask));
+
+            cells = _mm_shuffle_epi8(cells, _mm_load_si128(reinterpret_cast<const __m128i*>(SHUFFLE_PRE[direction])));
+            __m128i scoreLow, scoreHigh;
+            cells = SlideLeft128(cells, scoreLow, scoreHigh);
+            cells = _mm_shuffle_epi8(cells, _mm_load_si128(reinterpret_cast<const __m128i*>(SHUFFLE_POST[direction])));
+
+            __m128i repacked = _mm_packus_epi16(_mm_maddubs_epi16(cells, packWeights), _mm_setzero_si128());
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(&results[i]), repacked);
+
+            if (scores) {
+                __m128i low = _mm_sad_epu8(scoreLow, _mm_setzero_si128());
+                __m128i high = _mm_sad_epu8(scoreHigh, _mm_setzero_si128());
+                __m128i sum = _mm_add_epi64(low, _mm_slli_epi64(high, 8));
+                sum = _mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum));
+                scores[i] = static_cast<uint32_t>(_mm_cvtsi128_si32(sum));
+            }
+        }
+        return count;
+    }
+
+    BATCH_TARGET_AVX2 static __m256i CompactStep256(__m256i x) {
+        __m256i empty = _mm256_cmpeq_epi8(x, _mm256_setzero_si256());
+        __m256i prefix = _mm256_or_si256(empty, _mm256_slli_epi32(empty, 8));
+        prefix = _mm256_or_si256(prefix, _mm256_slli_epi32(prefix, 16));
+        return _mm256_blendv_epi8(x, _mm256_srli_epi32(x, 8), prefix);
+    }
+
+    BATCH_TARGET_AVX2 static __m256i LoadShuffle256(const uint8_t (*table)[16], int first, int second) {
+        return _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table[first]))),
+            _mm_load_si128(reinterpret_cast<const __m128i*>(table[second])), 1);
+    }
+
+    //  SSE4.1 汾ͬÿ 128 λͨһ
+    BATCH_TARGET_AVX2 static size_t ApplyAvx2(const Board* boards, const uint8_t* directions, size_t count,
+        Board* results, uint32_t* scores) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+        const __m256i packWeights = _mm256_set1_epi16(0x1001);
+        const __m256i maxExponent = _mm256_set1_epi8(MAX_TILE_EXPONENT);
+        const __m256i powerLow = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(POWER_LOW)));
+        const __m256i powerHigh = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(POWER_HIGH)));
+
+        size_t pairs = count / 2;
+        for (size_t p = 0; p < pairs; p++) {
+            size_t i = p * 2;
+            int first = directions[i] & 3;
+            int second = directions[i + 1] & 3;
+
+            __m128i both = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&boards[i]));
+            __m256i packed = _mm256_inserti128_si256(_mm256_castsi128_si256(both), _mm_unpackhi_epi64(both, both), 1);
+            __m256i x = _mm256_unpacklo_epi8(_mm256_and_si256(packed, nibbleMask),
+                _mm256_and_si256(_mm256_srli_epi16(packed, 4), nibbleMask));
+
+            x = _mm256_shuffle_epi8(x, LoadShuffle256(SHUFFLE_PRE, first, second));
+
+            for (int step = 0; step < BOARD_SIZE - 1; step++) {
+                x = CompactStep256(x);
+            }
+
+            __m256i next = _mm256_srli_epi32(x, 8);
+            __m256i equal = _mm256_and_si256(_mm256_cmpeq_epi8(x, next), _mm256_cmpgt_epi8(x, zero));
+            equal = _mm256_and_si256(equal, _mm256_cmpgt_epi8(maxExponent, x));
+            __m256i merge = _mm256_andnot_si256(_mm256_slli_epi32(equal, 8), equal);
+            merge = _mm256_andnot_si256(_mm256_slli_epi32(merge, 8), equal);
+
+            x = _mm256_sub_epi8(x, merge);
+            x = _mm256_andnot_si256(_mm256_slli_epi32(merge, 8), x);
+
+            if (scores) {
+                __m256i merged = _mm256_and_si256(x, merge);
+                __m256i low = _mm256_sad_epu8(_mm256_shuffle_epi8(powerLow, merged), zero);
+                __m256i high = _mm256_sad_epu8(_mm256_shuffle_epi8(powerHigh, merged), zero);
+                __m256i sum = _mm256_add_epi64(low, _mm256_slli_epi64(high, 8));
+                sum = _mm256_add_epi64(sum, _mm256_unpackhi_epi64(sum, sum));
+                scores[i] = static_cast<uint32_t>(_mm256_cvtsi256_si32(sum));
+                scores[i + 1] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm256_extracti128_si256(sum, 1)));
+            }
+
+            x = CompactStep256(x);
+            x = _mm256_shuffle_epi8(x, LoadShuffle256(SHUFFLE_POST, first, second));
+
+            __m256i repacked = _mm256_packus_epi16(_mm256_maddubs_epi16(x, packWeights), zero);
+            __m128i result = _mm_unpacklo_epi64(_mm256_castsi256_si128(repacked), _mm256_extracti128_si256(repacked, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&results[i]), result);
+        }
+
+        return pairs * 2;
+    }
+#endif
+};
+
+// ṹΪΣRL ȳÿ̵һ Step
+class BoardBatch {
+public:
+    std::vector<Board> boards;
+    std::vector<uint8_t> directions;
+    std::vector<Board> results;
+    std::vector<uint32_t> scores;
+    std::vector<uint8_t> moved;
+
+    explicit BoardBatch(size_t count = 0) {
+        Resize(count);
+    }
+
+    void Resize(size_t count) {
+        boards.resize(count);
+        directions.resize(count);
+        results.resize(count);
+        scores.resize(count);
+        moved.resize(count);
+    }
+
+    size_t Size() const { return boards.size(); }
+
+    void Step() {
+        BatchMove::Apply(boards.data(), directions.data(), boards.size(), results.data(), scores.data(), moved.data());
+    }
+};
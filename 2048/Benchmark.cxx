@@ -0,0 +1,649 @@
+// ȵ·΢׼硢С־ֲϲ ns/opops/s ÿβڴ
+// 룺g++ -std=c++20 -O2 -DNDEBUG -pthread Benchmark.cxx -o benchmark
+//  --json 棬 --baseline ֮ǰĽȽϣֵıԷ˳뱨
+
+#include "BatchMove.h"
+#include "Heuristic.h"
+#include "MovePolicy.h"
+#include "SaveSlots.h"
+#include "SessionStore.h"
+#include "SoftwareRenderer.h"
+#include "VectorEnv.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 滻ȫȫ operator new/deleteͨ顢 nothrow ʽͳƱķ
+// ͷżĺ new صָ뱻 free󱨲ƥ
+static std::atomic<uint64_t> allocationCount(0);
+
+[[gnu::noinline]] static void* CountedAllocate(size_t size, size_t alignment) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (alignment <= alignof(std::max_align_t)) {
+        return malloc(size ? size : 1);
+    }
+    // aligned_alloc ҪСǶֵ
+    size_t rounded = (size + alignment - 1) / alignment * alignment;
+    return aligned_alloc(alignment, rounded ? rounded : alignment);
+}
+
+[[gnu::noinline]] static void CountedFree(void* memory) noexcept {
+    free(memory);
+}
+
+static void* CountedAllocateOrThrow(size_t size, size_t alignment) {
+    if (void* memory = CountedAllocate(size, alignment)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size) { return CountedAllocateOrThrow(size, 0); }
+void* operator new[](size_t size) { return CountedAllocateOrThrow(size, 0); }
+void* operator new(size_t size, std::align_val_t alignment) {
+    return CountedAllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return CountedAllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size, 0); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept { CountedFree(memory); }
+void operator delete[](void* memory) noexcept { CountedFree(memory); }
+void operator delete(void* memory, size_t) noexcept { CountedFree(memory); }
+void operator delete[](void* memory, size_t) noexcept { CountedFree(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { CountedFree(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { CountedFree(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { CountedFree(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { CountedFree(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { CountedFree(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { CountedFree(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { CountedFree(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { CountedFree(memory); }
+
+struct BenchmarkOptions {
+    uint64_t seed = 2048;
+    size_t boardsPerPhase = 4096;
+    double minSeconds = 0.2;
+    double threshold = 10.0;    // ȱðٷֱΪ˻
+    std::string filter;
+    std::string jsonPath;
+    std::string slotPath = "benchmark-slots.bin";   // λ浵õʱļ
+    std::string baselinePath;
+    std::string weightsPath;    // N ԪֵõȨļΪʱͬСĳȨ
+};
+
+struct BenchmarkResult {
+    std::string name;
+    double nsPerOp;
+    double opsPerSecond;
+    double allocationsPerOp;
+    uint64_t operations;
+};
+
+// 󷽿黮ֶԾֽ׶Σڲ 64 128  512 1024 
+struct BoardPhase {
+    const char* name;
+    int minExponent;
+    int maxExponent;
+    std::vector<Board> boards;
+};
+
+// ǳ󻯲Ծֲ׶β棬õӽʵԾֵķֲ
+static std::vector<BoardPhase> CollectBoards(uint64_t seed, size_t perPhase) {
+    std::vector<BoardPhase> phases = {
+        { "early", 0, 6, {} },
+        { "mid", 7, 9, {} },
+        { "late", 10, MAX_TILE_EXPONENT, {} }
+    };
+
+    ExpectimaxPolicy policy(1);
+    const int maxGames = 1000;
+    for (int game = 0; game < maxGames; game++) {
+        bool full = true;
+        for (const BoardPhase& phase : phases) {
+            full = full && phase.boards.size() >= perPhase;
+        }
+        if (full) break;
+
+        GameEngine engine(SplitMix64(seed ^ SplitMix64(game)));
+        engine.NewGame();
+        policy.NewGame();
+        while (!engine.IsGameOver()) {
+            Board board = engine.GetBoard();
+            int exponent = BitBoard::MaxExponent(board);
+            for (BoardPhase& phase : phases) {
+                if (exponent >= phase.minExponent && exponent <= phase.maxExponent && phase.boards.size() < perPhase) {
+                    phase.boards.push_back(board);
+                }
+            }
+
+            Direction move;
+            if (!policy.ChooseMove(board, engine.GetRandom(), move) || !engine.Move(move)) {
+                break;
+            }
+            engine.AddRandomTile();
+            engine.CheckGameOver();
+        }
+    }
+
+    for (const BoardPhase& phase : phases) {
+        if (phase.boards.empty()) {
+            throw std::runtime_error(std::string("no boards collected for phase ") + phase.name);
+        }
+    }
+    return phases;
+}
+
+// ÿִֶһαظۼʱ䲻 minSeconds
+template <typename Round>
+static BenchmarkResult Measure(const std::string& name, size_t opsPerRound, double minSeconds, Round round) {
+    volatile uint64_t sink = round();
+
+    uint64_t rounds = 0;
+    uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0.0;
+    do {
+        for (int i = 0; i < 16; i++) {
+            sink = sink + round();
+        }
+        rounds += 16;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < minSeconds);
+    uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+    uint64_t operations = rounds * opsPerRound;
+    return { name, seconds * 1e9 / operations, operations / seconds,
+        static_cast<double>(allocations) / operations, operations };
+}
+
+// ̱ƶɷ飺ȡ̰ĲԵԾ֣ÿβĸ
+template <typename Engine>
+static void RunVariantBenchmarks(const BenchmarkOptions& options, const char* label,
+    const std::function<bool(const std::string&)>& selected, std::vector<BenchmarkResult>& results) {
+    using Layout = typename Engine::Layout;
+    using VariantBoardType = typename Engine::BoardType;
+
+    std::string moveName = std::string("variant_move/") + label;
+    std::string spawnName = std::string("variant_spawn/") + label;
+    if (!selected(moveName) && !selected(spawnName)) return;
+
+    std::vector<VariantBoardType> boards;
+    for (uint64_t game = 0; boards.size() < options.boardsPerPhase; game++) {
+        Engine engine(SplitMix64(options.seed ^ SplitMix64(game)));
+        engine.NewGame();
+        Direction move;
+        while (!engine.IsGameOver() && boards.size() < options.boardsPerPhase &&
+            ChooseGreedyMove<Layout>(engine.GetBoard(), move) && engine.Move(move)) {
+            engine.AddRandomTile();
+            engine.CheckGameOver();
+            boards.push_back(engine.GetBoard());
+        }
+    }
+
+    Engine engine(options.seed);
+    if (selected(moveName)) {
+        results.push_back(Measure(moveName, boards.size() * DIRECTION_COUNT, options.minSeconds, [&]() {
+            uint64_t sum = 0;
+            for (const VariantBoardType& board : boards) {
+                for (int d = 0; d < DIRECTION_COUNT; d++) {
+                    typename Layout::MoveResult result = Layout::Move(board, static_cast<Direction>(d));
+                    sum += result.score + result.moved;
+                }
+            }
+            return sum;
+        }));
+    }
+
+    if (selected(spawnName)) {
+        std::vector<VariantBoardType> open;
+        for (const VariantBoardType& board : boards) {
+            if (Layout::CountEmpty(board) > 0) open.push_back(board);
+        }
+        results.push_back(Measure(spawnName, open.size(), options.minSeconds, [&]() {
+            uint64_t sum = 0;
+            for (const VariantBoardType& board : open) {
+                engine.SetState(board, 0, false, false);
+                engine.AddRandomTile();
+                sum += Layout::MaxExponent(engine.GetBoard());
+            }
+            return sum;
+        }));
+    }
+}
+
+static std::vector<BenchmarkResult> RunBenchmarks(const BenchmarkOptions& options, const std::vector<BoardPhase>& phases) {
+    std::vector<BenchmarkResult> results;
+    std::function<bool(const std::string&)> selected = [&](const std::string& name) {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    };
+
+    // 256MB ֻҪʱʼֵдÿһҳôѵȨͬ
+    std::unique_ptr<NTupleNetwork> network;
+    if (selected("ntuple_eval/")) {
+        network = options.weightsPath.empty()
+            ? std::make_unique<NTupleNetwork>(NTupleNetwork::StandardShapes(), 1.0f)
+            : std::make_unique<NTupleNetwork>(options.weightsPath);
+    }
+
+    for (const BoardPhase& phase : phases) {
+        const std::vector<Board>& boards = phase.boards;
+        std::string suffix = std::string("/") + phase.name;
+        GameEngine engine(options.seed);
+
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            static const char* NAMES[DIRECTION_COUNT] = { "move_left", "move_right", "move_up", "move_down" };
+            std::string name = NAMES[d] + suffix;
+            if (!selected(name)) continue;
+
+            Direction direction = static_cast<Direction>(d);
+            results.push_back(Measure(name, boards.size(), options.minSeconds, [&]() {
+                uint64_t sum = 0;
+                for (Board board : boards) {
+                    engine.SetState(board, 0, false, false);
+                    sum += engine.Move(direction) + engine.GetBoard();
+                }
+                return sum;
+            }));
+        }
+
+        if (selected("can_move" + suffix)) {
+            results.push_back(Measure("can_move" + suffix, boards.size(), options.minSeconds, [&]() {
+                uint64_t sum = 0;
+                for (Board board : boards) {
+                    sum += BitBoard::CanMove(board);
+                }
+                return sum;
+            }));
+        }
+
+        if (selected("legal_moves" + suffix)) {
+            results.push_back(Measure("legal_moves" + suffix, boards.size(), options.minSeconds, [&]() {
+                uint64_t sum = 0;
+                for (Board board : boards) {
+                    sum += BitBoard::LegalMoves(board);
+                }
+                return sum;
+            }));
+        }
+
+        if (selected("add_random_tile" + suffix)) {
+            std::vector<Board> open;
+            for (Board board : boards) {
+                if (BitBoard::CountEmpty(board) > 0) open.push_back(board);
+            }
+            results.push_back(Measure("add_random_tile" + suffix, open.size(), options.minSeconds, [&]() {
+                uint64_t sum = 0;
+                for (Board board : open) {
+                    engine.SetState(board, 0, false, false);
+                    engine.AddRandomTile();
+                    sum += engine.GetBoard();
+                }
+                return sum;
+            }));
+        }
+
+        std::vector<GameState> states;
+        for (Board board : boards) {
+            engine.SetState(board, 0, false, false);
+            states.push_back(SaveFormat::CreateSnapshot(engine));
+        }
+
+        if (selected("checksum" + suffix)) {
+            results.push_back(Measure("checksum" + suffix, states.size(), options.minSeconds, [&]() {
+                uint64_t sum = 0;
+                for (const GameState& state : states) {
+                    sum += SaveFormat::CalculateChecksum(state);
+                }
+                return sum;
+            }));
+        }
+
+        if (selected("validate_state" + suffix)) {
+            results.push_back(Measure("validate_state" + suffix, states.size(), options.minSeconds, [&]() {
+                uint64_t sum = 0;
+                for (const GameState& state : states) {
+                    sum += SaveFormat::ValidateGameState(state);
+                }
+                return sum;
+            }));
+        }
+
+        if (selected("save_v2" + suffix)) {
+            results.push_back(Measure("save_v2" + suffix, boards.size(), options.minSeconds, [&]() {
+                uint64_t sum = 0;
+                for (Board board : boards) {
+                    engine.SetState(board, 0, false, false);
+                    sum += SaveFormat::CreatePackedSnapshot(engine).checksum;
+                }
+                return sum;
+            }));
+        }
+
+        if (selected("slot_store" + suffix) || selected("slot_load" + suffix)) {
+            std::remove(options.slotPath.c_str());
+            {
+                SaveSlots slots(options.slotPath, static_cast<uint32_t>(boards.size() * 2));
+                std::vector<PackedGameState> packed;
+                for (Board board : boards) {
+                    engine.SetState(board, 0, false, false);
+                    packed.push_back(SaveFormat::CreatePackedSnapshot(engine));
+                }
+
+                // ȡǰдȫ棬 slot_load ʱͬ
+                BenchmarkResult store = Measure("slot_store" + suffix, packed.size(), options.minSeconds, [&]() {
+                    for (size_t i = 0; i < packed.size(); i++) {
+                        slots.Store(i, packed[i]);
+                    }
+                    return uint64_t(slots.GetCount());
+                });
+                if (selected("slot_store" + suffix)) {
+                    results.push_back(store);
+                }
+
+                if (selected("slot_load" + suffix)) {
+                    results.push_back(Measure("slot_load" + suffix, packed.size(), options.minSeconds, [&]() {
+                        uint64_t sum = 0;
+                        PackedGameState state;
+                        for (size_t i = 0; i < packed.size(); i++) {
+                            sum += slots.Load(i, state) + state.board;
+                        }
+                        return sum;
+                    }));
+                }
+            }
+            std::remove(options.slotPath.c_str());
+        }
+
+        if (selected("batch_move" + suffix)) {
+            std::vector<uint8_t> directions(boards.size());
+            for (size_t i = 0; i < directions.size(); i++) {
+                directions[i] = static_cast<uint8_t>(i % DIRECTION_COUNT);
+            }
+            std::vector<Board> moved(boards.size());
+            std::vector<uint32_t> scores(boards.size());
+            results.push_back(Measure("batch_move" + suffix, boards.size(), options.minSeconds, [&]() {
+                BatchMove::Apply(boards.data(), directions.data(), boards.size(), moved.data(), scores.data(), nullptr);
+                return moved[0] + scores[0];
+            }));
+        }
+
+        if (network && selected("ntuple_eval" + suffix)) {
+            results.push_back(Measure("ntuple_eval" + suffix, boards.size(), options.minSeconds, [&]() {
+                float sum = 0.0f;
+                for (Board board : boards) {
+                    sum += network->Evaluate(board);
+                }
+                return static_cast<uint64_t>(sum);
+            }));
+        }
+
+        // Ҷӽڵľֵ̬8 βе÷ֱͬ
+        if (selected("heuristic_eval" + suffix)) {
+            const Heuristic& heuristic = Heuristic::Active();
+            results.push_back(Measure("heuristic_eval" + suffix, boards.size(), options.minSeconds, [&]() {
+                double sum = 0.0;
+                for (Board board : boards) {
+                    sum += heuristic.Evaluate(board);
+                }
+                return static_cast<uint64_t>(sum);
+            }));
+        }
+
+        if (selected("heuristic_direct" + suffix)) {
+            HeuristicWeights weights;
+            results.push_back(Measure("heuristic_direct" + suffix, boards.size(), options.minSeconds, [&]() {
+                double sum = 0.0;
+                for (Board board : boards) {
+                    sum += Heuristic::EvaluateDirect(board, weights);
+                }
+                return static_cast<uint64_t>(sum);
+            }));
+        }
+
+        // ھͨ󲿷ָӲͬӽ෽ػ
+        if (selected("render_frame" + suffix)) {
+            SoftwareRenderer renderer;
+            renderer.Resize(DEFAULT_FRAME_WIDTH, DEFAULT_FRAME_HEIGHT);
+            results.push_back(Measure("render_frame" + suffix, boards.size(), options.minSeconds, [&]() {
+                uint64_t sum = 0;
+                for (size_t i = 0; i < boards.size(); i++) {
+                    RenderState state = { boards[i], static_cast<int>(i), -1, false, false };
+                    sum += renderer.Render(state).size();
+                }
+                return sum;
+            }));
+        }
+    }
+
+    // һͬʱĻỰһĶԾֹرպؿԼ˳ɨȫԾ
+    if (selected("session_move/1M") || selected("session_scan/1M")) {
+        const size_t SESSIONS = 1000000;
+        SessionStore store;
+        std::vector<SessionStore::Handle> handles(SESSIONS);
+        for (size_t i = 0; i < SESSIONS; i++) {
+            handles[i] = store.Create(SplitMix64(options.seed + i));
+        }
+
+        if (selected("session_move/1M")) {
+            GameRandom random(options.seed);
+            results.push_back(Measure("session_move/1M", SESSIONS, options.minSeconds, [&]() {
+                uint64_t sum = 0;
+                for (size_t n = 0; n < SESSIONS; n++) {
+                    uint64_t value = random.Next();
+                    size_t i = RandomBelow(static_cast<uint32_t>(value >> 32), static_cast<int>(SESSIONS));
+                    bool moved;
+                    const SessionRecord* record = store.Move(handles[i], static_cast<Direction>(value & 3), moved);
+                    if (record->state & SESSION_GAME_OVER) {
+                        store.Close(handles[i]);
+                        handles[i] = store.Create(value);
+                    }
+                    sum += moved;
+                }
+                return sum;
+            }));
+        }
+
+        if (selected("session_scan/1M")) {
+            results.push_back(Measure("session_scan/1M", SESSIONS, options.minSeconds, [&]() {
+                uint64_t sum = 0;
+                store.ForEach([&](SessionStore::Handle, const SessionRecord& record) { sum += record.score; });
+                return sum;
+            }));
+        }
+    }
+
+    // ߳ƽ 4096 ֣Ϸ߷ԶؿͺϷ
+    if (selected("vector_env_step/4096")) {
+        const size_t ENVIRONMENTS = 4096;
+        VectorEnvironment environment(1);
+        std::vector<uint64_t> boards(ENVIRONMENTS);
+        std::vector<float> rewards(ENVIRONMENTS);
+        std::vector<uint8_t> done(ENVIRONMENTS);
+        std::vector<uint8_t> legal(ENVIRONMENTS);
+        std::vector<uint8_t> actions(ENVIRONMENTS * 64);
+        GameRandom random(options.seed);
+        for (uint8_t& action : actions) {
+            action = static_cast<uint8_t>(random.Next() & 3);
+        }
+        environment.Reset(ENVIRONMENTS, nullptr, boards.data(), legal.data());
+
+        size_t round = 0;
+        results.push_back(Measure("vector_env_step/4096", ENVIRONMENTS, options.minSeconds, [&]() {
+            environment.Step(actions.data() + (round++ % 64) * ENVIRONMENTS, boards.data(), rewards.data(), done.data(),
+                legal.data());
+            return boards[0] + done[0] + legal[0];
+        }));
+    }
+
+    RunVariantBenchmarks<GameEngine3x3>(options, "3x3", selected, results);
+    RunVariantBenchmarks<GameEngine5x5>(options, "5x5", selected, results);
+    RunVariantBenchmarks<GameEngine6x6>(options, "6x6", selected, results);
+    return results;
+}
+
+static void WriteJson(const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results) {
+    std::ofstream file(options.jsonPath);
+    if (!file.is_open()) {
+        throw std::runtime_error("cannot write " + options.jsonPath);
+    }
+
+    file << "{\n";
+    file << "  \"seed\": " << options.seed << ",\n";
+    file << "  \"boards_per_phase\": " << options.boardsPerPhase << ",\n";
+    file << "  \"batch_kernel\": \"" << BatchMove::GetKernelName(BatchMove::GetKernel()) << "\",\n";
+    file << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult& result = results[i];
+        char line[256];
+        snprintf(line, sizeof(line),
+            "    {\"name\": \"%s\", \"ns_per_op\": %.4f, \"ops_per_sec\": %.1f, \"allocs_per_op\": %.4f, \"ops\": %llu}%s\n",
+            result.name.c_str(), result.nsPerOp, result.opsPerSecond, result.allocationsPerOp,
+            static_cast<unsigned long long>(result.operations), i + 1 < results.size() ? "," : "");
+        file << line;
+    }
+    file << "  ]\n}\n";
+
+    if (file.fail()) {
+        throw std::runtime_error("failed writing " + options.jsonPath);
+    }
+}
+
+// ֻд JSONȡ name  ns_per_op
+static std::vector<BenchmarkResult> ReadBaseline(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("cannot read baseline " + path);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    std::vector<BenchmarkResult> baseline;
+    const std::string nameKey = "\"name\": \"";
+    const std::string nsKey = "\"ns_per_op\": ";
+    size_t position = 0;
+    while ((position = text.find(nameKey, position)) != std::string::npos) {
+        size_t begin = position + nameKey.size();
+        size_t end = text.find('"', begin);
+        size_t ns = text.find(nsKey, end);
+        if (end == std::string::npos || ns == std::string::npos) {
+            throw std::runtime_error("malformed baseline " + path);
+        }
+        baseline.push_back({ text.substr(begin, end - begin), strtod(text.c_str() + ns + nsKey.size(), nullptr), 0.0, 0.0, 0 });
+        position = ns;
+    }
+    return baseline;
+}
+
+// ӡԻ˻
+static int PrintResults(const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results,
+    const std::vector<BenchmarkResult>& baseline) {
+    int regressions = 0;
+    printf("%-26s %12s %16s %10s", "benchmark", "ns/op", "ops/s", "allocs/op");
+    printf(baseline.empty() ? "\n" : " %12s\n", "vs baseline");
+
+    for (const BenchmarkResult& result : results) {
+        printf("%-26s %12.3f %16.0f %10.3f", result.name.c_str(), result.nsPerOp, result.opsPerSecond, result.allocationsPerOp);
+        for (const BenchmarkResult& base : baseline) {
+            if (base.name != result.name || base.nsPerOp <= 0.0) continue;
+
+            double change = (result.nsPerOp - base.nsPerOp) / base.nsPerOp * 100.0;
+            bool regressed = change > options.threshold;
+            printf(" %+11.1f%%%s", change, regressed ? "  REGRESSION" : "");
+            if (regressed) regressions++;
+            break;
+        }
+        printf("\n");
+    }
+    return regressions;
+}
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr,
+        "usage: %s [--seed N] [--boards N] [--min-time MS] [--filter TEXT]\n"
+        "          [--json FILE] [--baseline FILE] [--threshold PERCENT] [--slot-file FILE]\n"
+        "          [--weights FILE]\n", program);
+}
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        if (strcmp(arg, "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--boards") == 0) options.boardsPerPhase = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--min-time") == 0) options.minSeconds = atof(value) / 1000.0;
+        else if (strcmp(arg, "--filter") == 0) options.filter = value;
+        else if (strcmp(arg, "--json") == 0) options.jsonPath = value;
+        else if (strcmp(arg, "--slot-file") == 0) options.slotPath = value;
+        else if (strcmp(arg, "--baseline") == 0) options.baselinePath = value;
+        else if (strcmp(arg, "--threshold") == 0) options.threshold = atof(value);
+        else if (strcmp(arg, "--weights") == 0) options.weightsPath = value;
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    if (options.boardsPerPhase == 0 || options.minSeconds <= 0.0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        std::vector<BoardPhase> phases = CollectBoards(options.seed, options.boardsPerPhase);
+        printf("boards      : %zu early, %zu mid, %zu late (seed %llu)\n", phases[0].boards.size(),
+            phases[1].boards.size(), phases[2].boards.size(), static_cast<unsigned long long>(options.seed));
+        printf("batch kernel: %s\n\n", BatchMove::GetKernelName(BatchMove::GetKernel()));
+
+        std::vector<BenchmarkResult> results = RunBenchmarks(options, phases);
+        std::vector<BenchmarkResult> baseline;
+        if (!options.baselinePath.empty()) {
+            baseline = ReadBaseline(options.baselinePath);
+        }
+
+        int regressions = PrintResults(options, results, baseline);
+        if (!options.jsonPath.empty()) {
+            WriteJson(options, results);
+        }
+
+        if (regressions > 0) {
+            printf("\n%d benchmark(s) slower than baseline by more than %.1f%%\n", regressions, options.threshold);
+            return 2;
+        }
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "benchmark failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
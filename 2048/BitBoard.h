@@ -0,0 +1,334 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// ̳
+const int BOARD_SIZE = 4;
+const int BOARD_CELLS = BOARD_SIZE * BOARD_SIZE;
+const int MAX_TILE_EXPONENT = 15;   // ÿ 4 λ󷽿Ϊ 32768
+const int WIN_TILE_EXPONENT = 11;   // 2048
+
+// ̣ÿ 4 λ淽ָ0 Ϊո1 Ϊ 22 Ϊ 4 ...
+//  row е col λڵ (row * 4 + col) * 4 λÿռ 16 λ
+typedef uint64_t Board;
+
+enum class Direction : uint8_t {
+    Left = 0,
+    Right = 1,
+    Up = 2,
+    Down = 3
+};
+
+const int DIRECTION_COUNT = 4;
+
+// вұ/ƽϲ÷ּƶ־
+struct RowMove {
+    uint16_t left;
+    uint16_t right;
+    uint32_t info;  // [31:8] ÷  [7:4] ϲָ  [1] Ч  [0] Ч
+};
+
+const uint32_t ROW_MOVED_LEFT = 1u << 0;
+const uint32_t ROW_MOVED_RIGHT = 1u << 1;
+
+constexpr uint16_t ReverseRow(uint16_t row) {
+    return static_cast<uint16_t>((row >> 12) | ((row >> 4) & 0x00F0) | ((row << 4) & 0x0F00) | (row << 12));
+}
+
+// ԭ MoveLeft ͬĹѹٴϲÿһƶֻϲһ
+constexpr uint32_t SlideRowLeft(uint32_t row, uint32_t& info) {
+    uint32_t result = 0;
+    uint32_t shift = 0;
+    uint32_t last = 0;
+
+    for (; row != 0; row >>= 4) {
+        uint32_t tile = row & 0xF;
+        if (tile == 0) continue;
+
+        if (tile == last && tile < MAX_TILE_EXPONENT) {
+            result += 1u << (shift - 4);
+            info += (2u << tile) << 8;
+            if (((info >> 4) & 0xF) <= tile) info = (info & ~0xF0u) | ((tile + 1) << 4);
+            last = 0;
+        }
+        else {
+            result |= tile << shift;
+            shift += 4;
+            last = tile;
+        }
+    }
+
+    return result;
+}
+
+constexpr std::array<RowMove, 65536> BuildRowMoves() {
+    std::array<RowMove, 65536> table = {};
+
+    for (uint32_t row = 0; row < 65536; row++) {
+        uint32_t info = 0;
+        uint32_t left = SlideRowLeft(row, info);
+        if (left != row) info |= ROW_MOVED_LEFT;
+        table[row] = { static_cast<uint16_t>(left), 0, info };
+    }
+
+    // ƵȼڶԷתƣ÷ͬ
+    for (uint32_t row = 0; row < 65536; row++) {
+        uint16_t right = ReverseRow(table[ReverseRow(static_cast<uint16_t>(row))].left);
+        table[row].right = right;
+        if (right != row) table[row].info |= ROW_MOVED_RIGHT;
+    }
+
+    return table;
+}
+
+inline constexpr std::array<RowMove, 65536> ROW_MOVES = BuildRowMoves();
+
+// ÿֻǷЧλ64KB ıܳפ棬Ϸ߷жϲض 512KB ƶ
+constexpr std::array<uint8_t, 65536> BuildRowLegal() {
+    std::array<uint8_t, 65536> table = {};
+    for (uint32_t row = 0; row < 65536; row++) {
+        table[row] = static_cast<uint8_t>(ROW_MOVES[row].info & (ROW_MOVED_LEFT | ROW_MOVED_RIGHT));
+    }
+    return table;
+}
+
+inline constexpr std::array<uint8_t, 65536> ROW_LEGAL = BuildRowLegal();
+
+// Ϸ߷룺 d λʾ d ܸı
+const uint32_t LEGAL_MOVES_NONE = 0;
+const uint32_t LEGAL_MOVES_UNKNOWN = 0xFF;  // ĵʾδ
+
+struct MoveResult {
+    Board board;
+    uint32_t score;
+    uint32_t maxMerged;
+    bool moved;
+};
+
+class BitBoard {
+public:
+    static constexpr uint16_t GetRow(Board board, int row) {
+        return static_cast<uint16_t>(board >> (row * 16));
+    }
+
+    static constexpr int GetExponent(Board board, int row, int col) {
+        return static_cast<int>((board >> ((row * BOARD_SIZE + col) * 4)) & 0xF);
+    }
+
+    static constexpr Board SetExponent(Board board, int row, int col, int exponent) {
+        int shift = (row * BOARD_SIZE + col) * 4;
+        return (board & ~(Board(0xF) << shift)) | (Board(exponent & 0xF) << shift);
+    }
+
+    static constexpr int GetTileValue(Board board, int row, int col) {
+        int exponent = GetExponent(board, row, col);
+        return exponent == 0 ? 0 : (1 << exponent);
+    }
+
+    static constexpr Board Transpose(Board x) {
+        Board a1 = x & 0xF0F00F0FF0F00F0FULL;
+        Board a2 = x & 0x0000F0F00000F0F0ULL;
+        Board a3 = x & 0x0F0F00000F0F0000ULL;
+        Board a = a1 | (a2 << 12) | (a3 >> 12);
+        Board b1 = a & 0xFF00FF0000FF00FFULL;
+        Board b2 = a & 0x00FF00FF00000000ULL;
+        Board b3 = a & 0x00000000FF00FF00ULL;
+        return b1 | (b2 >> 24) | (b3 << 24);
+    }
+
+    // ÿҾ
+    static constexpr Board MirrorRows(Board x) {
+        x = ((x & 0x0F0F0F0F0F0F0F0FULL) << 4) | ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL);
+        return ((x & 0x00FF00FF00FF00FFULL) << 8) | ((x >> 8) & 0x00FF00FF00FF00FFULL);
+    }
+
+    // ·ת˳
+    static constexpr Board FlipRows(Board x) {
+        x = (x << 32) | (x >> 32);
+        return ((x & 0x0000FFFF0000FFFFULL) << 16) | ((x >> 16) & 0x0000FFFF0000FFFFULL);
+    }
+
+    // 8 ת/Գƣbit2 תãbit0 Ҿbit1 ·ת
+    static constexpr Board ApplySymmetry(Board board, int symmetry) {
+        if (symmetry & 4) board = Transpose(board);
+        if (symmetry & 1) board = MirrorRows(board);
+        if (symmetry & 2) board = FlipRows(board);
+        return board;
+    }
+
+    // һȫ 8 Գƾ棬variants[i]  ApplySymmetry(board, i)
+    static constexpr void Symmetries(Board board, Board variants[8]) {
+        variants[0] = board;
+        variants[1] = MirrorRows(board);
+        variants[2] = FlipRows(board);
+        variants[3] = FlipRows(variants[1]);
+        Board transposed = Transpose(board);
+        variants[4] = transposed;
+        variants[5] = MirrorRows(transposed);
+        variants[6] = FlipRows(transposed);
+        variants[7] = FlipRows(variants[5]);
+    }
+
+    // 8 ԳƾֵСһΪ淶ʽsymmetry õı任
+    static constexpr Board Canonical(Board board, int& symmetry) {
+        Board variants[8];
+        Symmetries(board, variants);
+
+        symmetry = 0;
+        for (int i = 1; i < 8; i++) {
+            if (variants[i] < variants[symmetry]) symmetry = i;
+        }
+        return variants[symmetry];
+    }
+
+    static constexpr Board Canonical(Board board) {
+        int symmetry = 0;
+        return Canonical(board, symmetry);
+    }
+
+    // ԭϵķڱ任϶Ӧķinverse Ϊ true ʱӳ
+    static constexpr Direction MapDirection(Direction direction, int symmetry, bool inverse = false) {
+        int d = static_cast<int>(direction);
+        if (!inverse && (symmetry & 4)) d ^= 2;
+        if (symmetry & 1) d = d < 2 ? d ^ 1 : d;
+        if (symmetry & 2) d = d >= 2 ? d ^ 1 : d;
+        if (inverse && (symmetry & 4)) d ^= 2;
+        return static_cast<Direction>(d);
+    }
+
+    // һе 4 չΪ 0 
+    static constexpr Board UnpackColumn(uint16_t row) {
+        Board x = row;
+        return (x | (x << 12) | (x << 24) | (x << 36)) & 0x000F000F000F000FULL;
+    }
+
+    // ո룺 i Ϊʱ 4 * i λ 1
+    static constexpr Board EmptyMask(Board x) {
+        x |= (x >> 2) & 0x3333333333333333ULL;
+        x |= (x >> 1);
+        return ~x & 0x1111111111111111ULL;
+    }
+
+    static constexpr int CountEmpty(Board x) {
+        return std::popcount(EmptyMask(x));
+    }
+
+    //  mask е index λ 0 ʼλ
+    static int SelectBit(uint64_t mask, int index) {
+#if defined(__BMI2__)
+        return std::countr_zero(_pdep_u64(uint64_t(1) << index, mask));
+#else
+        for (int i = 0; i < index; i++) {
+            mask &= mask - 1;
+        }
+        return std::countr_zero(mask);
+#endif
+    }
+
+    static constexpr int MaxExponent(Board board) {
+        int maxExponent = 0;
+        for (int i = 0; i < BOARD_CELLS; i++) {
+            int exponent = static_cast<int>((board >> (i * 4)) & 0xF);
+            if (exponent > maxExponent) maxExponent = exponent;
+        }
+        return maxExponent;
+    }
+
+    static MoveResult Move(Board board, Direction direction) {
+        MoveResult result = { 0, 0, 0, false };
+        uint32_t flags = 0;
+
+        switch (direction) {
+        case Direction::Left:
+        case Direction::Right:
+        {
+            bool right = direction == Direction::Right;
+            for (int row = 0; row < BOARD_SIZE; row++) {
+                const RowMove& entry = ROW_MOVES[GetRow(board, row)];
+                result.board |= Board(right ? entry.right : entry.left) << (row * 16);
+                AccumulateInfo(result, flags, entry.info);
+            }
+            flags &= right ? ROW_MOVED_RIGHT : ROW_MOVED_LEFT;
+        }
+        break;
+
+        case Direction::Up:
+        case Direction::Down:
+        {
+            bool down = direction == Direction::Down;
+            Board transposed = Transpose(board);
+            for (int col = 0; col < BOARD_SIZE; col++) {
+                const RowMove& entry = ROW_MOVES[GetRow(transposed, col)];
+                result.board |= UnpackColumn(down ? entry.right : entry.left) << (col * 4);
+                AccumulateInfo(result, flags, entry.info);
+            }
+            flags &= down ? ROW_MOVED_RIGHT : ROW_MOVED_LEFT;
+        }
+        break;
+        }
+
+        result.moved = flags != 0;
+        return result;
+    }
+
+    // бλ LeftRightתúÿмһУҶӦ UpDown
+    static uint32_t LegalMoves(Board board) {
+        Board transposed = Transpose(board);
+        uint32_t rows = 0;
+        uint32_t columns = 0;
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            rows |= ROW_LEGAL[GetRow(board, i)];
+            columns |= ROW_LEGAL[GetRow(transposed, i)];
+        }
+        return rows | (columns << 2);
+    }
+
+    // ֻжǷںϷ߷ʱǰأһоȷ
+    static bool CanMove(Board board) {
+        Board transposed = Transpose(board);
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            if (ROW_LEGAL[GetRow(board, i)] | ROW_LEGAL[GetRow(transposed, i)]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static Board FromGrid(const int grid[BOARD_SIZE][BOARD_SIZE]) {
+        Board board = 0;
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            for (int j = 0; j < BOARD_SIZE; j++) {
+                int value = grid[i][j];
+                if (value == 0) continue;
+                if (value < 0 || (value & (value - 1)) != 0 || value > (1 << MAX_TILE_EXPONENT)) {
+                    throw std::runtime_error("Tile value cannot be packed");
+                }
+                board = SetExponent(board, i, j, std::countr_zero(static_cast<unsigned>(value)));
+            }
+        }
+        return board;
+    }
+
+    static void ToGrid(Board board, int grid[BOARD_SIZE][BOARD_SIZE]) {
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            for (int j = 0; j < BOARD_SIZE; j++) {
+                grid[i][j] = GetTileValue(board, i, j);
+            }
+        }
+    }
+
+private:
+    static void AccumulateInfo(MoveResult& result, uint32_t& flags, uint32_t info) {
+        result.score += info >> 8;
+        uint32_t merged = (info >> 4) & 0xF;
+        if (merged > result.maxMerged) result.maxMerged = merged;
+        flags |= info;
+    }
+};
@@ -0,0 +1,318 @@
+#pragma once
+
+#include "BitBoard.h"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// Ĵ̣ÿΪ 4 λָзͬһ 64 λУ֣
+// 3x3  4x4 ռһ֣5x5 ռ֣128 λ6x6 ռ֡
+// ģƶѭĴڱȷȫչ4x4 ػתʵ
+template <int Rows, int Columns>
+class VariantBoard {
+public:
+    static_assert(Rows >= 2 && Rows <= 8 && Columns >= 2 && Columns <= 8, "unsupported board size");
+
+    static constexpr int ROWS = Rows;
+    static constexpr int COLUMNS = Columns;
+    static constexpr int CELLS = Rows * Columns;
+    static constexpr int ROW_BITS = Columns * 4;
+    static constexpr int ROWS_PER_WORD = 64 / ROW_BITS;
+    static constexpr int WORDS = (Rows + ROWS_PER_WORD - 1) / ROWS_PER_WORD;
+
+    using Board = std::conditional_t<WORDS == 1, uint64_t, std::array<uint64_t, WORDS>>;
+    using EmptyCells = std::array<uint64_t, WORDS>;     // ÿֵĿո룬 i Ϊʱ 4 * i λ 1
+
+    struct MoveResult {
+        Board board;
+        uint32_t score;
+        uint32_t maxMerged;
+        bool moved;
+    };
+
+    static constexpr int GetExponent(const Board& board, int row, int col) {
+        return static_cast<int>((Word(board, row / ROWS_PER_WORD) >> CellShift(row, col)) & 0xF);
+    }
+
+    static constexpr Board SetExponent(Board board, int row, int col, int exponent) {
+        uint64_t& word = Word(board, row / ROWS_PER_WORD);
+        int shift = CellShift(row, col);
+        word = (word & ~(uint64_t(0xF) << shift)) | (uint64_t(exponent & 0xF) << shift);
+        return board;
+    }
+
+    static MoveResult Move(const Board& board, Direction direction) {
+        switch (direction) {
+        case Direction::Left: return MoveTowards<Direction::Left>(board);
+        case Direction::Right: return MoveTowards<Direction::Right>(board);
+        case Direction::Up: return MoveTowards<Direction::Up>(board);
+        default: return MoveTowards<Direction::Down>(board);
+        }
+    }
+
+    // ڵһԸӣһΪնһգͬһܺϲ
+    static bool CanMove(const Board& board) {
+        uint8_t cells[Rows][Columns];
+        Unpack(board, cells);
+        for (int row = 0; row < Rows; row++) {
+            for (int col = 0; col < Columns; col++) {
+                uint8_t tile = cells[row][col];
+                if (col + 1 < Columns && CanCombine(tile, cells[row][col + 1])) return true;
+                if (row + 1 < Rows && CanCombine(tile, cells[row + 1][col])) return true;
+            }
+        }
+        return false;
+    }
+
+    // ĳЧҽ÷ϴڵһԸӣǰһΪնһ񲻿գܺϲ
+    static uint32_t LegalMoves(const Board& board) {
+        uint8_t cells[Rows][Columns];
+        Unpack(board, cells);
+        uint32_t mask = 0;
+        for (int row = 0; row < Rows; row++) {
+            for (int col = 0; col < Columns; col++) {
+                uint8_t tile = cells[row][col];
+                if (col + 1 < Columns) mask |= PairMoves(tile, cells[row][col + 1]);
+                if (row + 1 < Rows) mask |= PairMoves(tile, cells[row + 1][col]) << 2;
+            }
+        }
+        return mask;
+    }
+
+    static EmptyCells FindEmpty(const Board& board) {
+        EmptyCells empty;
+        for (int w = 0; w < WORDS; w++) {
+            empty[w] = EmptyMask(Word(board, w), w);
+        }
+        return empty;
+    }
+
+    static int CountCells(const EmptyCells& cells) {
+        int count = 0;
+        for (int w = 0; w < WORDS; w++) {
+            count += std::popcount(cells[w]);
+        }
+        return count;
+    }
+
+    static int CountEmpty(const Board& board) {
+        return CountCells(FindEmpty(board));
+    }
+
+    //  empty е index ո exponent
+    static void PlaceTile(Board& board, const EmptyCells& empty, int index, int exponent) {
+        for (int w = 0; w < WORDS; w++) {
+            int inWord = std::popcount(empty[w]);
+            if (index < inWord) {
+                Word(board, w) |= uint64_t(exponent) << BitBoard::SelectBit(empty[w], index);
+                return;
+            }
+            index -= inWord;
+        }
+    }
+
+    static int MaxExponent(const Board& board) {
+        int maxExponent = 0;
+        for (int row = 0; row < Rows; row++) {
+            for (int col = 0; col < Columns; col++) {
+                int exponent = GetExponent(board, row, col);
+                if (exponent > maxExponent) maxExponent = exponent;
+            }
+        }
+        return maxExponent;
+    }
+
+private:
+    static constexpr int CellShift(int row, int col) {
+        return (row % ROWS_PER_WORD) * ROW_BITS + col * 4;
+    }
+
+    static constexpr uint64_t& Word(Board& board, int w) {
+        if constexpr (WORDS == 1) {
+            (void)w;
+            return board;
+        }
+        else {
+            return board[w];
+        }
+    }
+
+    static constexpr uint64_t Word(const Board& board, int w) {
+        if constexpr (WORDS == 1) {
+            (void)w;
+            return board;
+        }
+        else {
+            return board[w];
+        }
+    }
+
+    //  w ʵʹõĸӵλ
+    static constexpr uint64_t UsedCells(int w) {
+        int rows = Rows - w * ROWS_PER_WORD;
+        if (rows > ROWS_PER_WORD) rows = ROWS_PER_WORD;
+        int bits = rows * ROW_BITS;
+        uint64_t used = bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+        return used & 0x1111111111111111ULL;
+    }
+
+    static constexpr uint64_t EmptyMask(uint64_t x, int w) {
+        x |= (x >> 2) & 0x3333333333333333ULL;
+        x |= (x >> 1);
+        return ~x & UsedCells(w);
+    }
+
+    static constexpr bool CanCombine(uint8_t a, uint8_t b) {
+        return (a == 0) != (b == 0) || (a == b && a != 0 && a < MAX_TILE_EXPONENT);
+    }
+
+    //  firstsecondле򣩣bit0 ʾ㷽ƶbit1 ʾյ㷽ƶ
+    static constexpr uint32_t PairMoves(uint8_t first, uint8_t second) {
+        if (first == second) return first != 0 && first < MAX_TILE_EXPONENT ? 3u : 0u;
+        return (first == 0 ? 1u : 0u) | (second == 0 ? 2u : 0u);
+    }
+
+    static void Unpack(const Board& board, uint8_t (&cells)[Rows][Columns]) {
+        for (int row = 0; row < Rows; row++) {
+            uint64_t bits = Word(board, row / ROWS_PER_WORD) >> ((row % ROWS_PER_WORD) * ROW_BITS);
+            for (int col = 0; col < Columns; col++) {
+                cells[row][col] = static_cast<uint8_t>((bits >> (col * 4)) & 0xF);
+            }
+        }
+    }
+
+    // Աڳ 0..Count-1 ε fѭе±λΪ
+    template <int Count, typename F>
+    static constexpr void Unroll(F&& f) {
+        [&]<int... I>(std::integer_sequence<int, I...>) {
+            (f(std::integral_constant<int, I>()), ...);
+        }(std::make_integer_sequence<int, Count>());
+    }
+
+    // ģÿ߰Ϊյ 4 λһͬ˳д
+    template <Direction D>
+    static MoveResult MoveTowards(const Board& board) {
+        constexpr bool VERTICAL = D == Direction::Up || D == Direction::Down;
+        constexpr bool REVERSE = D == Direction::Right || D == Direction::Down;
+        constexpr int LINES = VERTICAL ? Columns : Rows;
+        constexpr int LENGTH = VERTICAL ? Rows : Columns;
+
+        MoveResult result = { Board(), 0, 0, false };
+        Unroll<LINES>([&](auto line) {
+            uint32_t cells = 0;
+            Unroll<LENGTH>([&](auto i) {
+                constexpr int K = REVERSE ? LENGTH - 1 - i : i;
+                constexpr int ROW = VERTICAL ? K : line;
+                constexpr int COL = VERTICAL ? line : K;
+                cells |= static_cast<uint32_t>(GetExponent(board, ROW, COL)) << (i * 4);
+            });
+
+            uint32_t info = 0;
+            uint32_t slid = SlideLine<LENGTH>(cells, info);
+            result.score += info >> 8;
+            uint32_t merged = (info >> 4) & 0xF;
+            if (merged > result.maxMerged) result.maxMerged = merged;
+
+            Unroll<LENGTH>([&](auto i) {
+                constexpr int K = REVERSE ? LENGTH - 1 - i : i;
+                constexpr int ROW = VERTICAL ? K : line;
+                constexpr int COL = VERTICAL ? line : K;
+                Word(result.board, ROW / ROWS_PER_WORD) |= uint64_t((slid >> (i * 4)) & 0xF) << CellShift(ROW, COL);
+            });
+        });
+
+        result.moved = result.board != board;
+        return result;
+    }
+
+    //  4 ֱӲ BitBoard бλոӰƽ߲̫
+    //  SlideRowLeft ĹÿһдѡǷ֧µķ֧Ԥʧܡ
+    // info ĸʽ RowMove::info ͬ
+    template <int Length>
+    static uint32_t SlideLine(uint32_t cells, uint32_t& info) {
+        if constexpr (Length <= BOARD_SIZE) {
+            const RowMove& entry = ROW_MOVES[cells];
+            info = entry.info;
+            return entry.left;
+        }
+        else {
+            uint32_t result = 0;
+            uint32_t shift = 0;     // һдλ
+            uint32_t last = 0;      // һдδϲķ飬0 ʾû
+            uint32_t score = 0;
+            uint32_t maxMerged = 0;
+            Unroll<Length>([&](auto i) {
+                uint32_t tile = (cells >> (i * 4)) & 0xF;
+                uint32_t merge = tile != 0 && tile == last && tile < MAX_TILE_EXPONENT;
+                uint32_t place = tile != 0 && !merge;
+
+                result += merge << ((shift - 4) & 31);
+                result |= (tile & (0u - place)) << shift;
+                score += (2u << tile) & (0u - merge);
+                uint32_t mergedExponent = (tile + 1) & (0u - merge);
+                maxMerged = mergedExponent > maxMerged ? mergedExponent : maxMerged;
+                last = (tile & (0u - place)) | (last & (0u - (tile == 0)));
+                shift += place * 4;
+            });
+            info = (score << 8) | (maxMerged << 4);
+            return result;
+        }
+    }
+};
+
+// ׼ 4x4 ֱʹ BitBoard вұɵĴԭȫͬ
+template <>
+class VariantBoard<4, 4> {
+public:
+    static constexpr int ROWS = 4;
+    static constexpr int COLUMNS = 4;
+    static constexpr int CELLS = 16;
+    static constexpr int WORDS = 1;
+
+    using Board = ::Board;
+    using MoveResult = ::MoveResult;
+    using EmptyCells = ::Board;
+
+    static constexpr int GetExponent(Board board, int row, int col) {
+        return BitBoard::GetExponent(board, row, col);
+    }
+
+    static constexpr Board SetExponent(Board board, int row, int col, int exponent) {
+        return BitBoard::SetExponent(board, row, col, exponent);
+    }
+
+    static MoveResult Move(Board board, Direction direction) {
+        return BitBoard::Move(board, direction);
+    }
+
+    static bool CanMove(Board board) {
+        return BitBoard::CanMove(board);
+    }
+
+    static uint32_t LegalMoves(Board board) {
+        return BitBoard::LegalMoves(board);
+    }
+
+    static EmptyCells FindEmpty(Board board) {
+        return BitBoard::EmptyMask(board);
+    }
+
+    static int CountCells(EmptyCells cells) {
+        return std::popcount(cells);
+    }
+
+    static int CountEmpty(Board board) {
+        return BitBoard::CountEmpty(board);
+    }
+
+    static void PlaceTile(Board& board, EmptyCells empty, int index, int exponent) {
+        board |= Board(exponent) << BitBoard::SelectBit(empty, index);
+    }
+
+    static int MaxExponent(Board board) {
+        return BitBoard::MaxExponent(board);
+    }
+};
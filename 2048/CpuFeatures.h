@@ -0,0 +1,50 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_FEATURES_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#endif
+
+// ʱ CPU ָSIMD Ӳ CRC ·ݴѡʵֻ֣״εʱִ CPUID
+class CpuFeatures {
+public:
+    bool sse41 = false;
+    bool sse42 = false;
+    bool avx2 = false;
+    bool bmi2 = false;
+
+    static const CpuFeatures& Get() {
+        static const CpuFeatures features = Detect();
+        return features;
+    }
+
+private:
+    static CpuFeatures Detect() {
+        CpuFeatures features;
+#if defined(CPU_FEATURES_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4] = {};
+        __cpuid(info, 1);
+        features.sse41 = (info[2] & (1 << 19)) != 0;
+        features.sse42 = (info[2] & (1 << 20)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+            __cpuidex(info, 7, 0);
+            features.avx2 = (info[1] & (1 << 5)) != 0;
+            features.bmi2 = (info[1] & (1 << 8)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        features.sse41 = __builtin_cpu_supports("sse4.1");
+        features.sse42 = __builtin_cpu_supports("sse4.2");
+        features.avx2 = __builtin_cpu_supports("avx2");
+        features.bmi2 = __builtin_cpu_supports("bmi2");
+#endif
+#endif
+        return features;
+    }
+};
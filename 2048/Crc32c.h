@@ -0,0 +1,111 @@
+#pragma once
+
+#include "CpuFeatures.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(CPU_FEATURES_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CRC32C_TARGET_SSE42 __attribute__((target("sse4.2")))
+#else
+#define CRC32C_TARGET_SSE42
+#endif
+
+const uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+typedef std::array<std::array<uint32_t, 256>, 8> Crc32cTables;
+
+// tables[k][b] Ϊֽ b ֮پ k ֽڵ slicing-by-8 ÿδ 8 ֽ
+constexpr Crc32cTables BuildCrc32cTables() {
+    Crc32cTables tables = {};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLYNOMIAL : 0);
+        }
+        tables[0][i] = crc;
+    }
+    for (int k = 1; k < 8; k++) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t previous = tables[k - 1][i];
+            tables[k][i] = (previous >> 8) ^ tables[0][previous & 0xFF];
+        }
+    }
+    return tables;
+}
+
+inline constexpr Crc32cTables CRC32C_TABLES = BuildCrc32cTables();
+
+// CRC32CCastagnoliʽ 0x82F63B78֧ SSE4.2 ʱʹ crc32 ָ slicing-by-8 
+// ߽һ¡crc ΪһεĽɷֶμ
+class Crc32c {
+public:
+    static uint32_t Compute(const void* data, size_t size, uint32_t crc = 0) {
+#if defined(CPU_FEATURES_X86)
+        if (CpuFeatures::Get().sse42) {
+            return ComputeHardware(data, size, crc);
+        }
+#endif
+        return ComputeSoftware(data, size, crc);
+    }
+
+    static bool HasHardware() {
+        return CpuFeatures::Get().sse42;
+    }
+
+    static uint32_t ComputeSoftware(const void* data, size_t size, uint32_t crc = 0) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        crc = ~crc;
+
+        while (size >= 8) {
+            uint32_t low = 0;
+            uint32_t high = 0;
+            memcpy(&low, bytes, 4);
+            memcpy(&high, bytes + 4, 4);
+            low ^= crc;
+            crc = CRC32C_TABLES[7][low & 0xFF] ^ CRC32C_TABLES[6][(low >> 8) & 0xFF] ^
+                CRC32C_TABLES[5][(low >> 16) & 0xFF] ^ CRC32C_TABLES[4][low >> 24] ^
+                CRC32C_TABLES[3][high & 0xFF] ^ CRC32C_TABLES[2][(high >> 8) & 0xFF] ^
+                CRC32C_TABLES[1][(high >> 16) & 0xFF] ^ CRC32C_TABLES[0][high >> 24];
+            bytes += 8;
+            size -= 8;
+        }
+
+        while (size-- > 0) {
+            crc = (crc >> 8) ^ CRC32C_TABLES[0][(crc ^ *bytes++) & 0xFF];
+        }
+        return ~crc;
+    }
+
+#if defined(CPU_FEATURES_X86)
+    CRC32C_TARGET_SSE42 static uint32_t ComputeHardware(const void* data, size_t size, uint32_t crc = 0) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        crc = ~crc;
+
+#if defined(__x86_64__) || defined(_M_X64)
+        uint64_t wide = crc;
+        while (size >= 8) {
+            uint64_t word = 0;
+            memcpy(&word, bytes, 8);
+            wide = _mm_crc32_u64(wide, word);
+            bytes += 8;
+            size -= 8;
+        }
+        crc = static_cast<uint32_t>(wide);
+#endif
+        while (size >= 4) {
+            uint32_t word = 0;
+            memcpy(&word, bytes, 4);
+            crc = _mm_crc32_u32(crc, word);
+            bytes += 4;
+            size -= 4;
+        }
+        while (size-- > 0) {
+            crc = _mm_crc32_u8(crc, *bytes++);
+        }
+        return ~crc;
+    }
+#endif
+};
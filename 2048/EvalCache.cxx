@@ -0,0 +1,192 @@
+// ־ûֵ湤ߣLinuxinfo ͳƻļռáֲ
+// stress ͬʱ̶ͬһļдÿжĶĳдĽ
+// 룺g++ -std=c++20 -O2 -DNDEBUG -pthread EvalCache.cxx -o evalcache
+
+#include "EvaluationCache.h"
+#include "Expectimax.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+struct EvalCacheOptions {
+    size_t megabytes = 64;
+    int processes = 4;
+    double seconds = 2.0;
+    uint64_t keys = 1 << 20;    // stressȡֵΧСʱУʱ̭
+    uint64_t seed = 2048;
+    std::string heuristicPath;  // ԶȨдʱͬȨ
+};
+
+static int PrintInfo(const std::string& path) {
+    if (!std::ifstream(path).is_open()) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    EvaluationCache cache(path, 0, ExpectimaxSearch::EvaluatorId());
+    uint64_t used = 0;
+    uint64_t depths[9] = {};
+    uint64_t ages[4] = {};      // доĴ򿪴012C910 
+    cache.ForEach([&](uint64_t, const EvaluationCache::Entry& entry) {
+        used++;
+        depths[(std::min)(entry.depth, 8)]++;
+        uint16_t age = static_cast<uint16_t>(cache.GetEpoch() - 1 - entry.epoch);   // 㱾 info Ĵ
+        ages[age == 0 ? 0 : age == 1 ? 1 : age < 10 ? 2 : 3]++;
+    });
+
+    printf("file        : %zu bytes, %zu entries, %llu used (%.1f%%)\n", cache.GetSizeBytes(), cache.GetCapacity(),
+        static_cast<unsigned long long>(used), 100.0 * used / cache.GetCapacity());
+    printf("opened      : %u times\n", static_cast<unsigned>(cache.GetEpoch()));
+    printf("depth       :");
+    for (int i = 1; i <= 8; i++) {
+        if (depths[i]) printf(" %d:%llu", i, static_cast<unsigned long long>(depths[i]));
+    }
+    printf("\nlast used   : %llu by the latest open, %llu one open before, %llu 2-9 opens before, %llu older\n",
+        static_cast<unsigned long long>(ages[0]), static_cast<unsigned long long>(ages[1]),
+        static_cast<unsigned long long>(ages[2]), static_cast<unsigned long long>(ages[3]));
+    return 0;
+}
+
+// ֵȶɹ淶ʱԺ˶ԣдĶԳʽ˳鷽ӳ
+static void ExpectedFor(Board canonical, double& value, Direction& move, int& depth) {
+    uint64_t hash = SplitMix64(canonical);
+    value = static_cast<float>(hash >> 40);
+    move = static_cast<Direction>(hash & 3);
+    depth = 1 + static_cast<int>((hash >> 2) & 3);
+}
+
+static Board RandomBoard(GameRandom& random, uint64_t keys) {
+    uint64_t index = random.Next() % keys;
+    Board board = 0;
+    for (int cell = 0; cell < BOARD_CELLS; cell++) {
+        board |= Board(SplitMix64(index + static_cast<uint64_t>(cell)) % 12) << (cell * 4);
+    }
+    return board;
+}
+
+static int RunStress(const std::string& path, const EvalCacheOptions& options) {
+    std::remove(path.c_str());
+    std::vector<int> pipes;
+    for (int child = 0; child < options.processes; child++) {
+        int fds[2];
+        if (pipe(fds) != 0) throw std::runtime_error("pipe failed");
+        pid_t pid = fork();
+        if (pid < 0) throw std::runtime_error("fork failed");
+        if (pid == 0) {
+            close(fds[0]);
+            uint64_t counts[4] = {};    // ѯСд롢һ
+            try {
+                EvaluationCache cache(path, options.megabytes, ExpectimaxSearch::EvaluatorId());
+                GameRandom random(SplitMix64(options.seed + static_cast<uint64_t>(child)));
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(options.seconds);
+                while (std::chrono::steady_clock::now() < deadline) {
+                    for (int i = 0; i < 1000; i++) {
+                        Board board = RandomBoard(random, options.keys);
+                        int symmetry = 0;
+                        Board canonical = BitBoard::Canonical(board, symmetry);
+                        double expectedValue;
+                        Direction expectedMove;
+                        int depth;
+                        ExpectedFor(canonical, expectedValue, expectedMove, depth);
+
+                        double value;
+                        Direction move;
+                        counts[0]++;
+                        if (cache.Probe(board, 0, value, move)) {
+                            counts[1]++;
+                            if (value != expectedValue || BitBoard::MapDirection(move, symmetry) != expectedMove) counts[3]++;
+                        }
+                        else {
+                            cache.Store(board, depth, expectedValue, BitBoard::MapDirection(expectedMove, symmetry, true));
+                            counts[2]++;
+                        }
+                    }
+                }
+            }
+            catch (const std::exception& e) {
+                fprintf(stderr, "child %d: %s\n", child, e.what());
+                counts[3] = UINT64_MAX;
+            }
+            ssize_t written = write(fds[1], counts, sizeof(counts));
+            _exit(written == sizeof(counts) ? 0 : 1);
+        }
+        close(fds[1]);
+        pipes.push_back(fds[0]);
+    }
+
+    uint64_t totals[4] = {};
+    bool failed = false;
+    for (int fd : pipes) {
+        uint64_t counts[4] = {};
+        if (read(fd, counts, sizeof(counts)) != sizeof(counts) || counts[3] == UINT64_MAX) failed = true;
+        else for (int i = 0; i < 4; i++) totals[i] += counts[i];
+        close(fd);
+    }
+    while (wait(nullptr) > 0) {
+    }
+
+    printf("processes   : %d for %.1f s on %s (%zu MB), %llu distinct positions\n", options.processes, options.seconds,
+        path.c_str(), options.megabytes, static_cast<unsigned long long>(options.keys));
+    printf("probes      : %llu, %.1f%% hits, %llu stores\n", static_cast<unsigned long long>(totals[0]),
+        totals[0] ? 100.0 * totals[1] / totals[0] : 0.0, static_cast<unsigned long long>(totals[2]));
+    printf("throughput  : %.1f M operations/s\n", totals[0] / options.seconds / 1e6);
+    printf("mismatches  : %llu%s\n", static_cast<unsigned long long>(totals[3]), failed ? " (a child failed)" : "");
+    return failed || totals[3] ? 2 : 0;
+}
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "usage: %s info FILE [--heuristic FILE]\n", program);
+    fprintf(stderr, "       %s stress FILE [--processes N] [--seconds X] [--keys N] [--mb N] [--seed N]\n", program);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::string command = argv[1];
+    EvalCacheOptions options;
+    for (int i = 3; i < argc; i += 2) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        if (strcmp(arg, "--processes") == 0) options.processes = atoi(value);
+        else if (strcmp(arg, "--seconds") == 0) options.seconds = atof(value);
+        else if (strcmp(arg, "--keys") == 0) options.keys = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--mb") == 0) options.megabytes = static_cast<size_t>(strtoull(value, nullptr, 10));
+        else if (strcmp(arg, "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--heuristic") == 0) options.heuristicPath = value;
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.processes <= 0 || options.seconds <= 0.0 || options.keys == 0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        Heuristic::LoadActive(options.heuristicPath);
+        if (command == "info") return PrintInfo(argv[2]);
+        if (command == "stress") return RunStress(argv[2], options);
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "evalcache failed: %s\n", e.what());
+        return 1;
+    }
+
+    PrintUsage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+#include "BitBoard.h"
+#include "Crc32c.h"
+#include "MappedFile.h"
+#include "Random.h"
+
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// ־ûľֵ棺Թ淶ΪõĹֵѷȣ
+// ļԹдʽӳ䣬̣ԼڵĶ̣߳ͬʱдͬһļ
+// ûͬÿͰ 4 ռһУÿ key ^ data  data  64 λ֣
+// ߲һ£һд˺ѣ͵δСļСڴʱ̶ԺͰ̭
+const char EVALCACHE_FILE_HEADER[8] = { '2', '0', '4', '8', 'E', 'V', 'A', 'L' };
+const uint32_t EVALCACHE_FILE_VERSION = 1;
+
+#pragma pack(push, 1)
+struct EvalCacheFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t bucketBits;    // ͰΪ 1 << bucketBits
+    uint64_t evaluator;     // ֵıʶ˹ֵĽ̲ܹþɽ
+    uint32_t reserved[8];
+    uint32_t checksum;      // CRC32Cǰֶ
+    uint32_t epoch;         // ÿ̴ʱԭӼһ̭ʱ䣻У鷶Χ
+};
+
+struct EvalCacheBucket {
+    uint64_t check[4];
+    uint64_t data[4];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(EvalCacheFileHeader) == 64 && sizeof(EvalCacheBucket) == 64, "evaluation cache layout changed");
+static_assert(std::atomic_ref<uint64_t>::is_always_lock_free && std::atomic_ref<uint32_t>::is_always_lock_free,
+    "evaluation cache needs lock-free 64-bit atomics");
+
+struct EvalCacheStats {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    uint64_t stores = 0;
+
+    double HitRate() const {
+        return probes ? static_cast<double>(hits) / probes : 0.0;
+    }
+};
+
+class EvaluationCache {
+public:
+    static const int BUCKET_ENTRIES = 4;
+    static const uint32_t MIN_BUCKET_BITS = 4;
+    static const uint32_t MAX_BUCKET_BITS = 32;
+
+    struct Entry {
+        float value;
+        int depth;
+        Direction move;     // 淶ϵķ
+        uint16_t epoch;
+    };
+
+private:
+    // data ֣[31:0] ֵfloat  [39:32]   [42:40] ѷ + 1  [43] Чλ  [63:48] дʱ epoch
+    static const uint64_t VALID_BIT = uint64_t(1) << 43;
+
+    MappedFile file;
+    EvalCacheBucket* buckets;
+    uint32_t bucketBits;
+    uint16_t epoch;
+    std::atomic<uint64_t> probes;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> stores;
+
+public:
+    // ļʱ megabytesȡ 2 ݸͰѴʱļԼĴС
+    explicit EvaluationCache(const std::string& path, size_t megabytes = 64, uint64_t evaluator = 0)
+        : file(CreateIfMissing(path, megabytes, evaluator), MappedFile::Access::Shared), buckets(nullptr), bucketBits(0),
+        epoch(0), probes(0), hits(0), stores(0) {
+        EvalCacheFileHeader header;
+        if (file.GetSize() < sizeof(header)) {
+            throw std::runtime_error("not an evaluation cache: " + path);
+        }
+        memcpy(&header, file.GetData(), sizeof(header));
+        if (memcmp(header.magic, EVALCACHE_FILE_HEADER, sizeof(header.magic)) != 0 ||
+            header.checksum != Crc32c::Compute(&header, offsetof(EvalCacheFileHeader, checksum))) {
+            throw std::runtime_error("not an evaluation cache: " + path);
+        }
+        if (header.version != EVALCACHE_FILE_VERSION || header.bucketBits < MIN_BUCKET_BITS ||
+            header.bucketBits > MAX_BUCKET_BITS ||
+            file.GetSize() != sizeof(header) + (static_cast<size_t>(1) << header.bucketBits) * sizeof(EvalCacheBucket)) {
+            throw std::runtime_error("unsupported or truncated evaluation cache: " + path);
+        }
+        if (header.evaluator != evaluator) {
+            throw std::runtime_error("evaluation cache " + path + " was built with a different evaluator");
+        }
+
+        uint8_t* data = file.GetMutableData();
+        EvalCacheFileHeader* shared = reinterpret_cast<EvalCacheFileHeader*>(data);
+        epoch = static_cast<uint16_t>(std::atomic_ref<uint32_t>(shared->epoch).fetch_add(1, std::memory_order_relaxed) + 1);
+        buckets = reinterpret_cast<EvalCacheBucket*>(data + sizeof(EvalCacheFileHeader));
+        bucketBits = header.bucketBits;
+    }
+
+    EvaluationCache(const EvaluationCache&) = delete;
+    EvaluationCache& operator=(const EvaluationCache&) = delete;
+
+    size_t GetCapacity() const { return (static_cast<size_t>(1) << bucketBits) * BUCKET_ENTRIES; }
+    size_t GetSizeBytes() const { return file.GetSize(); }
+    uint16_t GetEpoch() const { return epoch; }
+
+    // ֻȲС minDepth Ľо epoch ʱ˳ĳɱε epochþ治ᱻ̭
+    bool Probe(Board board, int minDepth, double& value, Direction& move) {
+        probes.fetch_add(1, std::memory_order_relaxed);
+        int symmetry = 0;
+        Board key = BitBoard::Canonical(board, symmetry);
+        EvalCacheBucket& bucket = GetBucket(key);
+        for (int i = 0; i < BUCKET_ENTRIES; i++) {
+            uint64_t data = Load(bucket.data[i]);
+            uint64_t check = Load(bucket.check[i]);
+            if (!(data & VALID_BIT) || (check ^ data) != key) continue;
+
+            Entry entry = Unpack(data);
+            if (entry.depth < minDepth) return false;
+
+            if (entry.epoch != epoch) {
+                uint64_t refreshed = (data & ~(uint64_t(0xFFFF) << 48)) | (static_cast<uint64_t>(epoch) << 48);
+                if (std::atomic_ref<uint64_t>(bucket.data[i]).compare_exchange_strong(data, refreshed,
+                    std::memory_order_relaxed)) {
+                    Save(bucket.check[i], key ^ refreshed);
+                }
+            }
+            value = entry.value;
+            move = BitBoard::MapDirection(entry.move, symmetry, true);
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    // ֻͬǳĽǣÿٷ滻 epoch ɡǳ
+    void Store(Board board, int depth, double value, Direction move) {
+        int symmetry = 0;
+        Board key = BitBoard::Canonical(board, symmetry);
+        uint64_t packed = Pack(value, depth, BitBoard::MapDirection(move, symmetry), epoch);
+        EvalCacheBucket& bucket = GetBucket(key);
+
+        int victim = 0;
+        int victimScore = INT32_MAX;
+        for (int i = 0; i < BUCKET_ENTRIES; i++) {
+            uint64_t data = Load(bucket.data[i]);
+            uint64_t check = Load(bucket.check[i]);
+            if ((data & VALID_BIT) && (check ^ data) == key) {
+                if (Unpack(data).depth > depth) return;
+                victim = i;
+                break;
+            }
+
+            int score = !(data & VALID_BIT) ? INT32_MIN
+                : Unpack(data).depth - 4 * static_cast<uint16_t>(epoch - Unpack(data).epoch);
+            if (score < victimScore) {
+                victimScore = score;
+                victim = i;
+            }
+        }
+
+        Save(bucket.data[victim], packed);
+        Save(bucket.check[victim], key ^ packed);
+        stores.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // ļЧvisit(key, entry)ͳƣ֤д½
+    template <typename Visit>
+    void ForEach(Visit visit) const {
+        size_t count = static_cast<size_t>(1) << bucketBits;
+        for (size_t b = 0; b < count; b++) {
+            for (int i = 0; i < BUCKET_ENTRIES; i++) {
+                uint64_t data = Load(buckets[b].data[i]);
+                if (data & VALID_BIT) visit(Load(buckets[b].check[i]) ^ data, Unpack(data));
+            }
+        }
+    }
+
+    EvalCacheStats GetStats() const {
+        EvalCacheStats stats;
+        stats.probes = probes.load(std::memory_order_relaxed);
+        stats.hits = hits.load(std::memory_order_relaxed);
+        stats.stores = stores.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    static uint64_t Load(const uint64_t& word) {
+        return std::atomic_ref<uint64_t>(const_cast<uint64_t&>(word)).load(std::memory_order_relaxed);
+    }
+
+    static void Save(uint64_t& word, uint64_t value) {
+        std::atomic_ref<uint64_t>(word).store(value, std::memory_order_relaxed);
+    }
+
+    static uint64_t Pack(double value, int depth, Direction move, uint16_t age) {
+        float narrowed = static_cast<float>(value);
+        uint32_t bits = 0;
+        memcpy(&bits, &narrowed, sizeof(bits));
+        return bits |
+            (static_cast<uint64_t>(depth & 0xFF) << 32) |
+            (static_cast<uint64_t>(static_cast<int>(move) + 1) << 40) |
+            VALID_BIT |
+            (static_cast<uint64_t>(age) << 48);
+    }
+
+    static Entry Unpack(uint64_t data) {
+        uint32_t bits = static_cast<uint32_t>(data);
+        float value = 0.0f;
+        memcpy(&value, &bits, sizeof(value));
+        return { value, static_cast<int>((data >> 32) & 0xFF), static_cast<Direction>(((data >> 40) & 0x7) - 1),
+            static_cast<uint16_t>(data >> 48) };
+    }
+
+    EvalCacheBucket& GetBucket(uint64_t key) const {
+        return buckets[(key * 0x9E3779B97F4A7C15ULL) >> (64 - bucketBits)];
+    }
+
+    // ʱļнļͷٷ pathļͬʱʱֻһЧ඼
+    static std::string CreateIfMissing(const std::string& path, size_t megabytes, uint64_t evaluator) {
+        if (std::ifstream(path).is_open()) return path;
+
+        uint32_t bits = MIN_BUCKET_BITS;
+        while (bits < MAX_BUCKET_BITS && (static_cast<size_t>(2) << bits) * sizeof(EvalCacheBucket) <= megabytes * 1024 * 1024) {
+            bits++;
+        }
+
+        uint64_t unique = SplitMix64(static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+        std::string temporary = path + ".tmp" + std::to_string(unique % 1000000000);
+        {
+            MappedFile created(temporary, MappedFile::Access::ReadWrite,
+                sizeof(EvalCacheFileHeader) + (static_cast<size_t>(1) << bits) * sizeof(EvalCacheBucket));
+            EvalCacheFileHeader header = {};
+            memcpy(header.magic, EVALCACHE_FILE_HEADER, sizeof(header.magic));
+            header.version = EVALCACHE_FILE_VERSION;
+            header.bucketBits = bits;
+            header.evaluator = evaluator;
+            header.checksum = Crc32c::Compute(&header, offsetof(EvalCacheFileHeader, checksum));
+            memcpy(created.GetMutableData(), &header, sizeof(header));
+            created.Flush();
+        }
+
+#if defined(_WIN32)
+        if (!MoveFileExA(temporary.c_str(), path.c_str(), MOVEFILE_WRITE_THROUGH)) {
+            DeleteFileA(temporary.c_str());
+        }
+#else
+        if (link(temporary.c_str(), path.c_str()) != 0 && errno != EEXIST) {
+            int error = errno;
+            unlink(temporary.c_str());
+            throw std::runtime_error("cannot create " + path + ": " + strerror(error));
+        }
+        unlink(temporary.c_str());
+#endif
+        return path;
+    }
+};
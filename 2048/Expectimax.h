@@ -0,0 +1,240 @@
+#pragma once
+
+#include "EvaluationCache.h"
+#include "GameEngine.h"
+#include "Heuristic.h"
+#include "TranspositionTable.h"
+
+#include <cstring>
+#include <limits>
+#include <memory>
+
+// ҽڵȡĸֵڵ㰴 AddRandomTile  90%/10% 
+struct SearchResult {
+    Direction move;
+    double value;
+    bool found;
+};
+
+class ExpectimaxSearch {
+public:
+    // ǰֵ̬ıʶд־ûֵļͷ Heuristic Ĺʽ汾Ȩ
+    static uint64_t EvaluatorId() { return Heuristic::Active().GetId(); }
+
+private:
+    // ۼƸʵڸֵĻֱ֧Ӱֵ̬
+    static constexpr double PROBABILITY_THRESHOLD = 0.0001;
+
+    // ҽڵڵͬһ̣ҽڵļֵʾ
+    static const uint64_t MAX_NODE_SALT = 0x6A09E667F3BCC909ULL;
+
+    std::unique_ptr<TranspositionTable> ownTable;
+    TranspositionTable* table;
+    const Heuristic* heuristic;
+    EvaluationCache* cache;
+    TableStats stats;
+    uint64_t nodes;
+
+public:
+    explicit ExpectimaxSearch(size_t tableMegabytes = 16)
+        : ownTable(std::make_unique<TranspositionTable>(tableMegabytes)), table(ownTable.get()),
+        heuristic(&Heuristic::Active()), cache(nullptr), nodes(0) {
+    }
+
+    // ʹⲿûĸ߳ʹ
+    explicit ExpectimaxSearch(TranspositionTable& sharedTable)
+        : table(&sharedTable), heuristic(&Heuristic::Active()), cache(nullptr), nodes(0) {
+    }
+
+    // ڵĽһݵ־û棬BestMove ûδʱȲ nullptr ȡ
+    void SetCache(EvaluationCache* evaluationCache) { cache = evaluationCache; }
+
+    uint64_t GetNodeCount() const { return nodes; }
+
+    TranspositionTable& GetTable() { return *table; }
+
+    // ѱۼƵͳƺϲû
+    void FlushStats() {
+        table->RecordStats(stats);
+        stats = TableStats();
+    }
+
+    // ոԽپԽΣգԽ
+    static int AdaptiveDepth(Board board) {
+        int empty = BitBoard::CountEmpty(board);
+        if (empty >= 8) return 2;
+        if (empty >= 4) return 3;
+        return 4;
+    }
+
+    // depth ΪӲ 0 ʱݿոԶѡ
+    SearchResult BestMove(Board board, int depth = 0) {
+        if (depth <= 0) {
+            depth = AdaptiveDepth(board);
+        }
+
+        table->NewSearch();
+        nodes = 0;
+
+        SearchResult best = { Direction::Left, 0.0, false };
+        if (ProbeRoot(*table, board, depth, best)) {
+            stats.probes++;
+            stats.hits++;
+            FlushStats();
+            return best;
+        }
+        if (ProbeCache(cache, *table, board, depth, best)) {
+            return best;
+        }
+
+        for (int i = 0; i < DIRECTION_COUNT; i++) {
+            Direction direction = static_cast<Direction>(i);
+            MoveResult result = BitBoard::Move(board, direction);
+            if (!result.moved) continue;
+
+            double value = ChanceNode(result.board, depth - 1, 1.0);
+            if (!best.found || value > best.value) {
+                best = { direction, value, true };
+            }
+        }
+
+        StoreRoot(*table, board, depth, best);
+        if (cache && best.found) cache->Store(board, depth, best.value, best.move);
+        FlushStats();
+        return best;
+    }
+
+    // һƶ·飬·ʱ false
+    bool PlayMove(GameEngine& game, int depth = 0) {
+        if (game.IsGameOver()) {
+            return false;
+        }
+
+        SearchResult best = BestMove(game.GetBoard(), depth);
+        if (!best.found || !game.Move(best.move)) {
+            game.CheckGameOver();
+            return false;
+        }
+
+        game.AddRandomTile();
+        game.CheckGameOver();
+        return true;
+    }
+
+    // ԶϷֱﵽޣʵߵĲ
+    int AutoPlay(GameEngine& game, int depth = 0, int maxMoves = 0) {
+        int moves = 0;
+        while (maxMoves <= 0 || moves < maxMoves) {
+            if (!PlayMove(game, depth)) break;
+            moves++;
+        }
+        return moves;
+    }
+
+    // ֵ̬иһ Heuristic е÷ֱ
+    static double Evaluate(Board board) {
+        return Heuristic::Active().Evaluate(board);
+    }
+
+    // ڵѷ򰴹淶汣棬ȡʱӳԭ
+    static bool ProbeRoot(TranspositionTable& rootTable, Board board, int depth, SearchResult& result) {
+        int symmetry = 0;
+        Board canonical = BitBoard::Canonical(board, symmetry);
+        TranspositionTable::Entry entry;
+        if (!rootTable.Probe(canonical ^ MAX_NODE_SALT, entry) || entry.depth != depth ||
+            entry.move == TranspositionTable::NO_MOVE) {
+            return false;
+        }
+        Direction move = BitBoard::MapDirection(static_cast<Direction>(entry.move), symmetry, true);
+        result = { move, entry.value, true };
+        return true;
+    }
+
+    static void StoreRoot(TranspositionTable& rootTable, Board board, int depth, const SearchResult& result) {
+        if (!result.found) return;
+        int symmetry = 0;
+        Board canonical = BitBoard::Canonical(board, symmetry);
+        rootTable.Store(canonical ^ MAX_NODE_SALT, result.value, depth,
+            static_cast<int>(BitBoard::MapDirection(result.move, symmetry)));
+    }
+
+    // ־ûʱҲдûþ治ٷӳļ
+    static bool ProbeCache(EvaluationCache* evaluationCache, TranspositionTable& rootTable, Board board, int depth,
+        SearchResult& result) {
+        double value = 0.0;
+        Direction move = Direction::Left;
+        if (!evaluationCache || !evaluationCache->Probe(board, depth, value, move)) {
+            return false;
+        }
+        result = { move, value, true };
+        StoreRoot(rootTable, board, depth, result);
+        return true;
+    }
+
+    // ڵ㺯Ҳڲֱֲӵ
+    double MaxNode(Board board, int depth, double probability) {
+        nodes++;
+        double best = -std::numeric_limits<double>::infinity();
+        bool found = false;
+        for (int i = 0; i < DIRECTION_COUNT; i++) {
+            MoveResult result = BitBoard::Move(board, static_cast<Direction>(i));
+            if (!result.moved) continue;
+
+            double value = ChanceNode(result.board, depth - 1, probability);
+            if (value > best) best = value;
+            found = true;
+        }
+        return found ? best : heuristic->GetLossValue();
+    }
+
+    double ChanceNode(Board board, int depth, double probability) {
+        nodes++;
+        if (IsLeaf(depth, probability)) {
+            return heuristic->Evaluate(board);
+        }
+
+        // Գƾֵͬͳһ淶ʽӹ淶ʽչ
+        Board canonical = BitBoard::Canonical(board);
+        uint64_t key = ChanceKey(canonical, depth, probability);
+        TranspositionTable::Entry entry;
+        stats.probes++;
+        if (table->Probe(key, entry) && entry.depth == depth) {
+            stats.hits++;
+            return entry.value;
+        }
+
+        int empty = BitBoard::CountEmpty(canonical);
+        double cellProbability = probability / empty;
+        double total = 0.0;
+
+        for (int i = 0; i < BOARD_CELLS; i++) {
+            if (((canonical >> (i * 4)) & 0xF) != 0) continue;
+
+            total += SPAWN_TWO_PROBABILITY *
+                MaxNode(canonical | (Board(1) << (i * 4)), depth, cellProbability * SPAWN_TWO_PROBABILITY);
+            total += (1.0 - SPAWN_TWO_PROBABILITY) *
+                MaxNode(canonical | (Board(2) << (i * 4)), depth, cellProbability * (1.0 - SPAWN_TWO_PROBABILITY));
+        }
+
+        double value = RoundValue(total / empty);
+        table->Store(key, value, depth);
+        stats.stores++;
+        return value;
+    }
+
+    // ڵĹֵֻȡڹ淶桢ʣȺۼƸʣЩ֧ضϣ߶д
+    // ʱֻͬֵҲûľ룬˽˳򡢱ݺ߳޹
+    static bool IsLeaf(int depth, double probability) {
+        return depth <= 0 || probability < PROBABILITY_THRESHOLD;
+    }
+
+    static uint64_t ChanceKey(Board canonical, int depth, double probability) {
+        uint64_t bits = 0;
+        memcpy(&bits, &probability, sizeof(bits));
+        return canonical ^ SplitMix64(bits + static_cast<uint64_t>(depth));
+    }
+
+    static double RoundValue(double value) {
+        return static_cast<float>(value);
+    }
+};
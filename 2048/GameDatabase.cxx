@@ -0,0 +1,270 @@
+// Ծַ⹤ߣingest ݻط־еÿһ֣ͬÿдɰд洢ķ⣻
+// query ÿ޹صĿ飬ɨխɹͳƣinfo  show 鿴ļ͵
+// 룺g++ -std=c++20 -O2 -DNDEBUG -pthread GameDatabase.cxx -o gamedb
+
+#include "GameDatabase.h"
+#include "GameEngine.h"
+#include "ReplayJournal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct DatabaseOptions {
+    int threads = 0;    // 0 ʾʹȫӲ߳
+    uint32_t blockGames = GAMEDB_DEFAULT_BLOCK_GAMES;
+    GameQuery query;
+};
+
+static int ExponentOf(uint64_t tile) {
+    return tile == 0 ? 0 : static_cast<int>(std::bit_width(tile)) - 1;
+}
+
+// Ӻͷݣhistory ռÿһ̣֮־¼ͷʱ׳쳣
+static void ReplayBoards(const ReplayView& view, std::vector<Board>& history) {
+    GameEngine game(view.header.seed);
+    game.NewGame();
+    history.clear();
+    history.push_back(game.GetBoard());
+    for (uint32_t i = 0; i < view.header.moveCount; i++) {
+        if (!game.Move(view.GetMove(i))) {
+            throw std::runtime_error("illegal move in journal game with seed " + std::to_string(view.header.seed));
+        }
+        game.AddRandomTile();
+        history.push_back(game.GetBoard());
+    }
+    if (game.GetBoard() != view.header.finalBoard || static_cast<uint32_t>(game.GetScore()) != view.header.finalScore) {
+        throw std::runtime_error("journal game with seed " + std::to_string(view.header.seed) + " does not replay");
+    }
+}
+
+// ÿζһĶԾ֣̳߳ϲݣٰ־˳д
+static int Ingest(const std::string& path, const std::vector<std::string>& journals, const DatabaseOptions& options) {
+    WorkStealingPool pool(options.threads);
+    GameDatabaseWriter writer(path, options.blockGames);
+    std::vector<ReplayView> views;
+    std::vector<std::vector<Board>> histories(options.blockGames);
+    const size_t chunk = 256;
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t journalBytes = 0;
+    for (const std::string& journal : journals) {
+        ReplayReader reader(journal);
+        journalBytes += reader.GetSize();
+        bool more = true;
+        while (more) {
+            views.clear();
+            ReplayView view;
+            while (views.size() < options.blockGames && (more = reader.Next(view))) {
+                views.push_back(view);
+            }
+
+            TaskGroup group(pool);
+            for (size_t begin = 0; begin < views.size(); begin += chunk) {
+                size_t end = (std::min)(views.size(), begin + chunk);
+                group.Run([&views, &histories, begin, end]() {
+                    for (size_t i = begin; i < end; i++) ReplayBoards(views[i], histories[i]);
+                });
+            }
+            group.Wait();
+
+            for (size_t i = 0; i < views.size(); i++) {
+                GameSummary summary = { views[i].header.seed, views[i].header.finalScore, views[i].header.moveCount,
+                    static_cast<uint8_t>(BitBoard::MaxExponent(views[i].header.finalBoard)) };
+                writer.Append(summary, histories[i].data(), histories[i].size());
+            }
+        }
+    }
+    writer.Finish();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    GameDatabase database(path);
+    const GameDbFileHeader& header = database.GetHeader();
+    printf("games       : %llu from %zu journal(s), %.1f bytes/game in journals\n",
+        static_cast<unsigned long long>(header.games), journals.size(),
+        header.games ? static_cast<double>(journalBytes) / header.games : 0.0);
+    printf("database    : %zu bytes in %u blocks, %.2f bytes/board (raw 8)\n", database.GetFileSize(),
+        header.blockCount, header.boards ? static_cast<double>(database.GetFileSize()) / header.boards : 0.0);
+    printf("ingest      : %.3f s, %.0f games/s\n", seconds, seconds > 0.0 ? header.games / seconds : 0.0);
+    return 0;
+}
+
+static int PrintInfo(const std::string& path) {
+    GameDatabase database(path);
+    const GameDbFileHeader& header = database.GetHeader();
+    uint64_t columnBytes = 0;
+    uint64_t boardBytes = 0;
+    uint32_t minTile = 255, maxTile = 0, maxScore = 0;
+    for (uint32_t i = 0; i < database.GetBlockCount(); i++) {
+        const GameDbBlockIndex& block = database.GetBlock(i);
+        GameDbBlockLayout layout(block.games, block.scoreBits, block.movesBits, block.tileBits);
+        columnBytes += layout.boardOffsets;
+        boardBytes += block.size - layout.boardOffsets;
+        minTile = (std::min)(minTile, static_cast<uint32_t>(block.minTile));
+        maxTile = (std::max)(maxTile, static_cast<uint32_t>(block.maxTile));
+        maxScore = (std::max)(maxScore, block.maxScore);
+    }
+    uint32_t corrupt = database.Verify();
+
+    printf("games       : %llu in %u blocks of %u\n", static_cast<unsigned long long>(header.games), header.blockCount,
+        header.blockGames);
+    printf("columns     : %llu bytes (seed, score, moves, tile), %.2f bytes/game\n",
+        static_cast<unsigned long long>(columnBytes), header.games ? static_cast<double>(columnBytes) / header.games : 0.0);
+    printf("boards      : %llu boards in %llu bytes, %.2f bytes/board\n", static_cast<unsigned long long>(header.boards),
+        static_cast<unsigned long long>(boardBytes), header.boards ? static_cast<double>(boardBytes) / header.boards : 0.0);
+    if (header.games) {
+        printf("range       : tile %d..%d, max score %u\n", 1 << minTile, 1 << maxTile, maxScore);
+    }
+    printf("checksums   : %s\n", corrupt ? (std::to_string(corrupt) + " corrupt blocks").c_str() : "ok");
+    return corrupt ? 2 : 0;
+}
+
+static int RunQuery(const std::string& path, const DatabaseOptions& options) {
+    GameDatabase database(path);
+    WorkStealingPool pool(options.threads);
+    const GameQuery& query = options.query;
+
+    auto start = std::chrono::steady_clock::now();
+    GameQueryResult result = database.Query(query, options.threads == 1 ? nullptr : &pool);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const char* label = query.groupBy == GameQuery::GroupBy::Tile ? "tile"
+        : query.groupBy == GameQuery::GroupBy::Moves ? "moves"
+        : query.groupBy == GameQuery::GroupBy::Score ? "score" : "all";
+    uint64_t matched = 0;
+    printf("%10s %10s %12s %10s %10s %10s\n", label, "games", "mean score", "max score", "mean moves", "max moves");
+    for (const auto& [key, group] : result.groups) {
+        long long shown = query.groupBy == GameQuery::GroupBy::Tile ? (key ? 1LL << key : 0) : static_cast<long long>(key);
+        printf("%10lld %10llu %12.1f %10u %10.1f %10u\n", shown, static_cast<unsigned long long>(group.games),
+            static_cast<double>(group.scoreSum) / group.games, group.maxScore,
+            static_cast<double>(group.movesSum) / group.games, group.maxMoves);
+        matched += group.games;
+    }
+    for (uint64_t game : result.matches) {
+        GameSummary summary = database.GetSummary(game);
+        printf("game %llu: seed %llu, score %u, tile %d, moves %u\n", static_cast<unsigned long long>(game),
+            static_cast<unsigned long long>(summary.seed), summary.score, summary.tile ? 1 << summary.tile : 0,
+            summary.moves);
+    }
+
+    uint64_t games = database.GetHeader().games;
+    printf("matched     : %llu of %llu games\n", static_cast<unsigned long long>(matched),
+        static_cast<unsigned long long>(games));
+    printf("blocks      : %llu scanned, %llu skipped by zone map\n", static_cast<unsigned long long>(result.blocksScanned),
+        static_cast<unsigned long long>(result.blocksSkipped));
+    printf("scan        : %.3f ms, %.0f M games/s, %.2f GB/s of column data\n", seconds * 1e3,
+        seconds > 0.0 ? games / seconds / 1e6 : 0.0, seconds > 0.0 ? result.bytesScanned / seconds / 1e9 : 0.0);
+    return 0;
+}
+
+static int ShowGame(const std::string& path, uint64_t game) {
+    GameDatabase database(path);
+    GameSummary summary = database.GetSummary(game);
+    std::vector<Board> boards = database.GetBoards(game);
+    printf("game %llu: seed %llu, score %u, tile %d, moves %u\n", static_cast<unsigned long long>(game),
+        static_cast<unsigned long long>(summary.seed), summary.score, summary.tile ? 1 << summary.tile : 0, summary.moves);
+    for (size_t i = 0; i < boards.size(); i++) {
+        printf("%6zu %016llx\n", i, static_cast<unsigned long long>(boards[i]));
+    }
+    return 0;
+}
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "usage: %s ingest DB JOURNAL... [--block N] [--threads N]\n", program);
+    fprintf(stderr, "       %s query DB [--min-tile N] [--max-tile N] [--min-score N] [--max-score N]\n", program);
+    fprintf(stderr, "           [--min-moves N] [--max-moves N] [--group-by none|tile|moves|score] [--bucket N]\n");
+    fprintf(stderr, "           [--list N] [--threads N]\n");
+    fprintf(stderr, "       %s info DB\n", program);
+    fprintf(stderr, "       %s show DB GAME\n", program);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::string command = argv[1];
+    std::vector<std::string> positional;
+    DatabaseOptions options;
+    GameQuery& query = options.query;
+    bool bucketSet = false;
+    int i = 2;
+    for (; i < argc && strncmp(argv[i], "--", 2) != 0; i++) {
+        positional.push_back(argv[i]);
+    }
+    for (; i < argc; i += 2) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        if (strcmp(arg, "--threads") == 0) options.threads = atoi(value);
+        else if (strcmp(arg, "--block") == 0) options.blockGames = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if (strcmp(arg, "--min-tile") == 0) query.minTile = static_cast<uint8_t>(ExponentOf(strtoull(value, nullptr, 10)));
+        else if (strcmp(arg, "--max-tile") == 0) query.maxTile = static_cast<uint8_t>(ExponentOf(strtoull(value, nullptr, 10)));
+        else if (strcmp(arg, "--min-score") == 0) query.minScore = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if (strcmp(arg, "--max-score") == 0) query.maxScore = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if (strcmp(arg, "--min-moves") == 0) query.minMoves = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if (strcmp(arg, "--max-moves") == 0) query.maxMoves = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if (strcmp(arg, "--bucket") == 0) {
+            query.bucket = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+            bucketSet = true;
+        }
+        else if (strcmp(arg, "--list") == 0) query.listLimit = static_cast<size_t>(strtoull(value, nullptr, 10));
+        else if (strcmp(arg, "--group-by") == 0) {
+            if (strcmp(value, "none") == 0) query.groupBy = GameQuery::GroupBy::None;
+            else if (strcmp(value, "tile") == 0) query.groupBy = GameQuery::GroupBy::Tile;
+            else if (strcmp(value, "moves") == 0) query.groupBy = GameQuery::GroupBy::Moves;
+            else if (strcmp(value, "score") == 0) query.groupBy = GameQuery::GroupBy::Score;
+            else {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        }
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    // δָʱÿ 100 һ飬ÿ 10000 һ
+    if (!bucketSet) {
+        query.bucket = query.groupBy == GameQuery::GroupBy::Score ? 10000
+            : query.groupBy == GameQuery::GroupBy::Moves ? 100 : 1;
+    }
+    if (options.threads <= 0) {
+        options.threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (query.bucket == 0 || options.blockGames == 0 || options.blockGames > GAMEDB_MAX_BLOCK_GAMES) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        if (command == "ingest" && positional.size() >= 2) {
+            return Ingest(positional[0], std::vector<std::string>(positional.begin() + 1, positional.end()), options);
+        }
+        if (command == "query" && positional.size() == 1) return RunQuery(positional[0], options);
+        if (command == "info" && positional.size() == 1) return PrintInfo(positional[0]);
+        if (command == "show" && positional.size() == 2) {
+            return ShowGame(positional[0], strtoull(positional[1].c_str(), nullptr, 10));
+        }
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "gamedb failed: %s\n", e.what());
+        return 1;
+    }
+
+    PrintUsage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,572 @@
+#pragma once
+
+#include "BitBoard.h"
+#include "Crc32c.h"
+#include "MappedFile.h"
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Ծַ⣺д洢ֻļԾְ飨Ĭÿ 4096 ֣ţÿ
+// ԭ 8 ֽڣշ󷽿ָԿСֵΪ׼Ҫλܴ
+// ÿ̰һĲ루16 λ仯 + 仯ֵÿ 4 λ
+// ļĩβĿͬʱ zone mapѯȰеС/ֵ飬ֻҪխ
+const char GAMEDB_FILE_HEADER[8] = { '2', '0', '4', '8', 'G', 'A', 'M', 'E' };
+const uint32_t GAMEDB_FILE_VERSION = 1;
+const uint32_t GAMEDB_DEFAULT_BLOCK_GAMES = 4096;
+const uint32_t GAMEDB_MAX_BLOCK_GAMES = 1u << 20;
+
+#pragma pack(push, 1)
+struct GameDbFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t blockGames;    // ÿľһԸ
+    uint64_t games;
+    uint64_t boards;
+    uint64_t indexOffset;   // λãһ֮
+    uint32_t blockCount;
+    uint32_t indexChecksum; // CRC32Cȫ
+    uint32_t reserved[3];
+    uint32_t checksum;      // CRC32Cǰֶ
+};
+
+// СֵͬʱǸдʱĻ׼bits Ϊλ
+struct GameDbBlockIndex {
+    uint64_t offset;
+    uint32_t size;
+    uint32_t games;
+    uint32_t minScore;
+    uint32_t maxScore;
+    uint32_t minMoves;
+    uint32_t maxMoves;
+    uint8_t minTile;
+    uint8_t maxTile;
+    uint8_t scoreBits;
+    uint8_t movesBits;
+    uint8_t tileBits;
+    uint8_t reserved[7];
+    uint32_t checksum;      // CRC32C
+};
+#pragma pack(pop)
+
+static_assert(sizeof(GameDbFileHeader) == 64 && sizeof(GameDbBlockIndex) == 48, "game database layout changed");
+
+// һֵժҪtile Ϊ󷽿ָ
+struct GameSummary {
+    uint64_t seed;
+    uint32_t score;
+    uint32_t moves;
+    uint8_t tile;
+};
+
+namespace GameDbCodec {
+    // ĩβһ֣ʱÿֵһ 8 ֽڵķǶȡȡ
+    inline size_t PackedWords(size_t count, uint32_t bits) {
+        return bits == 0 ? 0 : (count * bits + 63) / 64 + 1;
+    }
+
+    inline uint32_t BitsFor(uint32_t range) {
+        return range == 0 ? 0 : 32 - std::countl_zero(range);
+    }
+
+    inline void Pack(const uint32_t* values, size_t count, uint32_t base, uint32_t bits, uint64_t* words) {
+        memset(words, 0, PackedWords(count, bits) * sizeof(uint64_t));
+        for (size_t i = 0; i < count && bits != 0; i++) {
+            uint64_t value = values[i] - base;
+            size_t bit = i * bits;
+            words[bit >> 6] |= value << (bit & 63);
+            if ((bit & 63) + bits > 64) {
+                words[(bit >> 6) + 1] |= value >> (64 - (bit & 63));
+            }
+        }
+    }
+
+    // ֵֽڿʼ 8 ֽڣλʣ 56 λ㹻κβ 32 λֵѭûз֧
+    inline void Unpack(const uint64_t* words, size_t count, uint32_t base, uint32_t bits, uint32_t* values) {
+        if (bits == 0) {
+            std::fill(values, values + count, base);
+            return;
+        }
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(words);
+        uint64_t mask = (uint64_t(1) << bits) - 1;
+        for (size_t i = 0; i < count; i++) {
+            size_t bit = i * bits;
+            uint64_t value;
+            memcpy(&value, bytes + (bit >> 3), sizeof(value));
+            values[i] = base + static_cast<uint32_t>((value >> (bit & 7)) & mask);
+        }
+    }
+
+    // ֻͨӱ仯һ̱Ƚ
+    inline void AppendBoard(std::vector<uint8_t>& out, Board previous, Board board) {
+        Board diff = previous ^ board;
+        uint16_t mask = 0;
+        for (int cell = 0; cell < 16; cell++) {
+            if ((diff >> (cell * 4)) & 0xF) mask |= static_cast<uint16_t>(1u << cell);
+        }
+        out.push_back(static_cast<uint8_t>(mask));
+        out.push_back(static_cast<uint8_t>(mask >> 8));
+
+        int count = 0;
+        for (int cell = 0; cell < 16; cell++) {
+            if (!(mask & (1u << cell))) continue;
+            uint8_t value = static_cast<uint8_t>((board >> (cell * 4)) & 0xF);
+            if (count++ % 2 == 0) out.push_back(value);
+            else out.back() |= static_cast<uint8_t>(value << 4);
+        }
+    }
+
+    // ضֽ
+    inline size_t ReadBoard(const uint8_t* data, Board& board) {
+        uint32_t mask = data[0] | (static_cast<uint32_t>(data[1]) << 8);
+        const uint8_t* values = data + 2;
+        int count = 0;
+        while (mask != 0) {
+            int cell = std::countr_zero(mask);
+            mask &= mask - 1;
+            Board value = (values[count / 2] >> ((count % 2) * 4)) & 0xF;
+            board = (board & ~(Board(0xF) << (cell * 4))) | (value << (cell * 4));
+            count++;
+        }
+        return 2 + (count + 1) / 2;
+    }
+}
+
+// ڸеλáж 8 ֽڱ߽翪ʼӳֱӰ uint64_t ȡ
+struct GameDbBlockLayout {
+    size_t seeds;
+    size_t scores;
+    size_t moves;
+    size_t tiles;
+    size_t boardOffsets;    // games + 1  uint32_t i ֵеֽڷΧ
+    size_t boards;
+
+    GameDbBlockLayout(uint32_t games, uint32_t scoreBits, uint32_t movesBits, uint32_t tileBits) {
+        seeds = 0;
+        scores = seeds + games * sizeof(uint64_t);
+        moves = scores + GameDbCodec::PackedWords(games, scoreBits) * sizeof(uint64_t);
+        tiles = moves + GameDbCodec::PackedWords(games, movesBits) * sizeof(uint64_t);
+        boardOffsets = tiles + GameDbCodec::PackedWords(games, tileBits) * sizeof(uint64_t);
+        boards = boardOffsets + (static_cast<size_t>(games + 1) * sizeof(uint32_t) + 7) / 8 * 8;
+    }
+};
+
+// ׷ӣһдFinish дļͷΪĿļ
+class GameDatabaseWriter {
+private:
+    std::string path;
+    std::string temporary;
+    std::ofstream out;
+    uint32_t blockGames;
+    uint64_t offset;
+    uint64_t games;
+    uint64_t boards;
+    bool finished;
+    std::vector<GameDbBlockIndex> index;
+
+    std::vector<GameSummary> pending;
+    std::vector<uint32_t> boardOffsets;
+    std::vector<uint8_t> boardStream;
+
+public:
+    explicit GameDatabaseWriter(const std::string& filePath, uint32_t gamesPerBlock = GAMEDB_DEFAULT_BLOCK_GAMES)
+        : path(filePath), temporary(filePath + ".tmp"), blockGames(gamesPerBlock), offset(sizeof(GameDbFileHeader)),
+        games(0), boards(0), finished(false) {
+        if (blockGames == 0 || blockGames > GAMEDB_MAX_BLOCK_GAMES) {
+            throw std::invalid_argument("invalid block size");
+        }
+        out.open(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("cannot write " + temporary);
+        }
+        GameDbFileHeader header = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pending.reserve(blockGames);
+        boardOffsets.reserve(blockGames + 1);
+        boardOffsets.push_back(0);
+    }
+
+    ~GameDatabaseWriter() {
+        if (!finished) {
+            out.close();
+            std::remove(temporary.c_str());
+        }
+    }
+
+    GameDatabaseWriter(const GameDatabaseWriter&) = delete;
+    GameDatabaseWriter& operator=(const GameDatabaseWriter&) = delete;
+
+    uint64_t GetGameCount() const { return games; }
+
+    // history Ϊ̺֮ÿһɷ飩̣ summary.moves + 1 
+    void Append(const GameSummary& summary, const Board* history, size_t count) {
+        if (count != static_cast<size_t>(summary.moves) + 1) {
+            throw std::invalid_argument("board history does not match move count");
+        }
+        Board previous = 0;
+        for (size_t i = 0; i < count; i++) {
+            GameDbCodec::AppendBoard(boardStream, previous, history[i]);
+            previous = history[i];
+        }
+        if (boardStream.size() > UINT32_MAX) {
+            throw std::runtime_error("game database block too large");
+        }
+        boardOffsets.push_back(static_cast<uint32_t>(boardStream.size()));
+        pending.push_back(summary);
+        games++;
+        boards += count;
+
+        if (pending.size() == blockGames) {
+            FlushBlock();
+        }
+    }
+
+    void Finish() {
+        if (finished) return;
+        FlushBlock();
+
+        GameDbFileHeader header = {};
+        memcpy(header.magic, GAMEDB_FILE_HEADER, sizeof(header.magic));
+        header.version = GAMEDB_FILE_VERSION;
+        header.blockGames = blockGames;
+        header.games = games;
+        header.boards = boards;
+        header.indexOffset = offset;
+        header.blockCount = static_cast<uint32_t>(index.size());
+        header.indexChecksum = Crc32c::Compute(index.data(), index.size() * sizeof(GameDbBlockIndex));
+        header.checksum = Crc32c::Compute(&header, offsetof(GameDbFileHeader, checksum));
+
+        out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(GameDbBlockIndex));
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.flush();
+        if (out.fail()) {
+            throw std::runtime_error("failed writing " + temporary);
+        }
+        out.close();
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            throw std::runtime_error("cannot replace " + path + ": " + error.message());
+        }
+        finished = true;
+    }
+
+private:
+    void FlushBlock() {
+        if (pending.empty()) return;
+
+        uint32_t count = static_cast<uint32_t>(pending.size());
+        std::vector<uint32_t> scores(count), moves(count), tiles(count);
+        for (uint32_t i = 0; i < count; i++) {
+            scores[i] = pending[i].score;
+            moves[i] = pending[i].moves;
+            tiles[i] = pending[i].tile;
+        }
+
+        GameDbBlockIndex entry = {};
+        entry.offset = offset;
+        entry.games = count;
+        entry.minScore = *std::min_element(scores.begin(), scores.end());
+        entry.maxScore = *std::max_element(scores.begin(), scores.end());
+        entry.minMoves = *std::min_element(moves.begin(), moves.end());
+        entry.maxMoves = *std::max_element(moves.begin(), moves.end());
+        entry.minTile = static_cast<uint8_t>(*std::min_element(tiles.begin(), tiles.end()));
+        entry.maxTile = static_cast<uint8_t>(*std::max_element(tiles.begin(), tiles.end()));
+        entry.scoreBits = static_cast<uint8_t>(GameDbCodec::BitsFor(entry.maxScore - entry.minScore));
+        entry.movesBits = static_cast<uint8_t>(GameDbCodec::BitsFor(entry.maxMoves - entry.minMoves));
+        entry.tileBits = static_cast<uint8_t>(GameDbCodec::BitsFor(entry.maxTile - entry.minTile));
+
+        GameDbBlockLayout layout(count, entry.scoreBits, entry.movesBits, entry.tileBits);
+        size_t size = layout.boards + (boardStream.size() + 7) / 8 * 8;
+        if (size > UINT32_MAX) {
+            throw std::runtime_error("game database block too large");
+        }
+        std::vector<uint64_t> block(size / sizeof(uint64_t));
+        uint8_t* bytes = reinterpret_cast<uint8_t*>(block.data());
+        for (uint32_t i = 0; i < count; i++) {
+            block[i] = pending[i].seed;
+        }
+        GameDbCodec::Pack(scores.data(), count, entry.minScore, entry.scoreBits, &block[layout.scores / 8]);
+        GameDbCodec::Pack(moves.data(), count, entry.minMoves, entry.movesBits, &block[layout.moves / 8]);
+        GameDbCodec::Pack(tiles.data(), count, entry.minTile, entry.tileBits, &block[layout.tiles / 8]);
+        memcpy(bytes + layout.boardOffsets, boardOffsets.data(), boardOffsets.size() * sizeof(uint32_t));
+        memcpy(bytes + layout.boards, boardStream.data(), boardStream.size());
+
+        entry.size = static_cast<uint32_t>(size);
+        entry.checksum = Crc32c::Compute(bytes, size);
+        out.write(reinterpret_cast<const char*>(bytes), size);
+        index.push_back(entry);
+        offset += size;
+
+        pending.clear();
+        boardOffsets.assign(1, 0);
+        boardStream.clear();
+    }
+};
+
+struct GameQuery {
+    enum class GroupBy { None, Tile, Moves, Score };
+
+    uint32_t minScore = 0;
+    uint32_t maxScore = UINT32_MAX;
+    uint32_t minMoves = 0;
+    uint32_t maxMoves = UINT32_MAX;
+    uint8_t minTile = 0;        // ָ
+    uint8_t maxTile = 255;
+    GroupBy groupBy = GroupBy::None;
+    uint32_t bucket = 1;        // ʱÿĿ
+    size_t listLimit = 0;       // ⷵǰ listLimit ƥԾֵ
+};
+
+struct GameGroup {
+    uint64_t games = 0;
+    uint64_t scoreSum = 0;
+    uint64_t movesSum = 0;
+    uint32_t maxScore = 0;
+    uint32_t maxMoves = 0;
+
+    void Merge(const GameGroup& other) {
+        games += other.games;
+        scoreSum += other.scoreSum;
+        movesSum += other.movesSum;
+        maxScore = (std::max)(maxScore, other.maxScore);
+        maxMoves = (std::max)(maxMoves, other.maxMoves);
+    }
+};
+
+struct GameQueryResult {
+    std::map<uint32_t, GameGroup> groups;   // Ϊ½磻ʱΪָʱֻм 0
+    std::vector<uint64_t> matches;          // еǰ listLimit ƥԾ
+    uint64_t blocksScanned = 0;
+    uint64_t blocksSkipped = 0;
+    uint64_t bytesScanned = 0;              // ʵʽֽ
+};
+
+// ӳļֻʣʱУļͷ鱾У Verify 
+class GameDatabase {
+private:
+    MappedFile file;
+    GameDbFileHeader header;
+    const GameDbBlockIndex* index;
+
+public:
+    explicit GameDatabase(const std::string& path) : file(path) {
+        if (file.GetSize() < sizeof(header)) {
+            throw std::runtime_error("not a game database: " + path);
+        }
+        memcpy(&header, file.GetData(), sizeof(header));
+        if (memcmp(header.magic, GAMEDB_FILE_HEADER, sizeof(header.magic)) != 0 ||
+            header.checksum != Crc32c::Compute(&header, offsetof(GameDbFileHeader, checksum))) {
+            throw std::runtime_error("not a game database: " + path);
+        }
+        if (header.version != GAMEDB_FILE_VERSION || header.blockGames == 0 ||
+            header.blockGames > GAMEDB_MAX_BLOCK_GAMES || header.indexOffset % 8 != 0 ||
+            header.indexOffset > file.GetSize() ||
+            file.GetSize() - header.indexOffset != header.blockCount * sizeof(GameDbBlockIndex)) {
+            throw std::runtime_error("unsupported or truncated game database: " + path);
+        }
+        index = reinterpret_cast<const GameDbBlockIndex*>(file.GetData() + header.indexOffset);
+        if (Crc32c::Compute(index, header.blockCount * sizeof(GameDbBlockIndex)) != header.indexChecksum) {
+            throw std::runtime_error("game database index checksum mismatch: " + path);
+        }
+
+        uint64_t expected = sizeof(header);
+        uint64_t games = 0;
+        for (uint32_t i = 0; i < header.blockCount; i++) {
+            const GameDbBlockIndex& entry = index[i];
+            if (entry.offset != expected || entry.games == 0 || entry.games > header.blockGames ||
+                entry.size % 8 != 0 || entry.scoreBits > 32 || entry.movesBits > 32 || entry.tileBits > 8 ||
+                GameDbBlockLayout(entry.games, entry.scoreBits, entry.movesBits, entry.tileBits).boards > entry.size) {
+                throw std::runtime_error("corrupt game database index: " + path);
+            }
+            expected += entry.size;
+            games += entry.games;
+        }
+        if (expected != header.indexOffset || games != header.games) {
+            throw std::runtime_error("corrupt game database index: " + path);
+        }
+    }
+
+    const GameDbFileHeader& GetHeader() const { return header; }
+    size_t GetFileSize() const { return file.GetSize(); }
+    uint32_t GetBlockCount() const { return header.blockCount; }
+    const GameDbBlockIndex& GetBlock(uint32_t block) const { return index[block]; }
+
+    // УͲĿ
+    uint32_t Verify() const {
+        uint32_t failures = 0;
+        for (uint32_t i = 0; i < header.blockCount; i++) {
+            if (Crc32c::Compute(file.GetData() + index[i].offset, index[i].size) != index[i].checksum) failures++;
+        }
+        return failures;
+    }
+
+    GameSummary GetSummary(uint64_t game) const {
+        const GameDbBlockIndex& entry = Locate(game);
+        uint32_t row = static_cast<uint32_t>(game % header.blockGames);
+        GameDbBlockLayout layout(entry.games, entry.scoreBits, entry.movesBits, entry.tileBits);
+        std::vector<uint32_t> scores(entry.games), moves(entry.games), tiles(entry.games);
+        Decode(entry, layout, scores.data(), moves.data(), tiles.data());
+
+        GameSummary summary;
+        memcpy(&summary.seed, BlockData(entry) + layout.seeds + row * sizeof(uint64_t), sizeof(summary.seed));
+        summary.score = scores[row];
+        summary.moves = moves[row];
+        summary.tile = static_cast<uint8_t>(tiles[row]);
+        return summary;
+    }
+
+    // һÿһ
+    std::vector<Board> GetBoards(uint64_t game) const {
+        const GameDbBlockIndex& entry = Locate(game);
+        uint32_t row = static_cast<uint32_t>(game % header.blockGames);
+        GameDbBlockLayout layout(entry.games, entry.scoreBits, entry.movesBits, entry.tileBits);
+        const uint8_t* data = BlockData(entry);
+        uint32_t range[2];
+        memcpy(range, data + layout.boardOffsets + row * sizeof(uint32_t), sizeof(range));
+        if (range[0] > range[1] || layout.boards + range[1] > entry.size) {
+            throw std::runtime_error("corrupt game database block");
+        }
+
+        std::vector<Board> boards;
+        Board board = 0;
+        const uint8_t* stream = data + layout.boards;
+        for (uint32_t position = range[0]; position < range[1];) {
+            position += static_cast<uint32_t>(GameDbCodec::ReadBoard(stream + position, board));
+            boards.push_back(board);
+        }
+        return boards;
+    }
+
+    // ÿһpool Ϊʱڵ߳˳ɨ衣߳޹
+    GameQueryResult Query(const GameQuery& query, WorkStealingPool* pool = nullptr) const {
+        std::vector<GameQueryResult> partial(header.blockCount);
+        if (pool && header.blockCount > 1) {
+            TaskGroup group(*pool);
+            for (uint32_t i = 0; i < header.blockCount; i++) {
+                group.Run([this, &query, &partial, i]() { ScanBlock(query, i, partial[i]); });
+            }
+            group.Wait();
+        }
+        else {
+            for (uint32_t i = 0; i < header.blockCount; i++) {
+                ScanBlock(query, i, partial[i]);
+            }
+        }
+
+        GameQueryResult result;
+        for (const GameQueryResult& block : partial) {
+            for (const auto& [key, value] : block.groups) {
+                result.groups[key].Merge(value);
+            }
+            for (uint64_t game : block.matches) {
+                if (result.matches.size() < query.listLimit) result.matches.push_back(game);
+            }
+            result.blocksScanned += block.blocksScanned;
+            result.blocksSkipped += block.blocksSkipped;
+            result.bytesScanned += block.bytesScanned;
+        }
+        return result;
+    }
+
+private:
+    const uint8_t* BlockData(const GameDbBlockIndex& entry) const {
+        return file.GetData() + entry.offset;
+    }
+
+    const GameDbBlockIndex& Locate(uint64_t game) const {
+        if (game >= header.games) {
+            throw std::out_of_range("game " + std::to_string(game) + " out of range");
+        }
+        return index[game / header.blockGames];
+    }
+
+    void Decode(const GameDbBlockIndex& entry, const GameDbBlockLayout& layout, uint32_t* scores, uint32_t* moves,
+        uint32_t* tiles) const {
+        const uint8_t* data = BlockData(entry);
+        GameDbCodec::Unpack(reinterpret_cast<const uint64_t*>(data + layout.scores), entry.games, entry.minScore,
+            entry.scoreBits, scores);
+        GameDbCodec::Unpack(reinterpret_cast<const uint64_t*>(data + layout.moves), entry.games, entry.minMoves,
+            entry.movesBits, moves);
+        GameDbCodec::Unpack(reinterpret_cast<const uint64_t*>(data + layout.tiles), entry.games, entry.minTile,
+            entry.tileBits, tiles);
+    }
+
+    static uint32_t GroupKey(const GameQuery& query, uint32_t score, uint32_t moves, uint32_t tile) {
+        switch (query.groupBy) {
+        case GameQuery::GroupBy::Tile: return tile;
+        case GameQuery::GroupBy::Moves: return moves / query.bucket * query.bucket;
+        case GameQuery::GroupBy::Score: return score / query.bucket * query.bucket;
+        default: return 0;
+        }
+    }
+
+    void ScanBlock(const GameQuery& query, uint32_t block, GameQueryResult& result) const {
+        const GameDbBlockIndex& entry = index[block];
+        if (entry.maxScore < query.minScore || entry.minScore > query.maxScore ||
+            entry.maxMoves < query.minMoves || entry.minMoves > query.maxMoves ||
+            entry.maxTile < query.minTile || entry.minTile > query.maxTile) {
+            result.blocksSkipped++;
+            return;
+        }
+
+        // ڵķΧ zone map óۺϣŷŽ map
+        uint32_t low = GroupKey(query, entry.minScore, entry.minMoves, entry.minTile);
+        uint32_t high = GroupKey(query, entry.maxScore, entry.maxMoves, entry.maxTile);
+        uint32_t step = query.groupBy == GameQuery::GroupBy::Moves || query.groupBy == GameQuery::GroupBy::Score
+            ? query.bucket : 1;
+        size_t groupCount = (high - low) / step + 1;
+        std::vector<GameGroup> groups(groupCount + 1);  // һռĶԾ֣ѭﲻ÷֧
+
+        GameDbBlockLayout layout(entry.games, entry.scoreBits, entry.movesBits, entry.tileBits);
+        std::vector<uint32_t> scores(entry.games), moves(entry.games), tiles(entry.games);
+        Decode(entry, layout, scores.data(), moves.data(), tiles.data());
+
+        // ڸÿֵţΪ groupCount鷽ʽķ֧ᵽѭ
+        uint32_t minScore = query.minScore, maxScore = query.maxScore;
+        uint32_t minMoves = query.minMoves, maxMoves = query.maxMoves;
+        uint32_t minTile = query.minTile, maxTile = query.maxTile;
+        const uint32_t* key = query.groupBy == GameQuery::GroupBy::Tile ? tiles.data()
+            : query.groupBy == GameQuery::GroupBy::Moves ? moves.data()
+            : query.groupBy == GameQuery::GroupBy::Score ? scores.data() : nullptr;
+        std::vector<uint32_t> slots(entry.games);
+        for (uint32_t i = 0; i < entry.games; i++) {
+            bool match = (scores[i] >= minScore) & (scores[i] <= maxScore) & (moves[i] >= minMoves) &
+                (moves[i] <= maxMoves) & (tiles[i] >= minTile) & (tiles[i] <= maxTile);
+            uint32_t slot = key ? (key[i] - low) / step : 0;
+            slots[i] = match ? (std::min)(slot, static_cast<uint32_t>(groupCount)) : static_cast<uint32_t>(groupCount);
+        }
+
+        uint64_t first = static_cast<uint64_t>(block) * header.blockGames;
+        for (uint32_t i = 0; i < entry.games; i++) {
+            GameGroup& group = groups[slots[i]];
+            group.games++;
+            group.scoreSum += scores[i];
+            group.movesSum += moves[i];
+            group.maxScore = (std::max)(group.maxScore, scores[i]);
+            group.maxMoves = (std::max)(group.maxMoves, moves[i]);
+        }
+        for (uint32_t i = 0; i < entry.games && result.matches.size() < query.listLimit; i++) {
+            if (slots[i] != groupCount) result.matches.push_back(first + i);
+        }
+
+        groups.pop_back();
+        for (size_t i = 0; i < groups.size(); i++) {
+            if (groups[i].games) result.groups[low + static_cast<uint32_t>(i) * step] = groups[i];
+        }
+        result.blocksScanned++;
+        result.bytesScanned += layout.boardOffsets - layout.scores;
+    }
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "BoardVariant.h"
+#include "Profiler.h"
+#include "Random.h"
+
+#include <random>
+#include <stdexcept>
+
+constexpr double SPAWN_TWO_PROBABILITY = 0.9;   // ·Ϊ 2 ĸʣΪ 4
+constexpr uint32_t SPAWN_TWO_THRESHOLD = static_cast<uint32_t>(SPAWN_TWO_PROBABILITY * 4294967296.0);
+
+// ɲԣ 32 λ·ָTWO_PROBABILITY Ϊ 2 ľȷʣʹ
+struct StandardSpawn {
+    static constexpr double TWO_PROBABILITY = SPAWN_TWO_THRESHOLD / 4294967296.0;
+
+    static constexpr int Exponent(uint32_t random) {
+        return random < SPAWN_TWO_THRESHOLD ? 1 : 2;
+    }
+};
+
+struct TwoOnlySpawn {
+    static constexpr double TWO_PROBABILITY = 1.0;
+
+    static constexpr int Exponent(uint32_t) {
+        return 1;
+    }
+};
+
+// һʤָɲԣȫڱȷ
+template <int Rows, int Columns, int WinExponent = WIN_TILE_EXPONENT, typename Spawn = StandardSpawn>
+struct GameRules {
+    using Layout = VariantBoard<Rows, Columns>;
+    using SpawnPolicy = Spawn;
+    static constexpr int WIN_EXPONENT = WinExponent;
+};
+
+// ƽ̨޹صϷ߼GUI ǰ˹ͬһƶ򣻹ʵרô
+template <typename Rules>
+class BasicGameEngine {
+public:
+    using Layout = typename Rules::Layout;
+    using BoardType = typename Layout::Board;
+
+private:
+    BoardType board;
+    int score;
+    bool gameOver;
+    bool won;
+    mutable uint32_t legalMoves;    // ǰ̵ĺϷ߷룬̸ıΪ LEGAL_MOVES_UNKNOWNõʱŲ
+    GameRandom rng;
+
+public:
+    // ĬʹӣҪֶԾʱ Seed
+    BasicGameEngine() : rng(std::random_device()()) {
+        Reset();
+    }
+
+    explicit BasicGameEngine(uint64_t seed) : rng(seed) {
+        Reset();
+    }
+
+    void Seed(uint64_t seed) {
+        rng.Seed(seed);
+    }
+
+    GameRandom& GetRandom() { return rng; }
+
+    void Reset() {
+        board = BoardType();
+        score = 0;
+        gameOver = false;
+        won = false;
+        legalMoves = LEGAL_MOVES_UNKNOWN;
+    }
+
+    void NewGame() {
+        Reset();
+        AddRandomTile();
+        AddRandomTile();
+    }
+
+    BoardType GetBoard() const { return board; }
+    int GetScore() const { return score; }
+    bool IsGameOver() const { return gameOver; }
+    bool IsWon() const { return won; }
+
+    int GetTile(int row, int col) const {
+        int exponent = Layout::GetExponent(board, row, col);
+        return exponent == 0 ? 0 : (1 << exponent);
+    }
+
+    void SetState(BoardType newBoard, int newScore, bool newGameOver, bool newWon) {
+        board = newBoard;
+        score = newScore;
+        gameOver = newGameOver;
+        won = newWon;
+        legalMoves = LEGAL_MOVES_UNKNOWN;
+    }
+
+    // ̵ÿһǺϷָֻ
+    bool ValidateState() const {
+        return score >= 0;
+    }
+
+    // ÿոλѡֱӶλ·λãڴ
+    void AddRandomTile() {
+        PROFILE_ZONE("AddRandomTile");
+        typename Layout::EmptyCells empty = Layout::FindEmpty(board);
+        int count = Layout::CountCells(empty);
+        if (count == 0) {
+            throw std::runtime_error("No empty cells available for new tile");
+        }
+
+        uint64_t random = rng.Next();
+        Layout::PlaceTile(board, empty, RandomBelow(static_cast<uint32_t>(random >> 32), count),
+            Rules::SpawnPolicy::Exponent(static_cast<uint32_t>(random)));
+        legalMoves = LEGAL_MOVES_UNKNOWN;
+
+#ifndef NDEBUG
+        if (!ValidateState() || Layout::CountEmpty(board) != count - 1) {
+            throw std::runtime_error("Game state invalid after adding random tile");
+        }
+#endif
+    }
+
+    // ֪ʱ CheckGameOver ֮󣩲Ϸķֱӷأƶ
+    // δ֪ʱƶ˵ǷϷΪ˶
+    bool Move(Direction direction) {
+        PROFILE_ZONE("Move");
+        if (legalMoves != LEGAL_MOVES_UNKNOWN && !(legalMoves & (1u << static_cast<int>(direction)))) {
+            return false;
+        }
+
+        typename Layout::MoveResult result = Layout::Move(board, direction);
+        if (!result.moved) {
+            return false;
+        }
+
+        board = result.board;
+        legalMoves = LEGAL_MOVES_UNKNOWN;
+        score += static_cast<int>(result.score);
+        if (result.maxMerged >= static_cast<uint32_t>(Rules::WIN_EXPONENT)) {
+            won = true;
+        }
+        return true;
+    }
+
+    bool MoveLeft() { return Move(Direction::Left); }
+    bool MoveRight() { return Move(Direction::Right); }
+    bool MoveUp() { return Move(Direction::Up); }
+    bool MoveDown() { return Move(Direction::Down); }
+
+    //  d λʾ d ܸı̣ÿһα֮ж϶ O(1)
+    uint32_t GetLegalMoves() const {
+        if (legalMoves == LEGAL_MOVES_UNKNOWN) {
+            legalMoves = Layout::LegalMoves(board);
+        }
+        return legalMoves;
+    }
+
+    bool CanMove() const {
+        return GetLegalMoves() != LEGAL_MOVES_NONE;
+    }
+
+    void CheckGameOver() {
+        PROFILE_ZONE("CheckGameOver");
+        if (!CanMove()) {
+            gameOver = true;
+        }
+    }
+};
+
+using GameEngine = BasicGameEngine<GameRules<BOARD_SIZE, BOARD_SIZE>>;
+
+// ʵõĹϣ2x2  2x3 ܵ󷽿ֱ 32  128ԴΪʤ
+using GameEngine2x2 = BasicGameEngine<GameRules<2, 2, 5>>;
+using GameEngine2x3 = BasicGameEngine<GameRules<2, 3, 7>>;
+using GameEngine3x3 = BasicGameEngine<GameRules<3, 3, 8>>;     // 256 ʤ
+using GameEngine5x5 = BasicGameEngine<GameRules<5, 5>>;
+using GameEngine6x6 = BasicGameEngine<GameRules<6, 6>>;
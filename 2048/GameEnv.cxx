@@ -0,0 +1,85 @@
+// Ĺ⣺ VectorEnv.h װ GameEnv.h е C ӿڣ쳣ڱ߽紦תΪ
+// 룺g++ -std=c++20 -O2 -DNDEBUG -pthread -shared -fPIC -fvisibility=hidden GameEnv.cxx -o libgameenv.so
+// Windows  /LD /DGAME_ENV_EXPORTS Ϊ DLL
+
+#define GAME_ENV_EXPORTS
+#include "GameEnv.h"
+#include "VectorEnv.h"
+
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+struct GameEnv {
+    VectorEnvironment environment;
+    std::string lastError;
+
+    explicit GameEnv(int threads) : environment(threads) {
+    }
+};
+
+static thread_local std::string createError;
+
+// ִһεã쳣¼ env תΪ
+template <typename Call>
+static int32_t Guard(GameEnv* env, Call call) {
+    try {
+        call();
+        return GAME_ENV_OK;
+    }
+    catch (const std::invalid_argument& e) {
+        env->lastError = e.what();
+        return GAME_ENV_INVALID_ARGUMENT;
+    }
+    catch (const std::exception& e) {
+        env->lastError = e.what();
+        return GAME_ENV_FAILED;
+    }
+}
+
+extern "C" {
+
+uint32_t game_env_abi_version(void) {
+    return GAME_ENV_ABI_VERSION;
+}
+
+GameEnv* game_env_create(int32_t threads) {
+    try {
+        return new GameEnv(threads);
+    }
+    catch (const std::exception& e) {
+        createError = e.what();
+        return nullptr;
+    }
+}
+
+void game_env_destroy(GameEnv* env) {
+    delete env;
+}
+
+int32_t game_env_reset(GameEnv* env, uint32_t count, const uint64_t* seeds, uint64_t* out_boards, uint8_t* out_legal_mask) {
+    if (env == nullptr) return GAME_ENV_INVALID_ARGUMENT;
+    return Guard(env, [&]() { env->environment.Reset(count, seeds, out_boards, out_legal_mask); });
+}
+
+int32_t game_env_step(GameEnv* env, const uint8_t* actions, uint64_t* out_boards, float* out_rewards, uint8_t* out_done,
+    uint8_t* out_legal_mask) {
+    if (env == nullptr) return GAME_ENV_INVALID_ARGUMENT;
+    return Guard(env, [&]() {
+        if (actions == nullptr && env->environment.GetCount() > 0) {
+            throw std::invalid_argument("actions must not be NULL");
+        }
+        env->environment.Step(actions, out_boards, out_rewards, out_done, out_legal_mask);
+    });
+}
+
+uint32_t game_env_count(const GameEnv* env) {
+    return env ? static_cast<uint32_t>(env->environment.GetCount()) : 0;
+}
+
+const char* game_env_last_error(const GameEnv* env) {
+    return env ? env->lastError.c_str() : createError.c_str();
+}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+//  2048  C ӿڣ Pythonctypes / cffiͨãʵּ GameEnv.cxx
+// ɵ߷䣬ȵ game_env_reset  countָΪ NULL ʾҪ
+//  GAME_ENV_OK 򸺵Ĵ룬Ϣ game_env_last_error ȡá
+// ͬһܱ߳ͬʱã֮ͬ以Ӱ
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(GAME_ENV_EXPORTS)
+#define GAME_ENV_API __declspec(dllexport)
+#else
+#define GAME_ENV_API __declspec(dllimport)
+#endif
+#else
+#define GAME_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GAME_ENV_ABI_VERSION 1
+
+#define GAME_ENV_OK 0
+#define GAME_ENV_INVALID_ARGUMENT (-1)
+#define GAME_ENV_FAILED (-2)
+
+typedef struct GameEnv GameEnv;
+
+// ؿʵֵ GAME_ENV_ABI_VERSIONӦȱȽ
+GAME_ENV_API uint32_t game_env_abi_version(void);
+
+// threads  1 ʱڵ߳ƽȫԾ֣ʧܷ NULL
+GAME_ENV_API GameEnv* game_env_create(int32_t threads);
+GAME_ENV_API void game_env_destroy(GameEnv* env);
+
+// ؽ count ֲ֣seeds Ϊ NULL ʱʹù̶Ĭӡ
+// out_boards Ϊ̣ÿ 4 λָ 0 ڵ 16 λ BitBoard ͬ
+// out_legal_mask  d λʾ d0 1 ҡ2 ϡ3 £ܸı
+GAME_ENV_API int32_t game_env_reset(GameEnv* env, uint32_t count, const uint64_t* seeds,
+    uint64_t* out_boards, uint8_t* out_legal_mask);
+
+// ÿһΪϲ÷֣ GameEngine ƷͬϷ߷Ϊ 0 Ҳɷ飻
+// ûкϷ߷ʱ out_done Ϊ 1þؿͬһ¾
+GAME_ENV_API int32_t game_env_step(GameEnv* env, const uint8_t* actions, uint64_t* out_boards,
+    float* out_rewards, uint8_t* out_done, uint8_t* out_legal_mask);
+
+GAME_ENV_API uint32_t game_env_count(const GameEnv* env);
+
+// һʧܵ˵env Ϊ NULL ʱشʧܵԭ
+GAME_ENV_API const char* game_env_last_error(const GameEnv* env);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "GameEngine.h"
+#include "SessionStore.h"
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+// ԾַĶЭỰƽ̨޹أ¼ѭ׽ Server.cxx С
+// ӦǶ֡С򣩣ͻ˿Ͷˮߣ
+// ˳ظԭ requestId
+const uint32_t GAME_PROTOCOL_VERSION = 1;
+
+enum class GameRequestType : uint8_t {
+    NewGame = 1,    // value Ϊӣ0 ʾɷӦ»Ự
+    Move = 2,       // value ΪỰţdirection Ϊ
+    Get = 3,        // value ΪỰţֻȡǰ״̬
+    Close = 4       // value ΪỰţͷŻỰ
+};
+
+enum class GameStatus : uint8_t {
+    Ok = 0,
+    UnknownSession = 1,     // ỰŲڻѹر
+    BadRequest = 2,         // ͻǷ
+    ServerFull = 3          // ỰѴ
+};
+
+const uint8_t GAME_RESPONSE_MOVED = 1;
+const uint8_t GAME_RESPONSE_GAME_OVER = 2;
+const uint8_t GAME_RESPONSE_WON = 4;
+
+#pragma pack(push, 1)
+struct GameRequest {
+    uint8_t type;
+    uint8_t direction;
+    uint16_t reserved;
+    uint32_t requestId;
+    uint64_t value;
+};
+
+struct GameResponse {
+    uint8_t type;       // Ӧ
+    uint8_t status;
+    uint8_t flags;      // GAME_RESPONSE_*
+    uint8_t reserved;
+    uint32_t requestId;
+    uint64_t session;
+    uint64_t board;     // ̣ʽ BitBoard ͬ
+    uint32_t score;
+    uint32_t reserved2;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(GameRequest) == 16 && sizeof(GameResponse) == 32, "protocol frame size changed");
+
+// һỰ SessionStore Уÿ 24 ֽڣỰŵ 56 λ洢ľ 32 λΪλţ
+//  24 λΪλĴλúɻỰԶʧЧ
+// ÿ¼ѭ̳߳һűỰŵ 8 λɷţ
+// ͬһű̷ֻͨ߳ʣֻڱ̵߳ӷĻỰʱŻᾺ
+class GameSessionTable {
+private:
+    SessionStore store;
+    size_t capacity;
+    uint64_t nextSeed;
+    std::mutex mutex;
+
+public:
+    // seedBase ڿͻ˲ָʱӣcapacity ΪỰ
+    GameSessionTable(size_t maxSessions, uint64_t seedBase)
+        : capacity(maxSessions), nextSeed(seedBase) {
+    }
+
+    GameSessionTable(const GameSessionTable&) = delete;
+    GameSessionTable& operator=(const GameSessionTable&) = delete;
+
+    size_t GetLiveCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return store.GetLiveCount();
+    }
+
+    size_t GetMemoryBytes() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return store.GetMemoryBytes();
+    }
+
+    // ֻỰ nextSeedָӿ֮ǰظӰжԾ
+    void Save(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        store.Save(path);
+    }
+
+    void Load(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        store.Load(path);
+    }
+
+    // һtag Ϊţд»Ựŵ 8 λ
+    void Handle(const GameRequest& request, GameResponse& response, uint8_t tag) {
+        memset(&response, 0, sizeof(response));
+        response.type = request.type;
+        response.requestId = request.requestId;
+        response.session = request.value;
+
+        uint64_t handle = request.value & ((1ULL << SessionStore::HANDLE_BITS) - 1);
+        std::lock_guard<std::mutex> lock(mutex);
+        const SessionRecord* record = nullptr;
+        bool moved = false;
+        switch (static_cast<GameRequestType>(request.type)) {
+        case GameRequestType::NewGame:
+            if (store.GetLiveCount() >= capacity) {
+                response.status = static_cast<uint8_t>(GameStatus::ServerFull);
+                return;
+            }
+            handle = store.Create(request.value ? request.value : SplitMix64(nextSeed++));
+            response.session = (static_cast<uint64_t>(tag) << SessionStore::HANDLE_BITS) | handle;
+            record = store.Find(handle);
+            break;
+
+        case GameRequestType::Move:
+            if (request.direction >= DIRECTION_COUNT) {
+                response.status = static_cast<uint8_t>(GameStatus::BadRequest);
+                return;
+            }
+            record = store.Move(handle, static_cast<Direction>(request.direction), moved);
+            if (moved) response.flags |= GAME_RESPONSE_MOVED;
+            break;
+
+        case GameRequestType::Get:
+            record = store.Find(handle);
+            break;
+
+        case GameRequestType::Close:
+            record = store.Find(handle);
+            if (record) {
+                Fill(*record, response);
+                store.Close(handle);
+                return;
+            }
+            break;
+
+        default:
+            response.status = static_cast<uint8_t>(GameStatus::BadRequest);
+            return;
+        }
+
+        if (record == nullptr) {
+            response.status = static_cast<uint8_t>(GameStatus::UnknownSession);
+            return;
+        }
+        Fill(*record, response);
+    }
+
+    static uint8_t TagOf(uint64_t session) {
+        return static_cast<uint8_t>(session >> SessionStore::HANDLE_BITS);
+    }
+
+private:
+    static void Fill(const SessionRecord& record, GameResponse& response) {
+        response.board = record.board;
+        response.score = record.score;
+        if (record.state & SESSION_GAME_OVER) response.flags |= GAME_RESPONSE_GAME_OVER;
+        if (record.state & SESSION_WON) response.flags |= GAME_RESPONSE_WON;
+    }
+};
@@ -0,0 +1,257 @@
+#pragma once
+
+#include "BitBoard.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// ľֵ̬мոɺϲԡƽȺͱ߽Ǵ󷽿飬
+// ȫ 65536 ִԤüȨ÷ֵֻ֣̹ 4  + 4 й 8 β
+// ֵɸ·ߵľȡ GetLossValue()κδĹֵ
+struct HeuristicWeights {
+    double lostPenalty = 200000.0;      // ÿУй 8 һεĳĴ·߸߳ķ
+    double emptyWeight = 270.0;
+    double mergesWeight = 700.0;
+    double monotonicityPower = 4.0;
+    double monotonicityWeight = 47.0;   // ۷֣нСķǵ
+    double sumPower = 3.5;
+    double sumWeight = 11.0;            // ۷ָ֣ sumPower η֮
+    double smoothnessWeight = 0.0;      // ۷֣ڷǿշ飨ո񣩵ָ֮
+    double cornerWeight = 0.0;          // ӷ֣˽ϴ󷽿ָ sumPower ηϵĸиһ
+};
+
+// ÿеֵScoreRow ȨذǺϳһ÷
+struct HeuristicRowFeatures {
+    int empty;
+    int merges;
+    double monotonicity;
+    double sum;
+    double smoothness;
+    double corner;
+};
+
+class Heuristic {
+public:
+    static const size_t ROW_COUNT = 65536;
+
+private:
+    // ޸ļ㷽ʽʱʹȨĹֵʧЧ
+    static const uint64_t FORMULA_VERSION = 3;
+
+    std::unique_ptr<double[]> rows;
+    HeuristicWeights weights;
+    double lossValue;
+    uint64_t id;
+
+public:
+    explicit Heuristic(const HeuristicWeights& heuristicWeights = HeuristicWeights())
+        : rows(std::make_unique<double[]>(ROW_COUNT)), lossValue(0.0), id(0) {
+        Configure(heuristicWeights);
+    }
+
+    Heuristic(const Heuristic&) = delete;
+    Heuristic& operator=(const Heuristic&) = delete;
+
+    // ͵ؽȡõȻЧڽеͬʱ
+    void Configure(const HeuristicWeights& heuristicWeights) {
+        Validate(heuristicWeights);
+        weights = heuristicWeights;
+        double lowest = std::numeric_limits<double>::infinity();
+        for (size_t row = 0; row < ROW_COUNT; row++) {
+            rows[row] = ScoreRow(static_cast<uint16_t>(row), weights);
+            lowest = (std::min)(lowest, rows[row]);
+        }
+        // 8 ߸ȡе÷κδֵ½磬ȥÿߵĳ
+        lossValue = (lowest - weights.lostPenalty) * (BOARD_SIZE * 2);
+        id = ComputeId(weights);
+    }
+
+    const HeuristicWeights& GetWeights() const { return weights; }
+
+    // ·ߣϷľĹֵκδٵ 8  lostPenaltyֵ޹
+    double GetLossValue() const { return lossValue; }
+
+    // ɹʽ汾ȫȨıʶд־ûֵļͷ
+    uint64_t GetId() const { return id; }
+
+    double Evaluate(Board board) const {
+        Board transposed = BitBoard::Transpose(board);
+        double value = 0.0;
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            value += rows[BitBoard::GetRow(board, i)];
+            value += rows[BitBoard::GetRow(transposed, i)];
+        }
+        return value;
+    }
+
+    // 㣬ڽͻ׼
+    static double EvaluateDirect(Board board, const HeuristicWeights& heuristicWeights) {
+        Board transposed = BitBoard::Transpose(board);
+        double value = 0.0;
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            value += ScoreRow(BitBoard::GetRow(board, i), heuristicWeights);
+            value += ScoreRow(BitBoard::GetRow(transposed, i), heuristicWeights);
+        }
+        return value;
+    }
+
+    static double ScoreRow(uint16_t row, const HeuristicWeights& w) {
+        HeuristicRowFeatures features = ComputeFeatures(row, w);
+        return w.lostPenalty +
+            w.emptyWeight * features.empty +
+            w.mergesWeight * features.merges -
+            w.monotonicityWeight * features.monotonicity -
+            w.sumWeight * features.sum -
+            w.smoothnessWeight * features.smoothness +
+            w.cornerWeight * features.corner;
+    }
+
+    static HeuristicRowFeatures ComputeFeatures(uint16_t row, const HeuristicWeights& w) {
+        int tiles[BOARD_SIZE];
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            tiles[i] = (row >> (i * 4)) & 0xF;
+        }
+
+        HeuristicRowFeatures features = {};
+        int previous = 0;
+        int counter = 0;
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            int tile = tiles[i];
+            features.sum += std::pow(tile, w.sumPower);
+            if (tile == 0) {
+                features.empty++;
+                continue;
+            }
+            if (previous != 0) {
+                features.smoothness += std::abs(tile - previous);
+            }
+            if (previous == tile) {
+                counter++;
+            }
+            else if (counter > 0) {
+                features.merges += 1 + counter;
+                counter = 0;
+            }
+            previous = tile;
+        }
+        if (counter > 0) {
+            features.merges += 1 + counter;
+        }
+
+        double monotonicityLeft = 0.0;
+        double monotonicityRight = 0.0;
+        for (int i = 1; i < BOARD_SIZE; i++) {
+            double a = std::pow(tiles[i - 1], w.monotonicityPower);
+            double b = std::pow(tiles[i], w.monotonicityPower);
+            if (tiles[i - 1] > tiles[i]) {
+                monotonicityLeft += a - b;
+            }
+            else {
+                monotonicityRight += b - a;
+            }
+        }
+        features.monotonicity = (std::min)(monotonicityLeft, monotonicityRight);
+        features.corner = std::pow((std::max)(tiles[0], tiles[BOARD_SIZE - 1]), w.sumPower);
+        return features;
+    }
+
+    // ıãÿС ֵ# ֮ΪעͣδֵȨرĬֵ
+    static HeuristicWeights Load(const std::string& path) {
+        std::ifstream input(path);
+        if (!input.is_open()) {
+            throw std::runtime_error("cannot open " + path);
+        }
+
+        HeuristicWeights loaded;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(input, line)) {
+            lineNumber++;
+            size_t comment = line.find('#');
+            if (comment != std::string::npos) line.erase(comment);
+
+            std::istringstream fields(line);
+            std::string name;
+            if (!(fields >> name)) continue;
+
+            std::string where = path + ":" + std::to_string(lineNumber);
+            double* target = FindWeight(loaded, name);
+            if (!target) {
+                throw std::runtime_error("unknown heuristic weight '" + name + "' at " + where);
+            }
+            double value = 0.0;
+            std::string rest;
+            if (!(fields >> value) || (fields >> rest)) {
+                throw std::runtime_error("expected one number after '" + name + "' at " + where);
+            }
+            *target = value;
+        }
+        Validate(loaded);
+        return loaded;
+    }
+
+    // ʹõĽڹֵĬȨأSetActive ڿʼ֮ǰ
+    static Heuristic& Active() {
+        static Heuristic active;
+        return active;
+    }
+
+    static void SetActive(const HeuristicWeights& heuristicWeights) {
+        Active().Configure(heuristicWeights);
+    }
+
+    // ȡļΪǰֵpath Ϊʱκ
+    static void LoadActive(const std::string& path) {
+        if (!path.empty()) SetActive(Load(path));
+    }
+
+private:
+    static double* FindWeight(HeuristicWeights& w, const std::string& name) {
+        if (name == "lost_penalty") return &w.lostPenalty;
+        if (name == "empty") return &w.emptyWeight;
+        if (name == "merges") return &w.mergesWeight;
+        if (name == "monotonicity_power") return &w.monotonicityPower;
+        if (name == "monotonicity") return &w.monotonicityWeight;
+        if (name == "sum_power") return &w.sumPower;
+        if (name == "sum") return &w.sumWeight;
+        if (name == "smoothness") return &w.smoothnessWeight;
+        if (name == "corner") return &w.cornerWeight;
+        return nullptr;
+    }
+
+    static void Validate(const HeuristicWeights& w) {
+        const double values[] = { w.lostPenalty, w.emptyWeight, w.mergesWeight, w.monotonicityPower,
+            w.monotonicityWeight, w.sumPower, w.sumWeight, w.smoothnessWeight, w.cornerWeight };
+        for (double value : values) {
+            if (!std::isfinite(value)) throw std::runtime_error("heuristic weights must be finite");
+        }
+        if (w.monotonicityPower < 0.0 || w.sumPower < 0.0) {
+            throw std::runtime_error("heuristic powers must not be negative");
+        }
+        if (w.lostPenalty <= 0.0) {
+            throw std::runtime_error("lost_penalty must be positive");
+        }
+    }
+
+    static uint64_t ComputeId(const HeuristicWeights& w) {
+        const double values[] = { w.lostPenalty, w.emptyWeight, w.mergesWeight, w.monotonicityPower,
+            w.monotonicityWeight, w.sumPower, w.sumWeight, w.smoothnessWeight, w.cornerWeight };
+        uint64_t hash = SplitMix64(FORMULA_VERSION);
+        for (double value : values) {
+            uint64_t bits = 0;
+            memcpy(&bits, &value, sizeof(bits));
+            hash = SplitMix64(hash ^ bits);
+        }
+        return hash;
+    }
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ڴӳļȡļʱƵûյֻļӳΪ䡣
+// дģʽļʱ minimumSize ʱչ޸ֱдļ
+// Shared  ReadWrite ͬͬʱԶдʽӳͬһļWindows Ĭ϶ռд
+class MappedFile {
+public:
+    enum class Access {
+        ReadOnly,
+        ReadWrite,
+        Shared
+    };
+
+private:
+    uint8_t* data;
+    size_t size;
+    Access access;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int file;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path, Access mode = Access::ReadOnly, size_t minimumSize = 0)
+        : data(nullptr), size(0), access(mode) {
+        bool writable = mode != Access::ReadOnly;
+#if defined(_WIN32)
+        mapping = NULL;
+        file = CreateFileA(path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+            mode == Access::Shared ? FILE_SHARE_READ | FILE_SHARE_WRITE : FILE_SHARE_READ, NULL,
+            writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("cannot open " + path);
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            Close();
+            throw std::runtime_error("cannot stat " + path);
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+        if (writable && size < minimumSize) {
+            size = minimumSize;
+        }
+        if (size == 0) {
+            return;
+        }
+
+        // ӳСļʱ CreateFileMapping ļչó
+        uint64_t mappingSize = size;
+        mapping = CreateFileMappingA(file, NULL, writable ? PAGE_READWRITE : PAGE_READONLY,
+            static_cast<DWORD>(mappingSize >> 32), static_cast<DWORD>(mappingSize), NULL);
+        if (mapping != NULL) {
+            data = static_cast<uint8_t*>(MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+        }
+#else
+        file = open(path.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+        if (file < 0) {
+            throw std::runtime_error("cannot open " + path);
+        }
+
+        struct stat info;
+        if (fstat(file, &info) != 0) {
+            Close();
+            throw std::runtime_error("cannot stat " + path);
+        }
+        size = static_cast<size_t>(info.st_size);
+        if (writable && size < minimumSize) {
+            if (ftruncate(file, static_cast<off_t>(minimumSize)) != 0) {
+                Close();
+                throw std::runtime_error("cannot resize " + path);
+            }
+            size = minimumSize;
+        }
+        if (size == 0) {
+            return;
+        }
+
+        void* view = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+            writable ? MAP_SHARED : MAP_PRIVATE, file, 0);
+        if (view != MAP_FAILED) {
+            data = static_cast<uint8_t*>(view);
+            if (!writable) madvise(view, size, MADV_SEQUENTIAL);
+        }
+#endif
+        if (data == nullptr) {
+            Close();
+            throw std::runtime_error("cannot map " + path);
+        }
+    }
+
+    ~MappedFile() {
+        Close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* GetData() const { return data; }
+    size_t GetSize() const { return size; }
+
+    uint8_t* GetMutableData() {
+        if (access == Access::ReadOnly) {
+            throw std::logic_error("mapping is read-only");
+        }
+        return data;
+    }
+
+    // ʾں˰ӳԤҳ棬ʺҪȫݵĳϣұ
+    void Prefetch() {
+        if (data == nullptr) return;
+#if !defined(_WIN32)
+        madvise(data, size, MADV_WILLNEED);
+#endif
+    }
+
+    // ޸ĵҳͬд
+    void Flush() {
+        if (access == Access::ReadOnly || data == nullptr) return;
+#if defined(_WIN32)
+        bool ok = FlushViewOfFile(data, 0) && FlushFileBuffers(file);
+#else
+        bool ok = msync(data, size, MS_SYNC) == 0;
+#endif
+        if (!ok) {
+            throw std::runtime_error("failed to flush mapped file");
+        }
+    }
+
+private:
+    void Close() {
+#if defined(_WIN32)
+        if (data) UnmapViewOfFile(data);
+        if (mapping != NULL) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = NULL;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data) munmap(data, size);
+        if (file >= 0) close(file);
+        file = -1;
+#endif
+        data = nullptr;
+    }
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "BoardVariant.h"
+#include "Expectimax.h"
+#include "NTupleNetwork.h"
+
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// ӲԽӿڣģȹͨѡÿһķ
+class MovePolicy {
+public:
+    virtual ~MovePolicy() = default;
+
+    virtual const char* GetName() const = 0;
+
+    //  false ʾûпߵķ
+    virtual bool ChooseMove(Board board, GameRandom& rng, Direction& move) = 0;
+
+    // ÿֿʼǰãһµ״̬ʹÿֵ߷ֻȡڱ֣߳ηԾ޹
+    virtual void NewGame() {}
+
+    // ƴԣrandomgreedyexpectimaxntupleҪȨļδ֪Ʒ nullptr
+    // cache ֻ expectimaxΪ
+    static std::unique_ptr<MovePolicy> Create(const std::string& name, int depth, const std::string& weightsPath = "",
+        EvaluationCache* cache = nullptr);
+
+    // ֻƣԣexpectimax ûڽв
+    static bool IsKnown(const std::string& name) {
+        return name == "random" || name == "greedy" || name == "expectimax" || name == "ntuple";
+    }
+};
+
+// ̰Ĳ԰̲ģ廯̱壨 BoardVariant.hֱӵã׼Ĳת
+template <typename Layout>
+bool ChooseRandomMove(const typename Layout::Board& board, GameRandom& rng, Direction& move) {
+    uint32_t legal = Layout::LegalMoves(board);
+    int count = std::popcount(legal);
+    if (count == 0) {
+        return false;
+    }
+
+    move = static_cast<Direction>(BitBoard::SelectBit(legal, RandomBelow(static_cast<uint32_t>(rng.Next() >> 32), count)));
+    return true;
+}
+
+template <typename Layout>
+bool ChooseGreedyMove(const typename Layout::Board& board, Direction& move) {
+    bool found = false;
+    uint32_t bestScore = 0;
+    int bestEmpty = 0;
+    for (int i = 0; i < DIRECTION_COUNT; i++) {
+        typename Layout::MoveResult result = Layout::Move(board, static_cast<Direction>(i));
+        if (!result.moved) continue;
+
+        int empty = Layout::CountEmpty(result.board);
+        if (!found || result.score > bestScore || (result.score == bestScore && empty > bestEmpty)) {
+            found = true;
+            bestScore = result.score;
+            bestEmpty = empty;
+            move = static_cast<Direction>(i);
+        }
+    }
+    return found;
+}
+
+// Чоѡ
+class RandomPolicy : public MovePolicy {
+public:
+    const char* GetName() const override { return "random"; }
+
+    bool ChooseMove(Board board, GameRandom& rng, Direction& move) override {
+        return ChooseRandomMove<VariantBoard<BOARD_SIZE, BOARD_SIZE>>(board, rng, move);
+    }
+};
+
+// ѡ񱾲÷ߵķ򣬵÷ͬʱȿոķ
+class GreedyPolicy : public MovePolicy {
+public:
+    const char* GetName() const override { return "greedy"; }
+
+    bool ChooseMove(Board board, GameRandom&, Direction& move) override {
+        return ChooseGreedyMove<VariantBoard<BOARD_SIZE, BOARD_SIZE>>(board, move);
+    }
+};
+
+class ExpectimaxPolicy : public MovePolicy {
+private:
+    ExpectimaxSearch search;
+    int depth;
+
+public:
+    explicit ExpectimaxPolicy(int searchDepth, EvaluationCache* cache = nullptr) : depth(searchDepth) {
+        search.SetCache(cache);
+    }
+
+    const char* GetName() const override { return "expectimax"; }
+
+    // ûڵӰֵͬѡ񣬲ܴһ
+    void NewGame() override {
+        search.GetTable().Clear();
+    }
+
+    bool ChooseMove(Board board, GameRandom&, Direction& move) override {
+        SearchResult best = search.BestMove(board, depth);
+        move = best.move;
+        return best.found;
+    }
+};
+
+//  N ԪĹֵѡƶõķȨļֻӳ䣬̵߳ĲԹͬһҳ
+class NTuplePolicy : public MovePolicy {
+private:
+    NTupleNetwork network;
+
+public:
+    explicit NTuplePolicy(const std::string& weightsPath) : network(weightsPath) {
+    }
+
+    const char* GetName() const override { return "ntuple"; }
+
+    bool ChooseMove(Board board, GameRandom&, Direction& move) override {
+        return network.ChooseMove(board, move);
+    }
+};
+
+inline std::unique_ptr<MovePolicy> MovePolicy::Create(const std::string& name, int depth, const std::string& weightsPath,
+    EvaluationCache* cache) {
+    if (name == "random") return std::make_unique<RandomPolicy>();
+    if (name == "greedy") return std::make_unique<GreedyPolicy>();
+    if (name == "expectimax") return std::make_unique<ExpectimaxPolicy>(depth, cache);
+    if (name == "ntuple" && !weightsPath.empty()) return std::make_unique<NTuplePolicy>(weightsPath);
+    return nullptr;
+}
@@ -0,0 +1,366 @@
+#pragma once
+
+#include "BitBoard.h"
+#include "CpuFeatures.h"
+#include "Crc32c.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(CPU_FEATURES_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NTUPLE_TARGET_AVX2 __attribute__((target("avx2,bmi2")))
+#else
+#define NTUPLE_TARGET_AVX2
+#endif
+
+const char NTUPLE_FILE_HEADER[8] = { '2', '0', '4', '8', 'N', 'T', 'U', 'P' };
+const uint32_t NTUPLE_FILE_VERSION = 1;
+const int NTUPLE_MAX_TUPLES = 16;
+const int NTUPLE_MAX_LENGTH = 6;    // 16^6  32 λ
+const int NTUPLE_SYMMETRIES = 8;
+
+// һԪ鸲ǵĸӣrow * 4 + colʱ
+struct NTupleShape {
+    int length;
+    uint8_t cells[NTUPLE_MAX_LENGTH];
+};
+
+// Ȩļ192 ֽļͷ֮ȫԪ float ȨأÿԪ 16^length 
+#pragma pack(push, 1)
+struct NTupleFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t tupleCount;
+    uint8_t lengths[NTUPLE_MAX_TUPLES];
+    uint8_t cells[NTUPLE_MAX_TUPLES][NTUPLE_MAX_LENGTH];
+    uint64_t trainedGames;
+    uint64_t weightCount;
+    uint32_t weightsChecksum;   // CRC32CȫȨ
+    uint32_t reserved[10];
+    uint32_t checksum;          // CRC32Cǰֶ
+};
+#pragma pack(pop)
+
+static_assert(sizeof(NTupleFileHeader) == 192, "n-tuple file layout changed");
+
+// N Ԫֵ磺ÿԪ 8 ԳƾϸȡһֵΪȫ 8 * T Ȩ֮͡
+// Ȩؿɱ̳УѵҲֻӳȨļ̹ͬһҳ
+// ʱ֧ AVX2  BMI2 ʱÿ pext һָȡÿԪ 8 Ȩһ gather ȡ
+class NTupleNetwork {
+private:
+    std::vector<NTupleShape> shapes;
+    std::vector<uint64_t> masks;        // ÿԪ鸲ǵİֽ룬pext ֱӵõ
+    std::vector<size_t> offsets;        // ÿԪȨе
+    size_t weightCount;
+    std::vector<float> ownWeights;
+    std::unique_ptr<MappedFile> file;
+    const float* weights;
+    float* mutableWeights;              // ֻӳʱΪ nullptr
+    uint64_t trainedGames;
+    bool useGather;
+
+public:
+    //  4  6 Ԫ飨ֱ߼ 2x3 飩Լ 6700 Ȩأ 256MB
+    static std::vector<NTupleShape> StandardShapes() {
+        return {
+            { 6, { 0, 1, 2, 3, 4, 5 } },
+            { 6, { 4, 5, 6, 7, 8, 9 } },
+            { 6, { 0, 1, 2, 4, 5, 6 } },
+            { 6, { 4, 5, 6, 8, 9, 10 } }
+        };
+    }
+
+    //  2x2 ɵ 4 Ԫ飬ֻ 5 * 65536 ȨأʺϿʵ
+    static std::vector<NTupleShape> SmallShapes() {
+        return {
+            { 4, { 0, 1, 2, 3 } },
+            { 4, { 4, 5, 6, 7 } },
+            { 4, { 0, 1, 4, 5 } },
+            { 4, { 1, 2, 5, 6 } },
+            { 4, { 5, 6, 9, 10 } }
+        };
+    }
+
+    // 磬ȫȨΪ initialValue
+    explicit NTupleNetwork(const std::vector<NTupleShape>& tupleShapes, float initialValue = 0.0f)
+        : weightCount(0), weights(nullptr), mutableWeights(nullptr), trainedGames(0) {
+        SetShapes(tupleShapes);
+        ownWeights.assign(weightCount, initialValue);
+        weights = mutableWeights = ownWeights.data();
+    }
+
+    // ȨļĬֻӳ䣬̿ɹcopyWeights Ϊ true ʱƵڴ沢УȨأ֮Լѵ
+    explicit NTupleNetwork(const std::string& path, bool copyWeights = false)
+        : weightCount(0), weights(nullptr), mutableWeights(nullptr), trainedGames(0) {
+        file = std::make_unique<MappedFile>(path);
+        if (file->GetSize() < sizeof(NTupleFileHeader)) {
+            throw std::runtime_error("not an n-tuple weight file: " + path);
+        }
+
+        NTupleFileHeader header;
+        memcpy(&header, file->GetData(), sizeof(header));
+        if (memcmp(header.magic, NTUPLE_FILE_HEADER, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("not an n-tuple weight file: " + path);
+        }
+        if (header.version != NTUPLE_FILE_VERSION) {
+            throw std::runtime_error("unsupported n-tuple weight file version");
+        }
+        if (header.checksum != Crc32c::Compute(&header, offsetof(NTupleFileHeader, checksum)) ||
+            header.tupleCount == 0 || header.tupleCount > NTUPLE_MAX_TUPLES) {
+            throw std::runtime_error("corrupt n-tuple weight file header");
+        }
+
+        std::vector<NTupleShape> fileShapes(header.tupleCount);
+        for (uint32_t t = 0; t < header.tupleCount; t++) {
+            fileShapes[t].length = header.lengths[t];
+            memcpy(fileShapes[t].cells, header.cells[t], NTUPLE_MAX_LENGTH);
+        }
+        SetShapes(fileShapes);
+        if (header.weightCount != weightCount ||
+            file->GetSize() != sizeof(NTupleFileHeader) + weightCount * sizeof(float)) {
+            throw std::runtime_error("n-tuple weight file size mismatch");
+        }
+
+        trainedGames = header.trainedGames;
+        weights = reinterpret_cast<const float*>(file->GetData() + sizeof(NTupleFileHeader));
+        file->Prefetch();
+        if (copyWeights) {
+            if (Crc32c::Compute(weights, weightCount * sizeof(float)) != header.weightsChecksum) {
+                throw std::runtime_error("n-tuple weights checksum mismatch");
+            }
+            ownWeights.assign(weights, weights + weightCount);
+            file.reset();
+            weights = mutableWeights = ownWeights.data();
+        }
+    }
+
+    NTupleNetwork(const NTupleNetwork&) = delete;
+    NTupleNetwork& operator=(const NTupleNetwork&) = delete;
+
+    const std::vector<NTupleShape>& GetShapes() const { return shapes; }
+    size_t GetWeightCount() const { return weightCount; }
+    bool IsMapped() const { return file != nullptr; }
+    bool UsesGather() const { return useGather; }
+
+    uint64_t GetTrainedGames() const { return trainedGames; }
+    void SetTrainedGames(uint64_t games) { trainedGames = games; }
+
+    // ֵӸþ棨ͨƶ֮ɷ֮ǰľ棩Ԥڻܵõķ
+    float Evaluate(Board board) const {
+#if defined(CPU_FEATURES_X86)
+        if (useGather) {
+            return EvaluateAvx2(board);
+        }
+#endif
+        alignas(32) uint32_t indices[NTUPLE_MAX_TUPLES][NTUPLE_SYMMETRIES];
+        ComputeIndices(board, indices);
+        return GatherSumScalar(indices);
+    }
+
+    // Ѿ漰ÿȨؼ deltaHogwildѵ߳̿ͬʱ£
+    // ͬһȨصĲżᶪʧһΣݶȵûӰ
+    void Update(Board board, float delta) {
+        if (mutableWeights == nullptr) {
+            throw std::logic_error("n-tuple weights are read-only");
+        }
+
+        alignas(32) uint32_t indices[NTUPLE_MAX_TUPLES][NTUPLE_SYMMETRIES];
+        ComputeIndices(board, indices);
+        for (size_t t = 0; t < shapes.size(); t++) {
+            float* tuple = mutableWeights + offsets[t];
+            for (int s = 0; s < NTUPLE_SYMMETRIES; s++) {
+                std::atomic_ref<float> weight(tuple[indices[t][s]]);
+                weight.store(weight.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    int GetFeatureCount() const {
+        return static_cast<int>(shapes.size()) * NTUPLE_SYMMETRIES;
+    }
+
+    // ѡ÷ּƶֵķûпߵķʱ false
+    bool ChooseMove(Board board, Direction& move, float* value = nullptr) const {
+        bool found = false;
+        float best = 0.0f;
+        for (int i = 0; i < DIRECTION_COUNT; i++) {
+            MoveResult result = BitBoard::Move(board, static_cast<Direction>(i));
+            if (!result.moved) continue;
+
+            float candidate = static_cast<float>(result.score) + Evaluate(result.board);
+            if (!found || candidate > best) {
+                found = true;
+                best = candidate;
+                move = static_cast<Direction>(i);
+            }
+        }
+        if (value) *value = best;
+        return found;
+    }
+
+    // 㣺дʱļٸ;ʧܲƻеȨļ
+    // ѵ߳̿ͬʱȨأдĳһʱ̸Ŀ
+    void Save(const std::string& path) const {
+        std::vector<float> chunk;
+        const size_t CHUNK_WEIGHTS = 1 << 16;
+        chunk.reserve(CHUNK_WEIGHTS);
+
+        NTupleFileHeader header = {};
+        memcpy(header.magic, NTUPLE_FILE_HEADER, sizeof(header.magic));
+        header.version = NTUPLE_FILE_VERSION;
+        header.tupleCount = static_cast<uint32_t>(shapes.size());
+        for (size_t t = 0; t < shapes.size(); t++) {
+            header.lengths[t] = static_cast<uint8_t>(shapes[t].length);
+            memcpy(header.cells[t], shapes[t].cells, NTUPLE_MAX_LENGTH);
+        }
+        header.trainedGames = trainedGames;
+        header.weightCount = weightCount;
+
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                throw std::runtime_error("cannot write " + temporary);
+            }
+
+            // ļͷдȨУҪȫȨд֪
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            uint32_t weightsChecksum = 0;
+            for (size_t begin = 0; begin < weightCount; begin += CHUNK_WEIGHTS) {
+                size_t end = (std::min)(weightCount, begin + CHUNK_WEIGHTS);
+                chunk.clear();
+                for (size_t i = begin; i < end; i++) {
+                    chunk.push_back(LoadWeight(i));
+                }
+                weightsChecksum = Crc32c::Compute(chunk.data(), chunk.size() * sizeof(float), weightsChecksum);
+                out.write(reinterpret_cast<const char*>(chunk.data()), chunk.size() * sizeof(float));
+            }
+
+            header.weightsChecksum = weightsChecksum;
+            header.checksum = Crc32c::Compute(&header, offsetof(NTupleFileHeader, checksum));
+            out.seekp(0);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.flush();
+            if (out.fail()) {
+                out.close();
+                std::remove(temporary.c_str());
+                throw std::runtime_error("failed writing " + temporary);
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("cannot replace " + path + ": " + error.message());
+        }
+    }
+
+private:
+    void SetShapes(const std::vector<NTupleShape>& tupleShapes) {
+        if (tupleShapes.empty() || tupleShapes.size() > NTUPLE_MAX_TUPLES) {
+            throw std::invalid_argument("unsupported n-tuple count");
+        }
+
+        shapes = tupleShapes;
+        masks.clear();
+        offsets.clear();
+        weightCount = 0;
+        for (NTupleShape& shape : shapes) {
+            if (shape.length < 1 || shape.length > NTUPLE_MAX_LENGTH) {
+                throw std::invalid_argument("unsupported n-tuple length");
+            }
+            std::sort(shape.cells, shape.cells + shape.length);
+            uint64_t mask = 0;
+            for (int k = 0; k < shape.length; k++) {
+                if (shape.cells[k] >= BOARD_CELLS || (k > 0 && shape.cells[k] == shape.cells[k - 1])) {
+                    throw std::invalid_argument("invalid n-tuple cell");
+                }
+                mask |= uint64_t(0xF) << (shape.cells[k] * 4);
+            }
+            for (int k = shape.length; k < NTUPLE_MAX_LENGTH; k++) {
+                shape.cells[k] = 0;
+            }
+            masks.push_back(mask);
+            offsets.push_back(weightCount);
+            weightCount += size_t(1) << (shape.length * 4);
+        }
+        useGather = CpuFeatures::Get().avx2 && CpuFeatures::Get().bmi2;
+    }
+
+    // ԪָŴӵ͵ƴɣ pext Ľͬ
+    uint32_t Extract(Board board, size_t tuple) const {
+#if defined(__BMI2__)
+        return static_cast<uint32_t>(_pext_u64(board, masks[tuple]));
+#else
+        const NTupleShape& shape = shapes[tuple];
+        uint32_t index = 0;
+        for (int k = 0; k < shape.length; k++) {
+            index |= static_cast<uint32_t>((board >> (shape.cells[k] * 4)) & 0xF) << (k * 4);
+        }
+        return index;
+#endif
+    }
+
+    void ComputeIndices(Board board, uint32_t (*indices)[NTUPLE_SYMMETRIES]) const {
+        Board variants[NTUPLE_SYMMETRIES];
+        BitBoard::Symmetries(board, variants);
+        for (size_t t = 0; t < shapes.size(); t++) {
+            for (int s = 0; s < NTUPLE_SYMMETRIES; s++) {
+                indices[t][s] = Extract(variants[s], t);
+            }
+        }
+    }
+
+    float GatherSumScalar(const uint32_t (*indices)[NTUPLE_SYMMETRIES]) const {
+        float sum = 0.0f;
+        for (size_t t = 0; t < shapes.size(); t++) {
+            const float* tuple = weights + offsets[t];
+            for (int s = 0; s < NTUPLE_SYMMETRIES; s++) {
+                sum += tuple[indices[t][s]];
+            }
+        }
+        return sum;
+    }
+
+#if defined(CPU_FEATURES_X86)
+    // ÿԪ 8 Գһ 256 λһ gather  8 Ȩ
+    NTUPLE_TARGET_AVX2 float EvaluateAvx2(Board board) const {
+        Board variants[NTUPLE_SYMMETRIES];
+        BitBoard::Symmetries(board, variants);
+
+        __m256 sum = _mm256_setzero_ps();
+        for (size_t t = 0; t < shapes.size(); t++) {
+            uint64_t mask = masks[t];
+            __m256i index = _mm256_setr_epi32(
+                static_cast<int>(_pext_u64(variants[0], mask)), static_cast<int>(_pext_u64(variants[1], mask)),
+                static_cast<int>(_pext_u64(variants[2], mask)), static_cast<int>(_pext_u64(variants[3], mask)),
+                static_cast<int>(_pext_u64(variants[4], mask)), static_cast<int>(_pext_u64(variants[5], mask)),
+                static_cast<int>(_pext_u64(variants[6], mask)), static_cast<int>(_pext_u64(variants[7], mask)));
+            sum = _mm256_add_ps(sum, _mm256_i32gather_ps(weights + offsets[t], index, 4));
+        }
+        __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+        half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+        half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+        return _mm_cvtss_f32(half);
+    }
+#endif
+
+    float LoadWeight(size_t index) const {
+        if (mutableWeights == nullptr) {
+            return weights[index];
+        }
+        return std::atomic_ref<float>(mutableWeights[index]).load(std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "Expectimax.h"
+#include "WorkStealingPool.h"
+
+#include <atomic>
+#include <limits>
+#include <vector>
+
+// ڵĸϲڵÿΪ񽻸ȡ̳߳أ
+// ߳ͨͬһûľ棬ֲ°ִС
+// ֲĻڵ봮һضϡӹ淶չͬ˳ͣ봮߳޹
+class ParallelExpectimax {
+private:
+    // ڵĵһڸʱֻһ㣬²һ
+    static const int MIN_SPLIT_TASKS = 32;
+
+    WorkStealingPool& pool;
+    TranspositionTable table;
+    EvaluationCache* cache;
+    std::atomic<uint64_t> nodes;
+    int splitPlies;
+
+public:
+    // splitPlies ΪҲԽԽϸ0 ʾݾԶѡ
+    explicit ParallelExpectimax(WorkStealingPool& taskPool, int taskSplitPlies = 0, size_t tableMegabytes = 64)
+        : pool(taskPool), table(tableMegabytes), cache(nullptr), nodes(0), splitPlies(taskSplitPlies) {
+    }
+
+    void SetCache(EvaluationCache* evaluationCache) { cache = evaluationCache; }
+
+    uint64_t GetNodeCount() const { return nodes.load(std::memory_order_relaxed); }
+
+    TranspositionTable& GetTable() { return table; }
+
+    SearchResult BestMove(Board board, int depth = 0) {
+        if (depth <= 0) {
+            depth = ExpectimaxSearch::AdaptiveDepth(board);
+        }
+
+        table.NewSearch();
+        nodes = 0;
+
+        SearchResult cached = { Direction::Left, 0.0, false };
+        if (ExpectimaxSearch::ProbeRoot(table, board, depth, cached) ||
+            ExpectimaxSearch::ProbeCache(cache, table, board, depth, cached)) {
+            return cached;
+        }
+
+        MoveResult results[DIRECTION_COUNT];
+        double values[DIRECTION_COUNT] = {};
+        bool legal[DIRECTION_COUNT] = {};
+        int legalCount = 0;
+        for (int i = 0; i < DIRECTION_COUNT; i++) {
+            results[i] = BitBoard::Move(board, static_cast<Direction>(i));
+            legal[i] = results[i].moved;
+            if (legal[i]) legalCount++;
+        }
+
+        // оֿո٣һڵ񲻶ʱ²һ㣻ֻ棬߳
+        int plies = splitPlies;
+        if (plies <= 0) {
+            int tasks = legalCount * 2 * (BitBoard::CountEmpty(board) + 1);
+            plies = tasks >= MIN_SPLIT_TASKS ? 1 : 2;
+        }
+
+        TaskGroup group(pool);
+        for (int i = 0; i < DIRECTION_COUNT; i++) {
+            if (!legal[i]) continue;
+
+            Board moved = results[i].board;
+            group.Run([this, &values, i, moved, depth, plies]() {
+                values[i] = ChanceNode(moved, depth - 1, 1.0, plies);
+            });
+        }
+        group.Wait();
+
+        SearchResult best = { Direction::Left, 0.0, false };
+        for (int i = 0; i < DIRECTION_COUNT; i++) {
+            if (legal[i] && (!best.found || values[i] > best.value)) {
+                best = { static_cast<Direction>(i), values[i], true };
+            }
+        }
+
+        ExpectimaxSearch::StoreRoot(table, board, depth, best);
+        if (cache && best.found) cache->Store(board, depth, best.value, best.move);
+        return best;
+    }
+
+    bool PlayMove(GameEngine& game, int depth = 0) {
+        if (game.IsGameOver()) {
+            return false;
+        }
+
+        SearchResult best = BestMove(game.GetBoard(), depth);
+        if (!best.found || !game.Move(best.move)) {
+            game.CheckGameOver();
+            return false;
+        }
+
+        game.AddRandomTile();
+        game.CheckGameOver();
+        return true;
+    }
+
+private:
+    double ChanceNode(Board board, int depth, double probability, int plies) {
+        if (plies <= 0 || ExpectimaxSearch::IsLeaf(depth, probability)) {
+            ExpectimaxSearch worker(table);
+            double value = worker.ChanceNode(board, depth, probability);
+            worker.FlushStats();
+            nodes.fetch_add(worker.GetNodeCount(), std::memory_order_relaxed);
+            return value;
+        }
+
+        Board canonical = BitBoard::Canonical(board);
+        uint64_t key = ExpectimaxSearch::ChanceKey(canonical, depth, probability);
+        TranspositionTable::Entry entry;
+        TableStats stats;
+        stats.probes = 1;
+        if (table.Probe(key, entry) && entry.depth == depth) {
+            stats.hits = 1;
+            table.RecordStats(stats);
+            nodes.fetch_add(1, std::memory_order_relaxed);
+            return entry.value;
+        }
+
+        int empty = BitBoard::CountEmpty(canonical);
+        double cellProbability = probability / empty;
+        std::vector<double> values(empty * 2, 0.0);
+        TaskGroup group(pool);
+
+        int child = 0;
+        for (int i = 0; i < BOARD_CELLS; i++) {
+            if (((canonical >> (i * 4)) & 0xF) != 0) continue;
+
+            for (int exponent = 1; exponent <= 2; exponent++) {
+                double weight = exponent == 1 ? SPAWN_TWO_PROBABILITY : 1.0 - SPAWN_TWO_PROBABILITY;
+                Board spawned = canonical | (Board(exponent) << (i * 4));
+                double* slot = &values[child++];
+                group.Run([this, slot, spawned, depth, cellProbability, weight, plies]() {
+                    *slot = weight * MaxNode(spawned, depth, cellProbability * weight, plies);
+                });
+            }
+        }
+        group.Wait();
+
+        double total = 0.0;
+        for (double value : values) {
+            total += value;
+        }
+        double value = ExpectimaxSearch::RoundValue(total / empty);
+        table.Store(key, value, depth);
+        stats.stores = 1;
+        table.RecordStats(stats);
+        nodes.fetch_add(1, std::memory_order_relaxed);
+        return value;
+    }
+
+    double MaxNode(Board board, int depth, double probability, int plies) {
+        nodes.fetch_add(1, std::memory_order_relaxed);
+        double best = -std::numeric_limits<double>::infinity();
+        bool found = false;
+        for (int i = 0; i < DIRECTION_COUNT; i++) {
+            MoveResult result = BitBoard::Move(board, static_cast<Direction>(i));
+            if (!result.moved) continue;
+
+            double value = ChanceNode(result.board, depth - 1, probability, plies - 1);
+            if (value > best) best = value;
+            found = true;
+        }
+        return found ? best : Heuristic::Active().GetLossValue();
+    }
+};
@@ -0,0 +1,421 @@
+#pragma once
+
+// ڿص㣺 GAME_PROFILE ʱPROFILE_ZONE("name") ¼һε
+// ʱrdtsc Linux ϵӲperf_event_openָδС֧Ԥʧܣ
+// ̻߳ܵͰֱͼɵ Chrome  JSONchrome://tracing  Perfetto 򿪣
+// δ GAME_PROFILE ʱչΪ䣬κδ
+#if defined(GAME_PROFILE)
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) \
+    static const int PROFILE_CONCAT(profileZone, __LINE__) = Profiler::RegisterZone(name); \
+    ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(profileZone, __LINE__))
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
+
+#if defined(GAME_PROFILE)
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PROFILER_RDTSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int PROFILE_COUNTER_COUNT = 3;    // ָδС֧Ԥʧ
+const size_t PROFILE_MAX_EVENTS = 1 << 20;  // ÿ̱߳ĸ¼ֱֻͼ
+
+// ʱx86  rdtscƽ̨˻ steady_clock 
+inline uint64_t ProfileTicks() {
+#if defined(PROFILER_RDTSC)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// ͰֱͼHDR 񣩣ÿ 2 ٷ 16 Ͱ 1/16
+//  64 λΧֻ 976 Ͱ¼һֵֻһ bit_width һ
+class ProfileHistogram {
+public:
+    static const int SUB_BITS = 4;
+    static const int BUCKETS = (64 - SUB_BITS - 1) * (1 << SUB_BITS) + 2 * (1 << SUB_BITS);
+
+private:
+    uint64_t counts[BUCKETS];
+    uint64_t total;
+    uint64_t sum;
+    uint64_t maximum;
+
+public:
+    ProfileHistogram() : counts(), total(0), sum(0), maximum(0) {
+    }
+
+    static int BucketOf(uint64_t value) {
+        int shift = (std::max)(0, static_cast<int>(std::bit_width(value)) - SUB_BITS - 1);
+        return (shift << SUB_BITS) + static_cast<int>(value >> shift);
+    }
+
+    // Ͱ½
+    static uint64_t ValueOf(int bucket) {
+        if (bucket < 2 << SUB_BITS) return static_cast<uint64_t>(bucket);
+        int shift = (bucket >> SUB_BITS) - 1;
+        return static_cast<uint64_t>(bucket - (shift << SUB_BITS)) << shift;
+    }
+
+    void Record(uint64_t value) {
+        counts[BucketOf(value)]++;
+        total++;
+        sum += value;
+        maximum = (std::max)(maximum, value);
+    }
+
+    void Merge(const ProfileHistogram& other) {
+        for (int i = 0; i < BUCKETS; i++) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        sum += other.sum;
+        maximum = (std::max)(maximum, other.maximum);
+    }
+
+    uint64_t GetCount() const { return total; }
+    uint64_t GetMax() const { return maximum; }
+    double GetMean() const { return total ? static_cast<double>(sum) / total : 0.0; }
+
+    uint64_t Percentile(double fraction) const {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(fraction * (total - 1));
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen > rank) return (std::min)(ValueOf(i), maximum);
+        }
+        return maximum;
+    }
+};
+
+// ǰ̵߳һӲ򲻿 Linuxû PMU  perf_event_paranoid ֹʱ IsOpen Ϊ false
+// ͬһһ read ͬʱ
+class ProfileCounters {
+private:
+#if defined(__linux__)
+    int fds[PROFILE_COUNTER_COUNT];
+#endif
+    bool open;
+
+public:
+    ProfileCounters() : open(false) {
+#if defined(__linux__)
+        static const uint64_t CONFIGS[PROFILE_COUNTER_COUNT] = {
+            PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+        for (int i = 0; i < PROFILE_COUNTER_COUNT; i++) {
+            fds[i] = -1;
+        }
+        for (int i = 0; i < PROFILE_COUNTER_COUNT; i++) {
+            perf_event_attr attr = {};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = CONFIGS[i];
+            attr.disabled = i == 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0));
+            if (fds[i] < 0) {
+                Close();
+                return;
+            }
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        open = true;
+#endif
+    }
+
+    ~ProfileCounters() {
+        Close();
+    }
+
+    ProfileCounters(const ProfileCounters&) = delete;
+    ProfileCounters& operator=(const ProfileCounters&) = delete;
+
+    bool IsOpen() const { return open; }
+
+    void Read(uint64_t values[PROFILE_COUNTER_COUNT]) const {
+#if defined(__linux__)
+        uint64_t buffer[1 + PROFILE_COUNTER_COUNT];
+        if (open && read(fds[0], buffer, sizeof(buffer)) == static_cast<ssize_t>(sizeof(buffer))) {
+            memcpy(values, buffer + 1, PROFILE_COUNTER_COUNT * sizeof(uint64_t));
+            return;
+        }
+#endif
+        memset(values, 0, PROFILE_COUNTER_COUNT * sizeof(uint64_t));
+    }
+
+private:
+    void Close() {
+#if defined(__linux__)
+        for (int i = PROFILE_COUNTER_COUNT - 1; i >= 0; i--) {
+            if (fds[i] >= 0) close(fds[i]);
+            fds[i] = -1;
+        }
+#endif
+        open = false;
+    }
+};
+
+// һִУΪڵ
+struct ProfileEvent {
+    uint64_t begin;
+    uint64_t end;
+    uint64_t counters[PROFILE_COUNTER_COUNT];
+    int zone;
+};
+
+struct ProfileZoneStats {
+    ProfileHistogram ticks;
+    uint64_t counters[PROFILE_COUNTER_COUNT] = {};
+};
+
+// ÿ߳Լļ¼ֻ߳д룻߳˳ Profiler Уʱϲ
+struct ProfileThread {
+    uint32_t id;
+    ProfileCounters counters;
+    std::vector<std::unique_ptr<ProfileZoneStats>> zones;
+    std::vector<ProfileEvent> events;
+    uint64_t droppedEvents = 0;
+
+    explicit ProfileThread(uint32_t threadId) : id(threadId) {
+    }
+
+    ProfileZoneStats& Zone(int zone) {
+        if (zones.size() <= static_cast<size_t>(zone)) zones.resize(zone + 1);
+        if (!zones[zone]) zones[zone] = std::make_unique<ProfileZoneStats>();
+        return *zones[zone];
+    }
+};
+
+// ȫע̵߳ļ¼עֻÿκÿ̵߳һγʱ
+// ¼·ûԭӲӦڱ߳̿ʱУ˳ǰ
+class Profiler {
+private:
+    std::mutex mutex;
+    std::vector<std::string> zoneNames;
+    std::vector<std::unique_ptr<ProfileThread>> threads;
+    uint64_t startTicks;
+    std::chrono::steady_clock::time_point startTime;
+
+    Profiler() : startTicks(ProfileTicks()), startTime(std::chrono::steady_clock::now()) {
+    }
+
+public:
+    static Profiler& Get() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    // ͬΣģĲͬʵһ
+    static int RegisterZone(const char* name) {
+        Profiler& profiler = Get();
+        std::lock_guard<std::mutex> lock(profiler.mutex);
+        auto found = std::find(profiler.zoneNames.begin(), profiler.zoneNames.end(), name);
+        if (found != profiler.zoneNames.end()) {
+            return static_cast<int>(found - profiler.zoneNames.begin());
+        }
+        profiler.zoneNames.push_back(name);
+        return static_cast<int>(profiler.zoneNames.size() - 1);
+    }
+
+    static ProfileThread& CurrentThread() {
+        static thread_local ProfileThread* current = nullptr;
+        if (current == nullptr) {
+            Profiler& profiler = Get();
+            std::lock_guard<std::mutex> lock(profiler.mutex);
+            profiler.threads.push_back(std::make_unique<ProfileThread>(static_cast<uint32_t>(profiler.threads.size())));
+            current = profiler.threads.back().get();
+        }
+        return *current;
+    }
+
+    // ʱ steady_clock ջÿ΢ļ
+    double TicksPerMicrosecond() {
+        auto elapsed = std::chrono::steady_clock::now() - startTime;
+        if (elapsed < std::chrono::milliseconds(10)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10) - elapsed);
+            elapsed = std::chrono::steady_clock::now() - startTime;
+        }
+        double micros = std::chrono::duration<double, std::micro>(elapsed).count();
+        return (ProfileTicks() - startTicks) / micros;
+    }
+
+    bool HasCounters() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const std::unique_ptr<ProfileThread>& thread : threads) {
+            if (thread->counters.IsOpen()) return true;
+        }
+        return false;
+    }
+
+    // ÿκϲ̺߳Ĵʱλ΢룩ÿεõƽʽΪı
+    std::string FormatSummary() {
+        double rate = TicksPerMicrosecond();
+        bool counters = HasCounters();
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::string text;
+        AppendFormat(text, "%-20s %10s %10s %10s %10s %10s %10s", "zone", "calls", "mean us", "p50 us", "p99 us",
+            "p99.9 us", "max us");
+        if (counters) AppendFormat(text, " %12s %12s %12s", "insn/call", "cmiss/call", "bmiss/call");
+        text += "\n";
+
+        uint64_t dropped = 0;
+        for (const std::unique_ptr<ProfileThread>& thread : threads) {
+            dropped += thread->droppedEvents;
+        }
+        for (size_t zone = 0; zone < zoneNames.size(); zone++) {
+            ProfileZoneStats merged;
+            for (const std::unique_ptr<ProfileThread>& thread : threads) {
+                if (zone >= thread->zones.size() || !thread->zones[zone]) continue;
+                merged.ticks.Merge(thread->zones[zone]->ticks);
+                for (int c = 0; c < PROFILE_COUNTER_COUNT; c++) {
+                    merged.counters[c] += thread->zones[zone]->counters[c];
+                }
+            }
+            uint64_t calls = merged.ticks.GetCount();
+            if (calls == 0) continue;
+
+            AppendFormat(text, "%-20s %10llu %10.3f %10.3f %10.3f %10.3f %10.3f", zoneNames[zone].c_str(),
+                static_cast<unsigned long long>(calls), merged.ticks.GetMean() / rate,
+                merged.ticks.Percentile(0.5) / rate, merged.ticks.Percentile(0.99) / rate,
+                merged.ticks.Percentile(0.999) / rate, merged.ticks.GetMax() / rate);
+            if (counters) {
+                AppendFormat(text, " %12.1f %12.2f %12.2f", static_cast<double>(merged.counters[0]) / calls,
+                    static_cast<double>(merged.counters[1]) / calls, static_cast<double>(merged.counters[2]) / calls);
+            }
+            text += "\n";
+        }
+
+        if (dropped) {
+            AppendFormat(text, "trace buffer full: %llu events kept only in the histograms\n",
+                static_cast<unsigned long long>(dropped));
+        }
+        if (!counters) {
+            text += "hardware counters unavailable, timestamps only\n";
+        }
+        return text;
+    }
+
+    // Chrome ٸʽÿִһ¼ph Ϊ Xʱ䵥λΪ΢룬 args 
+    void WriteChromeTrace(const std::string& path) {
+        double rate = TicksPerMicrosecond();
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("cannot write " + path);
+        }
+
+        std::string chunk = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        bool first = true;
+        for (const std::unique_ptr<ProfileThread>& thread : threads) {
+            AppendFormat(chunk, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+                first ? "" : ",\n", thread->id, thread->id);
+            first = false;
+            bool counters = thread->counters.IsOpen();
+            for (const ProfileEvent& event : thread->events) {
+                AppendFormat(chunk, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                    zoneNames[event.zone].c_str(), thread->id, (event.begin - startTicks) / rate,
+                    (event.end - event.begin) / rate);
+                if (counters) {
+                    AppendFormat(chunk, ",\"args\":{\"instructions\":%llu,\"cache_misses\":%llu,\"branch_misses\":%llu}",
+                        static_cast<unsigned long long>(event.counters[0]),
+                        static_cast<unsigned long long>(event.counters[1]),
+                        static_cast<unsigned long long>(event.counters[2]));
+                }
+                chunk += "}";
+                if (chunk.size() >= (1 << 20)) {
+                    out.write(chunk.data(), chunk.size());
+                    chunk.clear();
+                }
+            }
+        }
+        chunk += "\n]}\n";
+        out.write(chunk.data(), chunk.size());
+        out.flush();
+        if (out.fail()) {
+            throw std::runtime_error("failed writing " + path);
+        }
+    }
+
+private:
+    static void AppendFormat(std::string& text, const char* format, ...) {
+        char buffer[512];
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        if (length > 0) text.append(buffer, (std::min)(static_cast<size_t>(length), sizeof(buffer) - 1));
+    }
+};
+
+// ε󣺹ʱʱͼʱ¼ֱͼ͸¼
+class ProfileScope {
+private:
+    ProfileThread& thread;
+    int zone;
+    uint64_t begin;
+    uint64_t counters[PROFILE_COUNTER_COUNT];
+
+public:
+    explicit ProfileScope(int zoneId) : thread(Profiler::CurrentThread()), zone(zoneId) {
+        thread.counters.Read(counters);
+        begin = ProfileTicks();
+    }
+
+    ~ProfileScope() {
+        uint64_t end = ProfileTicks();
+        uint64_t after[PROFILE_COUNTER_COUNT];
+        thread.counters.Read(after);
+
+        ProfileZoneStats& stats = thread.Zone(zone);
+        stats.ticks.Record(end - begin);
+        ProfileEvent event = { begin, end, {}, zone };
+        for (int c = 0; c < PROFILE_COUNTER_COUNT; c++) {
+            event.counters[c] = after[c] - counters[c];
+            stats.counters[c] += event.counters[c];
+        }
+        if (thread.events.size() < PROFILE_MAX_EVENTS) thread.events.push_back(event);
+        else thread.droppedEvents++;
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#endif
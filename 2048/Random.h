@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+
+// ٿӵͬһκƽ̨ϲͬ
+// ӿһ£ UniformRandomBitGeneratorҲֱڱ׼ֲ
+
+inline uint64_t SplitMix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// xoshiro256** 2^256 - 1ÿεֻ輸λͳ˷
+class Xoshiro256 {
+private:
+    uint64_t s[4];
+
+    static uint64_t Rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    typedef uint64_t result_type;
+
+    explicit Xoshiro256(uint64_t seed = 0) {
+        Seed(seed);
+    }
+
+    void Seed(uint64_t seed) {
+        for (int i = 0; i < 4; i++) {
+            seed += 0x9E3779B97F4A7C15ULL;
+            s[i] = SplitMix64(seed);
+        }
+    }
+
+    uint64_t Next() {
+        uint64_t result = Rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = Rotl(s[3], 45);
+        return result;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+    result_type operator()() { return Next(); }
+};
+
+// PCG32XSH-RR״ֻ̬ 16 ֽڣʺҪ״̬ĳ
+class Pcg32 {
+private:
+    uint64_t state;
+    uint64_t increment;
+
+    uint32_t Step() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + increment;
+        uint32_t xorShifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorShifted >> rot) | (xorShifted << ((32 - rot) & 31));
+    }
+
+public:
+    typedef uint64_t result_type;
+
+    explicit Pcg32(uint64_t seed = 0) {
+        Seed(seed);
+    }
+
+    void Seed(uint64_t seed) {
+        state = 0;
+        increment = (SplitMix64(seed ^ 0xDA3E39CB94B95BDBULL) << 1) | 1;
+        Step();
+        state += SplitMix64(seed);
+        Step();
+    }
+
+    uint64_t Next() {
+        uint64_t high = Step();
+        return (high << 32) | Step();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+    result_type operator()() { return Next(); }
+};
+
+// Ϸʹõķ GAME_RANDOM_PCG32 лΪ PCG32
+#ifdef GAME_RANDOM_PCG32
+typedef Pcg32 GameRandom;
+#else
+typedef Xoshiro256 GameRandom;
+#endif
+
+//  32 λӳ䵽 [0, range)ó˷ȡģ
+inline uint32_t RandomBelow(uint32_t random, uint32_t range) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(random) * range) >> 32);
+}
@@ -0,0 +1,134 @@
+// ط־ߣг־еĶԾ֣ÿһֲУĳһ֡ȾΪ PPM ͼ
+// 룺g++ -std=c++20 -O2 -DNDEBUG Replay.cxx -o replay
+
+#include "ReplayJournal.h"
+#include "SoftwareRenderer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <string>
+
+static int ListGames(ReplayReader& reader) {
+    ReplayView view;
+    uint64_t games = 0;
+    printf("%8s %20s %8s %8s %6s %s\n", "game", "seed", "moves", "score", "tile", "flags");
+    while (reader.Next(view)) {
+        int exponent = BitBoard::MaxExponent(view.header.finalBoard);
+        printf("%8llu %20llu %8u %8u %6d %s%s%s\n", static_cast<unsigned long long>(games),
+            static_cast<unsigned long long>(view.header.seed), view.header.moveCount, view.header.finalScore,
+            exponent ? 1 << exponent : 0,
+            (view.header.flags & REPLAY_FLAG_GAME_OVER) ? "over " : "",
+            (view.header.flags & REPLAY_FLAG_WON) ? "won " : "",
+            (view.header.flags & REPLAY_FLAG_SPAWNS) ? "spawns" : "");
+        games++;
+    }
+    return 0;
+}
+
+static int VerifyGames(ReplayReader& reader) {
+    ReplayView view;
+    uint64_t games = 0;
+    uint64_t moves = 0;
+    uint64_t failures = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    while (reader.Next(view)) {
+        std::string error;
+        if (!ReplayVerifier::Verify(view, &error)) {
+            if (failures < 20) {
+                printf("game %llu (seed %llu): %s\n", static_cast<unsigned long long>(games),
+                    static_cast<unsigned long long>(view.header.seed), error.c_str());
+            }
+            failures++;
+        }
+        moves += view.header.moveCount;
+        games++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("games       : %llu verified, %llu failed\n", static_cast<unsigned long long>(games - failures),
+        static_cast<unsigned long long>(failures));
+    printf("journal     : %zu bytes, %.1f bytes/game\n", reader.GetSize(),
+        games ? static_cast<double>(reader.GetSize()) / games : 0.0);
+    printf("replay      : %llu moves in %.3f s, %.0f moves/s\n", static_cast<unsigned long long>(moves),
+        seconds, seconds > 0.0 ? moves / seconds : 0.0);
+    return failures ? 2 : 0;
+}
+
+// ־ݵ gameIndex ֣ÿȾһ֡ļΪ frame_00000.ppm 
+static int RenderGame(ReplayReader& reader, uint64_t gameIndex, const std::filesystem::path& directory) {
+    ReplayView view;
+    for (uint64_t i = 0; i <= gameIndex; i++) {
+        if (!reader.Next(view)) {
+            fprintf(stderr, "journal has only %llu games\n", static_cast<unsigned long long>(i));
+            return 1;
+        }
+    }
+
+    std::filesystem::create_directories(directory);
+    SoftwareRenderer renderer;
+    renderer.Resize(DEFAULT_FRAME_WIDTH, DEFAULT_FRAME_HEIGHT);
+
+    GameEngine game(view.header.seed);
+    game.NewGame();
+
+    uint64_t rects = 0;
+    double seconds = 0.0;
+    uint32_t frames = 0;
+    for (uint32_t i = 0; i <= view.header.moveCount; i++) {
+        if (i > 0) {
+            if (!game.Move(view.GetMove(i - 1))) {
+                fprintf(stderr, "illegal move %u\n", i - 1);
+                return 2;
+            }
+            game.AddRandomTile();
+        }
+        if (i == view.header.moveCount) {
+            game.CheckGameOver();
+        }
+
+        RenderState state = { game.GetBoard(), game.GetScore(), -1, game.IsGameOver(), game.IsWon() };
+        auto start = std::chrono::steady_clock::now();
+        rects += renderer.Render(state).size();
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        char name[32];
+        snprintf(name, sizeof(name), "frame_%05u.ppm", i);
+        renderer.GetFramebuffer().WritePpm((directory / name).string());
+        frames++;
+    }
+
+    printf("frames      : %u written to %s\n", frames, directory.string().c_str());
+    printf("dirty rects : %.2f per frame\n", frames ? static_cast<double>(rects) / frames : 0.0);
+    printf("render      : %.0f ns per frame\n", frames ? seconds * 1e9 / frames : 0.0);
+    return 0;
+}
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "usage: %s verify|list FILE\n", program);
+    fprintf(stderr, "       %s render FILE GAME DIR\n", program);
+}
+
+int main(int argc, char** argv) {
+    bool render = argc == 5 && strcmp(argv[1], "render") == 0;
+    if (!render && (argc != 3 || (strcmp(argv[1], "verify") != 0 && strcmp(argv[1], "list") != 0))) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        ReplayReader reader(argv[2]);
+        if (render) {
+            return RenderGame(reader, strtoull(argv[3], nullptr, 10), argv[4]);
+        }
+        return strcmp(argv[1], "verify") == 0 ? VerifyGames(reader) : ListGames(reader);
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "replay failed: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,375 @@
+#pragma once
+
+#include "GameEngine.h"
+#include "MappedFile.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ط־ֻ׷ӵĶԾּ¼ļÿֱӺÿ 2 λķ
+// ȷԵ֣ѡÿٸ 1 ֽڣָڽУ
+const char REPLAY_FILE_HEADER[9] = "2048RPLY";
+const uint32_t REPLAY_FILE_VERSION = 1;
+const uint32_t REPLAY_RECORD_MAGIC = 0x474C5052;    // "RPLG"
+
+const uint16_t REPLAY_FLAG_SPAWNS = 1;
+const uint16_t REPLAY_FLAG_GAME_OVER = 2;
+const uint16_t REPLAY_FLAG_WON = 4;
+
+// ¼ͷ֮ (moveCount + 3) / 4 ֽڵķԼ SPAWNS ־ʱ moveCount + 2 ֽɼ¼
+#pragma pack(push, 1)
+struct ReplayRecordHeader {
+    uint32_t magic;
+    uint32_t moveCount;
+    uint64_t seed;
+    uint64_t finalBoard;
+    uint32_t finalScore;
+    uint16_t flags;
+    uint16_t reserved;
+    uint32_t checksum;  // FNV-1a checksum ļ¼ͷȫ
+};
+#pragma pack(pop)
+
+inline uint32_t ReplayChecksum(const uint8_t* data, size_t size, uint32_t hash = 2166136261u) {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// ڼ¼дһ
+struct ReplayGame {
+    uint64_t seed = 0;
+    Board finalBoard = 0;
+    uint32_t finalScore = 0;
+    uint32_t moveCount = 0;
+    uint16_t flags = 0;
+    std::vector<uint8_t> moves;
+    std::vector<uint8_t> spawns;
+
+    //  GameEngine(seed) ֣NewGame֮ãinitialBoard Ϊ
+    void Begin(uint64_t gameSeed, Board initialBoard, bool recordSpawns) {
+        seed = gameSeed;
+        finalBoard = 0;
+        finalScore = 0;
+        moveCount = 0;
+        flags = recordSpawns ? REPLAY_FLAG_SPAWNS : 0;
+        moves.clear();
+        spawns.clear();
+        AddSpawn(0, initialBoard);
+    }
+
+    void AddMove(Direction direction) {
+        int slot = moveCount % 4;
+        if (slot == 0) moves.push_back(0);
+        moves.back() |= static_cast<uint8_t>(static_cast<int>(direction) << (slot * 2));
+        moveCount++;
+    }
+
+    // ǰҳ·飺 4 λΪţ 4 λΪֵָ鰴˳¼
+    void AddSpawn(Board before, Board after) {
+        if (!(flags & REPLAY_FLAG_SPAWNS)) return;
+
+        Board diff = before ^ after;
+        while (diff != 0) {
+            int shift = std::countr_zero(diff) & ~3;
+            spawns.push_back(static_cast<uint8_t>((shift / 4) | (((after >> shift) & 0xF) << 4)));
+            diff &= ~(Board(0xF) << shift);
+        }
+    }
+
+    void Finish(const GameEngine& game) {
+        finalBoard = game.GetBoard();
+        finalScore = static_cast<uint32_t>(game.GetScore());
+        flags &= REPLAY_FLAG_SPAWNS;
+        if (game.IsGameOver()) flags |= REPLAY_FLAG_GAME_OVER;
+        if (game.IsWon()) flags |= REPLAY_FLAG_WON;
+    }
+};
+
+// ׷д¼Ƚڴ滺ܹһд
+class ReplayWriter {
+private:
+    static const size_t FLUSH_THRESHOLD = 64 * 1024;
+
+    std::string path;
+    std::ofstream file;
+    std::vector<uint8_t> buffer;
+    size_t discardedBytes = 0;
+
+public:
+    // ļڻΪʱдļͷļͷ׷ӣ ReplayReader ֮
+    explicit ReplayWriter(const std::string& filePath);
+
+    ~ReplayWriter() {
+        try {
+            Flush();
+        }
+        catch (const std::exception&) {
+        }
+    }
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    // ʱļĩβصĲȱ¼ֽ
+    size_t GetDiscardedBytes() const { return discardedBytes; }
+
+    void Append(const ReplayGame& game) {
+        size_t spawnCount = (game.flags & REPLAY_FLAG_SPAWNS) ? game.moveCount + 2 : 0;
+        if (game.moves.size() != (game.moveCount + 3) / 4 || game.spawns.size() != spawnCount) {
+            throw std::runtime_error("inconsistent replay record");
+        }
+
+        ReplayRecordHeader header = {};
+        header.magic = REPLAY_RECORD_MAGIC;
+        header.moveCount = game.moveCount;
+        header.seed = game.seed;
+        header.finalBoard = game.finalBoard;
+        header.finalScore = game.finalScore;
+        header.flags = game.flags;
+
+        uint32_t checksum = ReplayChecksum(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+        checksum = ReplayChecksum(game.moves.data(), game.moves.size(), checksum);
+        checksum = ReplayChecksum(game.spawns.data(), game.spawns.size(), checksum);
+        header.checksum = checksum;
+
+        Write(&header, sizeof(header));
+        Write(game.moves.data(), game.moves.size());
+        Write(game.spawns.data(), game.spawns.size());
+
+        if (buffer.size() >= FLUSH_THRESHOLD) {
+            Flush();
+        }
+    }
+
+    void Flush() {
+        if (buffer.empty()) return;
+
+        file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        file.flush();
+        buffer.clear();
+        if (file.fail()) {
+            throw std::runtime_error("failed writing " + path);
+        }
+    }
+
+private:
+    void Write(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+};
+
+// ָӳļڲһּ¼Ƹ
+struct ReplayView {
+    ReplayRecordHeader header;
+    const uint8_t* moves;
+    const uint8_t* spawns;  // ûɼ¼ʱΪ nullptr
+
+    Direction GetMove(uint32_t index) const {
+        return static_cast<Direction>((moves[index >> 2] >> ((index & 3) * 2)) & 3);
+    }
+};
+
+// ͨڴӳ˳ȡط־
+class ReplayReader {
+private:
+    MappedFile file;
+    size_t offset;
+
+public:
+    static const size_t FILE_HEADER_SIZE = sizeof(REPLAY_FILE_HEADER) + sizeof(REPLAY_FILE_VERSION);
+
+    explicit ReplayReader(const std::string& path) : file(path), offset(FILE_HEADER_SIZE) {
+        uint32_t version = 0;
+        if (file.GetSize() < FILE_HEADER_SIZE ||
+            memcmp(file.GetData(), REPLAY_FILE_HEADER, sizeof(REPLAY_FILE_HEADER)) != 0) {
+            throw std::runtime_error("not a replay journal: " + path);
+        }
+        memcpy(&version, file.GetData() + sizeof(REPLAY_FILE_HEADER), sizeof(version));
+        if (version != REPLAY_FILE_VERSION) {
+            throw std::runtime_error("unsupported replay journal version");
+        }
+    }
+
+    size_t GetSize() const { return file.GetSize(); }
+
+    // һ¼ʼλãNext ׳쳣ָļ¼
+    size_t GetOffset() const { return offset; }
+
+    // ӵǰλõļĩβǷֻһûдļ¼ʱ£м
+    bool IsTornTail() const {
+        size_t remaining = file.GetSize() - offset;
+        if (remaining < sizeof(ReplayRecordHeader)) {
+            return true;
+        }
+        ReplayRecordHeader header;
+        memcpy(&header, file.GetData() + offset, sizeof(header));
+        return header.magic == REPLAY_RECORD_MAGIC && sizeof(ReplayRecordHeader) + PayloadSize(header) >= remaining;
+    }
+
+    void Rewind() {
+        offset = FILE_HEADER_SIZE;
+    }
+
+    // ļĩβ false¼ضϻУʧʱ׳쳣
+    bool Next(ReplayView& view) {
+        size_t size = file.GetSize();
+        if (offset == size) {
+            return false;
+        }
+        if (size - offset < sizeof(ReplayRecordHeader)) {
+            throw std::runtime_error("truncated replay record");
+        }
+
+        const uint8_t* record = file.GetData() + offset;
+        memcpy(&view.header, record, sizeof(view.header));
+        if (view.header.magic != REPLAY_RECORD_MAGIC) {
+            throw std::runtime_error("corrupt replay record");
+        }
+
+        size_t moveBytes = (static_cast<size_t>(view.header.moveCount) + 3) / 4;
+        size_t payload = PayloadSize(view.header);
+        size_t spawnBytes = payload - moveBytes;
+        if (size - offset - sizeof(ReplayRecordHeader) < payload) {
+            throw std::runtime_error("truncated replay record");
+        }
+
+        view.moves = record + sizeof(ReplayRecordHeader);
+        view.spawns = spawnBytes ? view.moves + moveBytes : nullptr;
+
+        ReplayRecordHeader blank = view.header;
+        blank.checksum = 0;
+        uint32_t checksum = ReplayChecksum(reinterpret_cast<const uint8_t*>(&blank), sizeof(blank));
+        checksum = ReplayChecksum(view.moves, payload, checksum);
+        if (checksum != view.header.checksum) {
+            throw std::runtime_error("replay record checksum mismatch");
+        }
+
+        offset += sizeof(ReplayRecordHeader) + payload;
+        return true;
+    }
+
+private:
+    static size_t PayloadSize(const ReplayRecordHeader& header) {
+        size_t moveBytes = (static_cast<size_t>(header.moveCount) + 3) / 4;
+        return moveBytes + ((header.flags & REPLAY_FLAG_SPAWNS) ? static_cast<size_t>(header.moveCount) + 2 : 0);
+    }
+};
+
+// ļĩβдһļ¼֮׷ӵļ¼ʱȰļػһ¼֮
+// 𻵳ļм䣨֮ݣʱļֱӱ
+inline ReplayWriter::ReplayWriter(const std::string& filePath) : path(filePath) {
+    bool empty = true;
+    {
+        std::ifstream existing(path, std::ios::binary | std::ios::ate);
+        if (existing.is_open() && existing.tellg() > 0) {
+            empty = false;
+            char header[sizeof(REPLAY_FILE_HEADER)] = {};
+            uint32_t version = 0;
+            existing.seekg(0, std::ios::beg);
+            existing.read(header, sizeof(header));
+            existing.read(reinterpret_cast<char*>(&version), sizeof(version));
+            if (existing.fail() || memcmp(header, REPLAY_FILE_HEADER, sizeof(header)) != 0 ||
+                version != REPLAY_FILE_VERSION) {
+                throw std::runtime_error("not a replay journal: " + path);
+            }
+        }
+    }
+
+    if (!empty) {
+        size_t validEnd = 0;
+        size_t size = 0;
+        {
+            ReplayReader reader(path);
+            ReplayView view;
+            try {
+                while (reader.Next(view)) {
+                }
+            }
+            catch (const std::exception& e) {
+                if (!reader.IsTornTail()) {
+                    throw std::runtime_error(path + ": " + e.what() + " at offset " +
+                        std::to_string(reader.GetOffset()) + ", not appending");
+                }
+            }
+            validEnd = reader.GetOffset();
+            size = reader.GetSize();
+        }
+        if (validEnd < size) {
+            std::error_code error;
+            std::filesystem::resize_file(path, validEnd, error);
+            if (error) {
+                throw std::runtime_error("cannot truncate " + path + ": " + error.message());
+            }
+            discardedBytes = size - validEnd;
+        }
+    }
+
+    file.open(path, std::ios::binary | std::ios::app);
+    if (!file.is_open()) {
+        throw std::runtime_error("cannot open " + path);
+    }
+
+    buffer.reserve(FLUSH_THRESHOLD * 2);
+    if (empty) {
+        Write(REPLAY_FILE_HEADER, sizeof(REPLAY_FILE_HEADER));
+        Write(&REPLAY_FILE_VERSION, sizeof(REPLAY_FILE_VERSION));
+    }
+}
+
+// ü¼Ӻͷһ֣ÿϷɼ¼һ£Լ̡״̬
+class ReplayVerifier {
+public:
+    static bool Verify(const ReplayView& view, std::string* error = nullptr) {
+        GameEngine game(view.header.seed);
+        game.NewGame();
+
+        const uint8_t* spawn = view.spawns;
+        if (spawn && game.GetBoard() != (SpawnBoard(spawn[0]) | SpawnBoard(spawn[1]))) {
+            return Fail(error, "initial spawn mismatch");
+        }
+
+        for (uint32_t i = 0; i < view.header.moveCount; i++) {
+            if (!game.Move(view.GetMove(i))) {
+                return Fail(error, "illegal move " + std::to_string(i));
+            }
+
+            Board before = game.GetBoard();
+            game.AddRandomTile();
+            if (spawn && (game.GetBoard() ^ before) != SpawnBoard(spawn[i + 2])) {
+                return Fail(error, "spawn mismatch after move " + std::to_string(i));
+            }
+        }
+        game.CheckGameOver();
+
+        if (game.GetBoard() != view.header.finalBoard) {
+            return Fail(error, "final board mismatch");
+        }
+        if (static_cast<uint32_t>(game.GetScore()) != view.header.finalScore) {
+            return Fail(error, "final score mismatch");
+        }
+        if (game.IsGameOver() != ((view.header.flags & REPLAY_FLAG_GAME_OVER) != 0) ||
+            game.IsWon() != ((view.header.flags & REPLAY_FLAG_WON) != 0)) {
+            return Fail(error, "final state flags mismatch");
+        }
+        return true;
+    }
+
+private:
+    static Board SpawnBoard(uint8_t record) {
+        return Board(record >> 4) << ((record & 0xF) * 4);
+    }
+
+    static bool Fail(std::string* error, const std::string& message) {
+        if (error) *error = message;
+        return false;
+    }
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Crc32c.h"
+#include "GameEngine.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+const uint32_t SAVE_FILE_VERSION_1 = 1;     // ̼λۼУͣԿɶȡ
+const uint32_t SAVE_FILE_VERSION_2 = 2;     // ̼ CRC32C
+const uint32_t SAVE_FILE_VERSION = SAVE_FILE_VERSION_2;
+const char SAVE_FILE_HEADER[9] = "2048SAVE";
+
+const uint8_t SAVE_FLAG_GAME_OVER = 1;
+const uint8_t SAVE_FLAG_WON = 2;
+
+// Ϸ״̬ṹ汾 1
+#pragma pack(push, 1)
+struct GameState {
+    int board[BOARD_SIZE][BOARD_SIZE];
+    int score;
+    bool gameOver;
+    bool won;
+    uint32_t checksum;
+};
+#pragma pack(pop)
+
+// 汾 2 Ϸ״̬̰ 4 λָ 17 ֽ
+#pragma pack(push, 1)
+struct PackedGameState {
+    uint64_t board;
+    uint32_t score;
+    uint8_t flags;
+    uint32_t checksum;  // CRC32Cǰֶ
+};
+#pragma pack(pop)
+
+// 浵ʽĿաУϷԼ飬ƽ̨޹أ GUI ֮͸
+class SaveFormat {
+public:
+    static GameState CreateSnapshot(const GameEngine& engine) {
+        GameState snapshot;
+        memset(&snapshot, 0, sizeof(snapshot));
+        BitBoard::ToGrid(engine.GetBoard(), snapshot.board);
+        snapshot.score = engine.GetScore();
+        snapshot.gameOver = engine.IsGameOver();
+        snapshot.won = engine.IsWon();
+        return snapshot;
+    }
+
+    static PackedGameState CreatePackedSnapshot(const GameEngine& engine) {
+        PackedGameState snapshot = {};
+        snapshot.board = engine.GetBoard();
+        snapshot.score = static_cast<uint32_t>(engine.GetScore());
+        snapshot.flags = (engine.IsGameOver() ? SAVE_FLAG_GAME_OVER : 0) | (engine.IsWon() ? SAVE_FLAG_WON : 0);
+        snapshot.checksum = CalculateCrc(snapshot);
+        return snapshot;
+    }
+
+    static uint32_t CalculateCrc(const PackedGameState& gameState) {
+        return Crc32c::Compute(&gameState, offsetof(PackedGameState, checksum));
+    }
+
+    // ̵ÿһǺϷָֻͱ־λ
+    static bool ValidatePackedState(const PackedGameState& gameState) {
+        return gameState.score <= static_cast<uint32_t>(INT32_MAX) &&
+            (gameState.flags & ~(SAVE_FLAG_GAME_OVER | SAVE_FLAG_WON)) == 0;
+    }
+
+    static void ApplyPackedState(const PackedGameState& gameState, GameEngine& engine) {
+        engine.SetState(gameState.board, static_cast<int>(gameState.score),
+            (gameState.flags & SAVE_FLAG_GAME_OVER) != 0, (gameState.flags & SAVE_FLAG_WON) != 0);
+    }
+
+    // 汾 1 ״̬ͨУ ValidateGameState 
+    static PackedGameState UpgradeState(const GameState& gameState) {
+        PackedGameState packed = {};
+        packed.board = BitBoard::FromGrid(gameState.board);
+        packed.score = static_cast<uint32_t>(gameState.score);
+        packed.flags = (gameState.gameOver ? SAVE_FLAG_GAME_OVER : 0) | (gameState.won ? SAVE_FLAG_WON : 0);
+        packed.checksum = CalculateCrc(packed);
+        return packed;
+    }
+
+    static uint32_t CalculateChecksum(const GameState& gameState) {
+        uint32_t checksum = 0;
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(&gameState);
+        size_t dataSize = sizeof(gameState) - sizeof(gameState.checksum);
+
+        for (size_t i = 0; i < dataSize; ++i) {
+            checksum = (checksum << 5) + checksum + data[i];
+        }
+
+        return checksum;
+    }
+
+    static bool IsValidTileValue(int value) {
+        if (value == 0) return true;
+        if (value < 0 || value > (1 << MAX_TILE_EXPONENT)) return false;
+        return (value & (value - 1)) == 0;
+    }
+
+    static bool ValidateGameState(const GameState& gameState) {
+        if (gameState.score < 0) {
+            return false;
+        }
+
+        for (int i = 0; i < BOARD_SIZE; i++) {
+            for (int j = 0; j < BOARD_SIZE; j++) {
+                if (!IsValidTileValue(gameState.board[i][j])) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+};
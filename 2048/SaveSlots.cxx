@@ -0,0 +1,181 @@
+// λ浵ı飨Linuxcrash ӽд롢ɾ㲢Ͼ͵²룬ʱɱ
+// ´򿪺ÿύļ㶼ԭɾļûи
+// 룺g++ -std=c++20 -O2 -DNDEBUG -pthread SaveSlots.cxx -o saveslots
+
+#include "SaveSlots.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+struct SaveSlotsOptions {
+    uint64_t seed = 2048;
+    uint32_t keys = 20000;      // ύ󱣳ֲ䡢´ʱļÿ 3 ɾ 1 
+    uint32_t churn = 4000;      // ӽ̷дɾļԶ²룻0 ʾֻ Rehash
+    int rounds = 200;
+};
+
+// ÿӦļӺͼ̾ݴ˺˶
+static PackedGameState StateFor(uint64_t seed, uint64_t key) {
+    PackedGameState state = {};
+    state.board = SplitMix64(seed ^ key);
+    state.score = static_cast<uint32_t>(SplitMix64(state.board));
+    state.flags = static_cast<uint8_t>(key & 3);
+    state.checksum = SaveFormat::CalculateCrc(state);
+    return state;
+}
+
+static bool SameState(const PackedGameState& a, const PackedGameState& b) {
+    return a.board == b.board && a.score == b.score && a.flags == b.flags;
+}
+
+static bool IsErased(uint64_t key) {
+    return key % 3 == 2;
+}
+
+// ӽ̣дȫɾ֮һֻ֪̣֮ͨдɾһ²룬ֱɱ
+[[noreturn]] static void RunWriter(const std::string& path, const SaveSlotsOptions& options, int ready) {
+    SaveSlots slots(path, (options.keys + options.churn) * 2);
+    for (uint64_t key = 0; key < options.keys; key++) {
+        slots.Store(key, StateFor(options.seed, key));
+    }
+    for (uint64_t key = 0; key < options.keys; key++) {
+        if (IsErased(key)) slots.Erase(key);
+    }
+    char byte = 1;
+    if (write(ready, &byte, 1) != 1) _exit(1);
+
+    while (true) {
+        for (uint64_t key = options.keys; key < options.keys + options.churn; key++) {
+            slots.Store(key, StateFor(options.seed, key));
+        }
+        for (uint64_t key = options.keys; key < options.keys + options.churn; key++) {
+            slots.Erase(key);
+        }
+        slots.Rehash();
+    }
+}
+
+static int RunCrash(const std::string& path, const SaveSlotsOptions& options) {
+    GameRandom random(options.seed);
+    int recovered = 0;
+    int intact = 0;
+    int corrupt = 0;
+    for (int round = 0; round < options.rounds; round++) {
+        std::remove(path.c_str());
+        int pipes[2];
+        if (pipe(pipes) != 0) {
+            throw std::runtime_error("pipe failed");
+        }
+
+        pid_t child = fork();
+        if (child < 0) {
+            throw std::runtime_error("fork failed");
+        }
+        if (child == 0) {
+            close(pipes[0]);
+            try {
+                RunWriter(path, options, pipes[1]);
+            }
+            catch (const std::exception& e) {
+                fprintf(stderr, "writer failed: %s\n", e.what());
+            }
+            _exit(1);
+        }
+
+        close(pipes[1]);
+        char byte = 0;
+        bool ready = read(pipes[0], &byte, 1) == 1;
+        close(pipes[0]);
+        if (ready) {
+            usleep(static_cast<useconds_t>(random.Next() % 20000));
+        }
+        kill(child, SIGKILL);
+        waitpid(child, nullptr, 0);
+        if (!ready) {
+            throw std::runtime_error("writer exited before committing its checkpoints");
+        }
+
+        // ύļԭɾļܸдɾļҲԲڣʱݱȷ
+        bool ok = true;
+        try {
+            SaveSlots slots(path, 0);
+            if (slots.WasRecovered()) recovered++;
+            uint32_t present = 0;
+            for (uint64_t key = 0; key < options.keys + options.churn; key++) {
+                PackedGameState state;
+                bool found = slots.Load(key, state);
+                present += found;
+                if (found && !SameState(state, StateFor(options.seed, key))) ok = false;
+                if (key < options.keys && found == IsErased(key)) ok = false;
+            }
+            if (present != slots.GetCount()) ok = false;
+        }
+        catch (const std::exception& e) {
+            fprintf(stderr, "round %d: %s\n", round, e.what());
+            ok = false;
+        }
+        if (ok) intact++;
+        else corrupt++;
+    }
+    std::remove(path.c_str());
+
+    printf("rounds      : %d (%d killed in the middle of %s)\n", options.rounds, recovered,
+        options.churn ? "a store, erase or rehash" : "a rehash");
+    printf("result      : %d intact, %d lost or corrupt checkpoints\n", intact, corrupt);
+    return corrupt ? 2 : 0;
+}
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "usage: %s crash FILE [--rounds N] [--keys N] [--churn N] [--seed N]\n", program);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::string command = argv[1];
+    SaveSlotsOptions options;
+    for (int i = 3; i < argc; i += 2) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        if (strcmp(arg, "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--keys") == 0) options.keys = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if (strcmp(arg, "--churn") == 0) options.churn = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if (strcmp(arg, "--rounds") == 0) options.rounds = atoi(value);
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.keys == 0 || options.keys > (1u << 24) || options.churn > (1u << 24) ||
+        options.rounds <= 0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        if (command == "crash") return RunCrash(argv[2], options);
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "saveslots failed: %s\n", e.what());
+        return 1;
+    }
+
+    PrintUsage(argv[0]);
+    return 1;
+}
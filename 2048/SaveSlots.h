@@ -0,0 +1,341 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "Random.h"
+#include "SaveFormat.h"
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+const char SAVE_SLOT_FILE_HEADER[8] = { '2', '0', '4', '8', 'S', 'L', 'O', 'T' };
+const uint32_t SAVE_SLOT_FILE_VERSION = SAVE_FILE_VERSION_2;
+
+// λ浵ļһڴӳļб 64 λļ㡣
+// λ鱾ǿѰַĹϣ̽⣩ҡд롢ɾΪ O(1)
+// ÿλ 32 ֽڲԼ CRC32CڴʱȷɾµĹòλһ 7/8 ĸޣ
+// Ĺ 1/8 дʱﵽޣ͵²ȫĹ̽Ȳ淴дɾ
+class SaveSlots {
+private:
+#pragma pack(push, 1)
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t capacity;  // λ2 
+        uint32_t count;     // òλ
+        uint32_t tombstones;    // Ĺ
+        uint32_t dirty;         //  0 ʾ޸;˳ʱУͿܻδ£ʱ²ȫ¼
+        uint32_t reserved[8];
+        uint32_t checksum;  // CRC32Cǰֶ
+    };
+
+    struct Slot {
+        uint64_t key;
+        uint64_t board;
+        uint32_t score;
+        uint8_t state;
+        uint8_t flags;
+        uint16_t reserved;
+        uint32_t checksum;  // CRC32Cǰ 24 ֽ
+        uint32_t padding;
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(FileHeader) == 64 && sizeof(Slot) == 32, "save slot layout changed");
+
+    static const uint8_t SLOT_EMPTY = 0;
+    static const uint8_t SLOT_USED = 1;
+    static const uint8_t SLOT_DELETED = 2;
+    static const uint8_t SLOT_PENDING = 3;  // ֻ²ڼ
+    static const uint32_t NOT_FOUND = UINT32_MAX;
+
+    MappedFile file;
+    FileHeader* header;
+    Slot* slots;
+    uint32_t mask;
+    bool recovered;
+
+public:
+    // ļʱ capacityȡ 2 ݣѴʱ capacity ļ
+    SaveSlots(const std::string& path, uint32_t capacity)
+        : file(path, MappedFile::Access::ReadWrite, InitialSize(path, capacity)),
+        header(nullptr), slots(nullptr), mask(0), recovered(false) {
+        if (file.GetSize() < sizeof(FileHeader)) {
+            throw std::runtime_error("not a save slot file: " + path);
+        }
+
+        uint8_t* data = file.GetMutableData();
+        header = reinterpret_cast<FileHeader*>(data);
+        slots = reinterpret_cast<Slot*>(data + sizeof(FileHeader));
+
+        bool fresh = header->version == 0 && memcmp(header->magic, "\0\0\0\0\0\0\0\0", 8) == 0;
+        if (fresh) {
+            memcpy(header->magic, SAVE_SLOT_FILE_HEADER, sizeof(header->magic));
+            header->version = SAVE_SLOT_FILE_VERSION;
+            header->capacity = RoundCapacity(capacity);
+            header->count = 0;
+            header->checksum = HeaderChecksum();
+        }
+
+        if (memcmp(header->magic, SAVE_SLOT_FILE_HEADER, sizeof(header->magic)) != 0) {
+            throw std::runtime_error("not a save slot file: " + path);
+        }
+        if (header->version != SAVE_SLOT_FILE_VERSION) {
+            throw std::runtime_error("unsupported save slot file version");
+        }
+        if ((!header->dirty && header->checksum != HeaderChecksum()) || !std::has_single_bit(header->capacity) ||
+            file.GetSize() < RequiredSize(header->capacity)) {
+            throw std::runtime_error("corrupt save slot file header");
+        }
+        mask = header->capacity - 1;
+        if (header->dirty) {
+            Rehash();
+            recovered = true;
+        }
+    }
+
+    static size_t RequiredSize(uint32_t capacity) {
+        return sizeof(FileHeader) + static_cast<size_t>(capacity) * sizeof(Slot);
+    }
+
+    static uint32_t RoundCapacity(uint32_t capacity) {
+        return std::bit_ceil(capacity < 16 ? 16u : capacity);
+    }
+
+    uint32_t GetCount() const { return header->count; }
+    uint32_t GetCapacity() const { return header->capacity; }
+    uint32_t GetTombstones() const { return header->tombstones; }
+
+    // ʱǷ޸ϴ;˳޸
+    bool WasRecovered() const { return recovered; }
+
+    // д򸲸һ㣻òλ 7/8 ʱ׳쳣¼дűΪãеļʱ͵ظд
+    void Store(uint64_t key, const PackedGameState& state) {
+        uint32_t insert = NOT_FOUND;
+        uint32_t index = Find(key, &insert);
+        bool reuse = false;
+        if (index == NOT_FOUND) {
+            // ĹӸأռÿղλʱòλĹܳޣĹ
+            reuse = insert != NOT_FOUND && slots[insert].state == SLOT_DELETED;
+            if (!reuse && header->count + header->tombstones + 1 > LoadLimit() && header->tombstones > 0) {
+                Rehash();
+                Find(key, &insert);
+            }
+            if (insert == NOT_FOUND || (!reuse && header->count + header->tombstones + 1 > LoadLimit())) {
+                throw std::runtime_error("save slot file is full");
+            }
+        }
+
+        Slot written = {};
+        written.key = key;
+        written.board = state.board;
+        written.score = state.score;
+        written.state = SLOT_USED;
+        written.flags = state.flags;
+        written.checksum = SlotChecksum(written);
+        if (index != NOT_FOUND) {
+            slots[index] = written;
+            return;
+        }
+
+        BeginUpdate();
+        written.state = slots[insert].state;
+        slots[insert] = written;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        slots[insert].state = SLOT_USED;
+        header->count++;
+        if (reuse) header->tombstones--;
+        CommitHeader();
+    }
+
+    // Ҳ falseλУʧʱ׳쳣
+    bool Load(uint64_t key, PackedGameState& state) const {
+        uint32_t index = Find(key, nullptr);
+        if (index == NOT_FOUND) {
+            return false;
+        }
+
+        const Slot& slot = slots[index];
+        if (slot.checksum != SlotChecksum(slot)) {
+            throw std::runtime_error("corrupt save slot");
+        }
+
+        state.board = slot.board;
+        state.score = slot.score;
+        state.flags = slot.flags;
+        state.checksum = SaveFormat::CalculateCrc(state);
+        return true;
+    }
+
+    bool Contains(uint64_t key) const {
+        return Find(key, nullptr) != NOT_FOUND;
+    }
+
+    // ɾĹ֤̽ϿһλΪʱû̽ֱÿա
+    // Ĺɱд븴ã 1/8 ʱ͵²
+    bool Erase(uint64_t key) {
+        uint32_t index = Find(key, nullptr);
+        if (index == NOT_FOUND) {
+            return false;
+        }
+
+        BeginUpdate();
+        if (slots[(index + 1) & mask].state == SLOT_EMPTY) {
+            slots[index].state = SLOT_EMPTY;
+        }
+        else {
+            slots[index].state = SLOT_DELETED;
+            header->tombstones++;
+        }
+        header->count--;
+        CommitHeader();
+        if (header->tombstones > header->capacity / 8) {
+            Rehash();
+        }
+        return true;
+    }
+
+    // ͵²ȫĹĹΪգΪ룬Ѵŵ̽ϵһòλ
+    // ĿλһʱȰƵһղλٸǣȻŷÿһдλλã
+    // κʱ̱ɱÿһٻһĸʱѷźõظ
+    void Rehash() {
+        BeginUpdate();
+        for (uint32_t i = 0; i <= mask; i++) {
+            uint8_t state = slots[i].state;
+            slots[i].state = state == SLOT_USED || state == SLOT_PENDING ? SLOT_PENDING : SLOT_EMPTY;
+        }
+
+        for (uint32_t i = 0; i <= mask; i++) {
+            uint32_t current = i;
+            while (slots[current].state == SLOT_PENDING) {
+                uint64_t key = slots[current].key;
+                uint32_t index = Home(key);
+                while (slots[index].state == SLOT_USED && slots[index].key != key) {
+                    index = (index + 1) & mask;
+                }
+                if (slots[index].state == SLOT_USED) {
+                    // ϴ;˳µĸһѾź
+                    slots[current].state = SLOT_EMPTY;
+                    break;
+                }
+                if (index == current) {
+                    slots[current].state = SLOT_USED;
+                    break;
+                }
+
+                uint32_t next = current;
+                if (slots[index].state == SLOT_PENDING) {
+                    next = FindEmpty(index);
+                    CopySlot(index, next, SLOT_PENDING);
+                }
+                CopySlot(current, index, SLOT_USED);
+                slots[current].state = SLOT_EMPTY;
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                current = next;
+            }
+        }
+
+        uint32_t used = 0;
+        for (uint32_t i = 0; i <= mask; i++) {
+            used += slots[i].state == SLOT_USED;
+        }
+        header->count = used;
+        header->tombstones = 0;
+        CommitHeader();
+    }
+
+    void Flush() {
+        file.Flush();
+    }
+
+private:
+    //  dirty Ϊ 0 㣬ύʱдУ־֮䱻ɱʱ־
+    uint32_t HeaderChecksum() const {
+        FileHeader copy = *header;
+        copy.dirty = 0;
+        return Crc32c::Compute(&copy, offsetof(FileHeader, checksum));
+    }
+
+    // ޸Ĳλ״̬ǰλ dirtyдУ;ɱʱļ²벢¼
+    void BeginUpdate() {
+        header->dirty = 1;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    void CommitHeader() {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        header->checksum = HeaderChecksum();
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        header->dirty = 0;
+    }
+
+    //  start ֮һղλز 7/8ҵ
+    uint32_t FindEmpty(uint32_t start) const {
+        uint32_t index = (start + 1) & mask;
+        while (slots[index].state != SLOT_EMPTY) {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    // ȰĿÿдݣд״̬;ɱʱĿ겻ǰλ
+    void CopySlot(uint32_t from, uint32_t to, uint8_t state) {
+        slots[to].state = SLOT_EMPTY;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        Slot copy = slots[from];
+        copy.state = SLOT_EMPTY;
+        slots[to] = copy;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        slots[to].state = state;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    uint32_t LoadLimit() const {
+        return header->capacity / 8 * 7;
+    }
+
+    uint32_t Home(uint64_t key) const {
+        return static_cast<uint32_t>(SplitMix64(key)) & mask;
+    }
+
+    static uint32_t SlotChecksum(const Slot& slot) {
+        return Crc32c::Compute(&slot, offsetof(Slot, checksum));
+    }
+
+    // ѴڵļԭСӳ䣬ֻļŰչ
+    static size_t InitialSize(const std::string& path, uint32_t capacity) {
+        std::ifstream existing(path, std::ios::binary | std::ios::ate);
+        if (existing.is_open() && existing.tellg() > 0) {
+            return 0;
+        }
+        return RequiredSize(RoundCapacity(capacity));
+    }
+
+    // ؼڵĲλţδҵʱ insertǿʱΪдĵһղλĹ
+    uint32_t Find(uint64_t key, uint32_t* insert) const {
+        uint32_t available = NOT_FOUND;
+        uint32_t start = Home(key);
+        for (uint32_t probe = 0; probe <= mask; probe++) {
+            uint32_t index = (start + probe) & mask;
+            const Slot& slot = slots[index];
+            if (slot.state == SLOT_EMPTY) {
+                if (available == NOT_FOUND) available = index;
+                break;
+            }
+            if (slot.state == SLOT_DELETED) {
+                if (available == NOT_FOUND) available = index;
+                continue;
+            }
+            if (slot.key == key) {
+                return index;
+            }
+        }
+
+        if (insert) *insert = available;
+        return NOT_FOUND;
+    }
+};
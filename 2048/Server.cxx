@@ -0,0 +1,673 @@
+// ỰԾַLinuxÿ CPU һ epoll ¼ѭ̣߳ TCP  Unix ׽
+//  GameServer.h еĶ󣬻ظµload Ǳѹͻˣºӳٷλ
+// 룺g++ -std=c++20 -O2 -DNDEBUG -pthread Server.cxx -o server
+
+#include "GameServer.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+const size_t READ_CHUNK = 64 * 1024;
+const size_t MAX_PENDING_OUTPUT = 1 << 20;  // ȵȶԶ˶ٴ
+const int MAX_EVENTS = 256;
+
+struct ServerOptions {
+    std::string address = "tcp:127.0.0.1:2048";     // tcp:HOST:PORT  unix:PATH
+    int threads = 0;            // 0 ʾÿӲ߳һ¼ѭ
+    size_t sessions = 1000000;  // Ựޣƽָ¼ѭ
+    uint64_t seed = 2048;
+    std::string snapshot;       // ǿʱǰ PREFIX.N ָ N ¼ѭĻỰ˳ʱд
+    // ѹ
+    int connections = 64;
+    int pipeline = 8;           // ÿͬʱ;
+    double seconds = 5.0;
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void HandleSignal(int) {
+    stopRequested = 1;
+}
+
+// ׽ֵַtcp:HOST:PORT  unix:PATH
+struct SocketAddress {
+    sockaddr_storage storage = {};
+    socklen_t length = 0;
+    bool unixSocket = false;
+    std::string path;
+};
+
+static SocketAddress ParseAddress(const std::string& text) {
+    SocketAddress address;
+    if (text.rfind("unix:", 0) == 0) {
+        address.unixSocket = true;
+        address.path = text.substr(5);
+        sockaddr_un* local = reinterpret_cast<sockaddr_un*>(&address.storage);
+        if (address.path.empty() || address.path.size() >= sizeof(local->sun_path)) {
+            throw std::runtime_error("bad unix socket path " + address.path);
+        }
+        local->sun_family = AF_UNIX;
+        memcpy(local->sun_path, address.path.c_str(), address.path.size() + 1);
+        address.length = sizeof(sockaddr_un);
+        return address;
+    }
+
+    size_t colon = text.rfind(':');
+    if (text.rfind("tcp:", 0) != 0 || colon <= 4) {
+        throw std::runtime_error("bad address " + text + " (expected tcp:HOST:PORT or unix:PATH)");
+    }
+    sockaddr_in* inet = reinterpret_cast<sockaddr_in*>(&address.storage);
+    inet->sin_family = AF_INET;
+    inet->sin_port = htons(static_cast<uint16_t>(atoi(text.c_str() + colon + 1)));
+    if (inet_pton(AF_INET, text.substr(4, colon - 4).c_str(), &inet->sin_addr) != 1) {
+        throw std::runtime_error("bad IPv4 address in " + text);
+    }
+    address.length = sizeof(sockaddr_in);
+    return address;
+}
+
+static void SetNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+        throw std::runtime_error("cannot make socket non-blocking");
+    }
+}
+
+static void SetNoDelay(int fd, const SocketAddress& address) {
+    if (!address.unixSocket) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+}
+
+// ѵǰ̰߳󶨵һ CPU ϣCPU ʱ
+static void PinThread(int index) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0 || index >= CPU_COUNT(&set)) return;
+
+    int seen = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &set)) continue;
+        if (seen++ == index) {
+            cpu_set_t one;
+            CPU_ZERO(&one);
+            CPU_SET(cpu, &one);
+            pthread_setaffinity_np(pthread_self(), sizeof(one), &one);
+            return;
+        }
+    }
+}
+
+// ӵշ壺δĲִ inputStart ʼδ͵Ĳִ outputStart ʼ
+struct Connection {
+    int fd = -1;
+    std::vector<uint8_t> input;
+    size_t inputStart = 0;
+    std::vector<uint8_t> output;
+    size_t outputStart = 0;
+
+    size_t PendingOutput() const { return output.size() - outputStart; }
+
+    // ͵ EAGAIN Ϊֹӳʱ false
+    bool Flush() {
+        while (outputStart < output.size()) {
+            ssize_t sent = send(fd, output.data() + outputStart, output.size() - outputStart, MSG_NOSIGNAL);
+            if (sent > 0) {
+                outputStart += static_cast<size_t>(sent);
+            }
+            else if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            else {
+                return sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            }
+        }
+        output.clear();
+        outputStart = 0;
+        return true;
+    }
+
+    // һΣ READ_CHUNK ֽڣdrained ʾѶ EAGAINԶ˹رջʱ false
+    bool Fill(bool& drained) {
+        uint8_t buffer[READ_CHUNK];
+        drained = false;
+        ssize_t count;
+        do {
+            count = recv(fd, buffer, sizeof(buffer), 0);
+        } while (count < 0 && errno == EINTR);
+
+        if (count > 0) {
+            input.insert(input.end(), buffer, buffer + count);
+            return true;
+        }
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            drained = true;
+            return true;
+        }
+        return false;
+    }
+
+    void Compact() {
+        if (inputStart > 0) {
+            input.erase(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(inputStart));
+            inputStart = 0;
+        }
+    }
+};
+
+// һ¼ѭ̣߳Լ epollӺͻỰ׽ EPOLLEXCLUSIVE ÿѭ
+// ֻһ̣߳˺ӵȫɸ̴߳
+class EventLoop {
+private:
+    int epoll;
+    int listener;
+    uint8_t index;
+    std::vector<std::unique_ptr<GameSessionTable>>& tables;
+    std::vector<std::unique_ptr<Connection>> connections;   //  fd Ϊ±
+    uint64_t requests;
+    uint64_t accepted;
+
+public:
+    EventLoop(int listenFd, uint8_t loopIndex, std::vector<std::unique_ptr<GameSessionTable>>& sessionTables)
+        : epoll(epoll_create1(EPOLL_CLOEXEC)), listener(listenFd), index(loopIndex), tables(sessionTables),
+        requests(0), accepted(0) {
+        if (epoll < 0) {
+            throw std::runtime_error("epoll_create1 failed");
+        }
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        event.data.fd = listener;
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event) != 0) {
+            close(epoll);
+            throw std::runtime_error("cannot watch listening socket");
+        }
+    }
+
+    ~EventLoop() {
+        for (std::unique_ptr<Connection>& connection : connections) {
+            if (connection) close(connection->fd);
+        }
+        close(epoll);
+    }
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    uint64_t GetRequests() const { return requests; }
+    uint64_t GetAccepted() const { return accepted; }
+
+    void Run() {
+        epoll_event events[MAX_EVENTS];
+        while (!stopRequested) {
+            int count = epoll_wait(epoll, events, MAX_EVENTS, 200);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("epoll_wait failed");
+            }
+            for (int i = 0; i < count; i++) {
+                int fd = events[i].data.fd;
+                if (fd == listener) {
+                    Accept();
+                }
+                else if (!Serve(*connections[fd])) {
+                    Drop(fd);
+                }
+            }
+        }
+    }
+
+private:
+    void Accept() {
+        for (;;) {
+            int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                return;     // EAGAINѭѾȡߣʱû
+            }
+
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            if (connections.size() <= static_cast<size_t>(fd)) connections.resize(fd + 1);
+            connections[fd] = std::make_unique<Connection>();
+            connections[fd]->fd = fd;
+
+            // شServe Ƕд EAGAIN ѹΪֹ
+            epoll_event event = {};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            event.data.fd = fd;
+            if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+                Drop(fd);
+                continue;
+            }
+            accepted++;
+        }
+    }
+
+    void Drop(int fd) {
+        epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections[fd].reset();
+    }
+
+    //  false ʾӦر
+    bool Serve(Connection& connection) {
+        for (;;) {
+            if (!connection.Flush()) return false;
+            if (connection.PendingOutput() >= MAX_PENDING_OUTPUT) return true;     //  EPOLLOUT
+
+            bool drained = false;
+            if (!connection.Fill(drained)) return false;
+            Process(connection);
+            if (drained) return connection.Flush();
+        }
+    }
+
+    void Process(Connection& connection) {
+        size_t available = (connection.input.size() - connection.inputStart) / sizeof(GameRequest);
+        if (available == 0) return;
+
+        size_t base = connection.output.size();
+        connection.output.resize(base + available * sizeof(GameResponse));
+        for (size_t i = 0; i < available; i++) {
+            GameRequest request;
+            memcpy(&request, connection.input.data() + connection.inputStart + i * sizeof(GameRequest), sizeof(request));
+
+            // »Ựڱѭı󰴻Ự 8 λҵı
+            GameResponse response;
+            uint8_t tag = request.type == static_cast<uint8_t>(GameRequestType::NewGame)
+                ? index : GameSessionTable::TagOf(request.value);
+            if (tag < tables.size()) {
+                tables[tag]->Handle(request, response, tag);
+            }
+            else {
+                memset(&response, 0, sizeof(response));
+                response.type = request.type;
+                response.status = static_cast<uint8_t>(GameStatus::UnknownSession);
+                response.requestId = request.requestId;
+                response.session = request.value;
+            }
+            memcpy(connection.output.data() + base + i * sizeof(GameResponse), &response, sizeof(response));
+        }
+        connection.inputStart += available * sizeof(GameRequest);
+        connection.Compact();
+        requests += available;
+    }
+};
+
+static int Listen(const SocketAddress& address) {
+    int fd = socket(address.storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error("cannot create socket");
+    }
+    if (address.unixSocket) {
+        unlink(address.path.c_str());
+    }
+    else {
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address.storage), address.length) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        throw std::runtime_error("cannot listen on address: " + std::string(strerror(errno)));
+    }
+    return fd;
+}
+
+static int RunServer(const ServerOptions& options) {
+    SocketAddress address = ParseAddress(options.address);
+    int listener = Listen(address);
+
+    int threads = (std::min)(options.threads, 255);
+    std::vector<std::unique_ptr<GameSessionTable>> tables;
+    std::vector<std::unique_ptr<EventLoop>> loops;
+    for (int i = 0; i < threads; i++) {
+        tables.push_back(std::make_unique<GameSessionTable>(options.sessions / threads + 1,
+            SplitMix64(options.seed + static_cast<uint64_t>(i))));
+        // Ự¼ѭţԿհŷļ߳仯ȱٵļᱻȡ
+        std::string path = options.snapshot + "." + std::to_string(i);
+        if (!options.snapshot.empty() && std::filesystem::exists(path)) {
+            tables[i]->Load(path);
+            fprintf(stderr, "restored %zu sessions from %s\n", tables[i]->GetLiveCount(), path.c_str());
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        loops.push_back(std::make_unique<EventLoop>(listener, static_cast<uint8_t>(i), tables));
+    }
+    fprintf(stderr, "listening on %s with %d event loops\n", options.address.c_str(), threads);
+
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back([&, i]() {
+            PinThread(i);
+            try {
+                loops[i]->Run();
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+                stopRequested = 1;
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    uint64_t requests = 0;
+    uint64_t accepted = 0;
+    size_t sessions = 0;
+    size_t memory = 0;
+    for (int i = 0; i < threads; i++) {
+        requests += loops[i]->GetRequests();
+        accepted += loops[i]->GetAccepted();
+        sessions += tables[i]->GetLiveCount();
+        memory += tables[i]->GetMemoryBytes();
+    }
+    loops.clear();
+    close(listener);
+    if (address.unixSocket) unlink(address.path.c_str());
+
+    fprintf(stderr, "served      : %llu requests on %llu connections, %zu sessions still open (%.1f MB)\n",
+        static_cast<unsigned long long>(requests), static_cast<unsigned long long>(accepted), sessions,
+        memory / 1048576.0);
+    if (!options.snapshot.empty()) {
+        for (int i = 0; i < threads; i++) {
+            tables[i]->Save(options.snapshot + "." + std::to_string(i));
+        }
+        fprintf(stderr, "saved       : %s.0 .. %s.%d\n", options.snapshot.c_str(), options.snapshot.c_str(), threads - 1);
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return 0;
+}
+
+// ѹͻ˵һӣ̶;˳ظʱ䰴ȽȳӦ
+struct LoadConnection : Connection {
+    uint64_t session = 0;
+    bool over = false;
+    bool restarting = true;     // ȴ NewGame Ļظʱܷ Move
+    std::deque<std::chrono::steady_clock::time_point> sent;
+};
+
+struct LoadResult {
+    std::vector<float> latencies;   // ΢
+    uint64_t errors = 0;
+    uint64_t games = 0;
+};
+
+class LoadWorker {
+private:
+    const ServerOptions& options;
+    const SocketAddress& address;
+    int epoll;
+    std::vector<std::unique_ptr<LoadConnection>> connections;
+    GameRandom random;
+    uint32_t nextRequest;
+
+public:
+    LoadResult result;
+
+    LoadWorker(const ServerOptions& loadOptions, const SocketAddress& serverAddress, int connectionCount, uint64_t seed)
+        : options(loadOptions), address(serverAddress), epoll(epoll_create1(EPOLL_CLOEXEC)), random(seed), nextRequest(0) {
+        if (epoll < 0) {
+            throw std::runtime_error("epoll_create1 failed");
+        }
+        for (int i = 0; i < connectionCount; i++) {
+            auto connection = std::make_unique<LoadConnection>();
+            connection->fd = socket(address.storage.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (connection->fd < 0 ||
+                connect(connection->fd, reinterpret_cast<const sockaddr*>(&address.storage), address.length) != 0) {
+                if (connection->fd >= 0) close(connection->fd);
+                throw std::runtime_error("cannot connect to " + options.address + ": " + strerror(errno));
+            }
+            SetNonBlocking(connection->fd);
+            SetNoDelay(connection->fd, address);
+
+            epoll_event event = {};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            event.data.u32 = static_cast<uint32_t>(i);
+            epoll_ctl(epoll, EPOLL_CTL_ADD, connection->fd, &event);
+            connections.push_back(std::move(connection));
+        }
+    }
+
+    ~LoadWorker() {
+        for (std::unique_ptr<LoadConnection>& connection : connections) {
+            close(connection->fd);
+        }
+        close(epoll);
+    }
+
+    LoadWorker(const LoadWorker&) = delete;
+    LoadWorker& operator=(const LoadWorker&) = delete;
+
+    void Run(std::chrono::steady_clock::time_point deadline) {
+        for (std::unique_ptr<LoadConnection>& connection : connections) {
+            Send(*connection, GameRequestType::NewGame, 0, 0);
+            if (!connection->Flush()) throw std::runtime_error("connection lost");
+        }
+
+        epoll_event events[MAX_EVENTS];
+        while (!stopRequested && std::chrono::steady_clock::now() < deadline) {
+            int count = epoll_wait(epoll, events, MAX_EVENTS, 100);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("epoll_wait failed");
+            }
+            for (int i = 0; i < count; i++) {
+                LoadConnection& connection = *connections[events[i].data.u32];
+                bool drained = false;
+                while (!drained) {
+                    if (!connection.Fill(drained)) throw std::runtime_error("server closed the connection");
+                    Receive(connection);
+                }
+                if (!connection.Flush()) throw std::runtime_error("connection lost");
+            }
+        }
+    }
+
+private:
+    void Send(LoadConnection& connection, GameRequestType type, uint64_t value, uint8_t direction) {
+        GameRequest request = { static_cast<uint8_t>(type), direction, 0, nextRequest++, value };
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&request);
+        connection.output.insert(connection.output.end(), bytes, bytes + sizeof(request));
+        connection.sent.push_back(std::chrono::steady_clock::now());
+    }
+
+    void Receive(LoadConnection& connection) {
+        auto now = std::chrono::steady_clock::now();
+        while (connection.input.size() - connection.inputStart >= sizeof(GameResponse)) {
+            GameResponse response;
+            memcpy(&response, connection.input.data() + connection.inputStart, sizeof(response));
+            connection.inputStart += sizeof(response);
+
+            result.latencies.push_back(std::chrono::duration<float, std::micro>(now - connection.sent.front()).count());
+            connection.sent.pop_front();
+            if (response.status != static_cast<uint8_t>(GameStatus::Ok)) {
+                result.errors++;
+            }
+
+            GameRequestType type = static_cast<GameRequestType>(response.type);
+            if (type == GameRequestType::NewGame && response.status == static_cast<uint8_t>(GameStatus::Ok)) {
+                connection.session = response.session;
+                connection.over = false;
+                connection.restarting = false;
+                result.games++;
+            }
+            else if (type == GameRequestType::Move && response.session == connection.session &&
+                (response.flags & GAME_RESPONSE_GAME_OVER)) {
+                connection.over = true;
+            }
+        }
+        connection.Compact();
+
+        // ;󣺶ԾֽʱȹرվɻỰٿ¾֣ȵ»ỰŻټ
+        while (connection.sent.size() < static_cast<size_t>(options.pipeline) && !connection.restarting) {
+            if (connection.over) {
+                Send(connection, GameRequestType::Close, connection.session, 0);
+                Send(connection, GameRequestType::NewGame, 0, 0);
+                connection.restarting = true;
+            }
+            else {
+                Send(connection, GameRequestType::Move, connection.session, static_cast<uint8_t>(random.Next() & 3));
+            }
+        }
+    }
+};
+
+static double Percentile(std::vector<float>& samples, double fraction) {
+    if (samples.empty()) return 0.0;
+    size_t index = static_cast<size_t>(fraction * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+static int RunLoad(const ServerOptions& options) {
+    SocketAddress address = ParseAddress(options.address);
+    int threads = (std::min)(options.threads, options.connections);
+
+    std::vector<std::unique_ptr<LoadWorker>> workers;
+    for (int i = 0; i < threads; i++) {
+        int count = options.connections / threads + (i < options.connections % threads ? 1 : 0);
+        workers.push_back(std::make_unique<LoadWorker>(options, address, count, SplitMix64(options.seed + i)));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(options.seconds));
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; i++) {
+        pool.emplace_back([&, i]() {
+            try {
+                workers[i]->Run(deadline);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+                stopRequested = 1;
+            }
+        });
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<float> latencies;
+    uint64_t errors = 0;
+    uint64_t games = 0;
+    for (std::unique_ptr<LoadWorker>& worker : workers) {
+        latencies.insert(latencies.end(), worker->result.latencies.begin(), worker->result.latencies.end());
+        errors += worker->result.errors;
+        games += worker->result.games;
+    }
+
+    printf("load        : %d connections on %d threads, %d in flight each, %.2f s\n", options.connections, threads,
+        options.pipeline, seconds);
+    printf("requests    : %zu (%.0f/s), %llu games started, %llu errors\n", latencies.size(),
+        latencies.size() / seconds, static_cast<unsigned long long>(games), static_cast<unsigned long long>(errors));
+    double p50 = Percentile(latencies, 0.5);
+    double p99 = Percentile(latencies, 0.99);
+    double p999 = Percentile(latencies, 0.999);
+    double worst = latencies.empty() ? 0.0 : *std::max_element(latencies.begin(), latencies.end());
+    printf("latency     : p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n", p50, p99, p999, worst);
+    return errors ? 2 : 0;
+}
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "usage: %s serve [--listen ADDRESS] [--threads N] [--sessions N] [--seed N]\n", program);
+    fprintf(stderr, "             [--snapshot PREFIX]\n");
+    fprintf(stderr, "       %s load [--connect ADDRESS] [--threads N] [--connections N] [--pipeline N] [--seconds X]\n", program);
+    fprintf(stderr, "ADDRESS is tcp:HOST:PORT (default tcp:127.0.0.1:2048) or unix:PATH\n");
+}
+
+int main(int argc, char** argv) {
+    ServerOptions options;
+    bool serve = argc >= 2 && strcmp(argv[1], "serve") == 0;
+    bool load = argc >= 2 && strcmp(argv[1], "load") == 0;
+    if (!serve && !load) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    for (int i = 2; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        if (strcmp(arg, serve ? "--listen" : "--connect") == 0) options.address = value;
+        else if (strcmp(arg, "--threads") == 0) options.threads = atoi(value);
+        else if (strcmp(arg, "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+        else if (serve && strcmp(arg, "--sessions") == 0) options.sessions = strtoull(value, nullptr, 10);
+        else if (serve && strcmp(arg, "--snapshot") == 0) options.snapshot = value;
+        else if (load && strcmp(arg, "--connections") == 0) options.connections = atoi(value);
+        else if (load && strcmp(arg, "--pipeline") == 0) options.pipeline = atoi(value);
+        else if (load && strcmp(arg, "--seconds") == 0) options.seconds = atof(value);
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    if (options.threads <= 0) {
+        options.threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (options.threads <= 0) options.threads = 1;
+    }
+    if (options.sessions == 0 || options.connections <= 0 || options.pipeline <= 0 || options.seconds <= 0.0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    struct sigaction action = {};
+    action.sa_handler = HandleSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    try {
+        return serve ? RunServer(options) : RunLoad(options);
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "%s failed: %s\n", argv[1], e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,270 @@
+#pragma once
+
+#include "Crc32c.h"
+#include "GameEngine.h"
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ԾֵĽմ洢ÿֻռ 24 ֽڣ̡SplitMix64 ״̬־
+// ÿ 65536 ֵĶ䣬һͲƶ << 32 | ţڶԾִڼһֱЧ
+// رյĲλɿãһʹɾʧЧ̰߳ȫģ߳ʱÿ߳һ洢
+const char SESSION_FILE_HEADER[8] = { '2', '0', '4', '8', 'S', 'E', 'S', 'S' };
+const uint32_t SESSION_FILE_VERSION = 1;
+
+const uint32_t SESSION_LIVE = 1;
+const uint32_t SESSION_GAME_OVER = 2;
+const uint32_t SESSION_WON = 4;
+const uint32_t SESSION_FLAG_BITS = 8;   // state  8 λΪ־ 24 λΪ
+const uint32_t SESSION_NO_SLOT = UINT32_MAX;
+
+#pragma pack(push, 1)
+// вλ board ſһλ
+struct SessionRecord {
+    uint64_t board;
+    uint64_t random;    // SplitMix64 ļ״̬8 ֽڼɶÿֵ
+    uint32_t score;
+    uint32_t state;
+};
+
+struct SessionFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t records;       // ʹùĲλвλд
+    uint64_t liveCount;
+    uint32_t freeHead;
+    uint32_t recordsChecksum;   // CRC32Cȫλ
+    uint32_t reserved[5];
+    uint32_t checksum;      // CRC32Cǰֶ
+};
+#pragma pack(pop)
+
+static_assert(sizeof(SessionRecord) == 24 && sizeof(SessionFileHeader) == 64, "session layout changed");
+
+class SessionStore {
+public:
+    typedef uint64_t Handle;
+
+    static constexpr uint32_t SLAB_BITS = 16;
+    static constexpr uint32_t SLAB_SIZE = 1u << SLAB_BITS;
+    static constexpr uint64_t HANDLE_BITS = 56;     // ֻ 24 λ 8 λ
+
+    using Layout = GameEngine::Layout;
+
+private:
+    std::vector<std::unique_ptr<SessionRecord[]>> slabs;
+    uint32_t records;
+    uint32_t freeHead;
+    size_t liveCount;
+
+public:
+    SessionStore() : records(0), freeHead(SESSION_NO_SLOT), liveCount(0) {
+    }
+
+    SessionStore(const SessionStore&) = delete;
+    SessionStore& operator=(const SessionStore&) = delete;
+
+    size_t GetLiveCount() const { return liveCount; }
+    size_t GetSlotCount() const { return records; }
+    size_t GetMemoryBytes() const { return slabs.size() * SLAB_SIZE * sizeof(SessionRecord); }
+
+    static uint32_t SlotOf(Handle handle) { return static_cast<uint32_t>(handle); }
+
+    // һϷ GameEngine::NewGame ͬ
+    Handle Create(uint64_t seed) {
+        uint32_t slot;
+        if (freeHead != SESSION_NO_SLOT) {
+            slot = freeHead;
+            freeHead = static_cast<uint32_t>(At(slot).board);
+        }
+        else {
+            if (records == SESSION_NO_SLOT) {
+                throw std::runtime_error("session store is full");
+            }
+            if ((records >> SLAB_BITS) >= slabs.size()) {
+                slabs.push_back(std::make_unique<SessionRecord[]>(SLAB_SIZE));
+            }
+            slot = records++;
+            At(slot).state = 0;
+        }
+
+        SessionRecord& record = At(slot);
+        record.board = 0;
+        record.random = seed;
+        record.score = 0;
+        record.state = (record.state & ~((1u << SESSION_FLAG_BITS) - 1)) | SESSION_LIVE;
+        AddRandomTile(record);
+        AddRandomTile(record);
+        liveCount++;
+        return MakeHandle(slot, record.state >> SESSION_FLAG_BITS);
+    }
+
+    // Чδ䡢ѹرջλѱãʱ nullptr
+    const SessionRecord* Find(Handle handle) const {
+        uint32_t slot = SlotOf(handle);
+        if (slot >= records) return nullptr;
+        const SessionRecord& record = At(slot);
+        if (!(record.state & SESSION_LIVE) || (record.state >> SESSION_FLAG_BITS) != (handle >> 32)) return nullptr;
+        return &record;
+    }
+
+    //  GameEngine  MoveAddRandomTileCheckGameOver ˳ͬmoved ʾǷı
+    const SessionRecord* Move(Handle handle, Direction direction, bool& moved) {
+        moved = false;
+        SessionRecord* record = const_cast<SessionRecord*>(Find(handle));
+        if (record == nullptr || (record->state & SESSION_GAME_OVER)) return record;
+
+        MoveResult result = BitBoard::Move(record->board, direction);
+        if (!result.moved) return record;
+
+        moved = true;
+        record->board = result.board;
+        record->score += result.score;
+        if (result.maxMerged >= static_cast<uint32_t>(WIN_TILE_EXPONENT)) record->state |= SESSION_WON;
+        AddRandomTile(*record);
+        if (!BitBoard::CanMove(record->board)) record->state |= SESSION_GAME_OVER;
+        return record;
+    }
+
+    bool Close(Handle handle) {
+        if (Find(handle) == nullptr) return false;
+
+        uint32_t slot = SlotOf(handle);
+        SessionRecord& record = At(slot);
+        uint32_t generation = ((record.state >> SESSION_FLAG_BITS) + 1) & ((1u << (32 - SESSION_FLAG_BITS)) - 1);
+        record.state = generation << SESSION_FLAG_BITS;
+        record.board = freeHead;
+        freeHead = slot;
+        liveCount--;
+        return true;
+    }
+
+    // λ˳дĶԾ֣ÿڴ
+    template <typename Visit>
+    void ForEach(Visit visit) const {
+        for (uint32_t base = 0; base < records; base += SLAB_SIZE) {
+            const SessionRecord* slab = slabs[base >> SLAB_BITS].get();
+            uint32_t count = (std::min)(SLAB_SIZE, records - base);
+            for (uint32_t i = 0; i < count; i++) {
+                if (slab[i].state & SESSION_LIVE) {
+                    visit(MakeHandle(base + i, slab[i].state >> SESSION_FLAG_BITS), slab[i]);
+                }
+            }
+        }
+    }
+
+    // дȫλָ״̬䣻дʱļٸ
+    void Save(const std::string& path) const {
+        SessionFileHeader header = {};
+        memcpy(header.magic, SESSION_FILE_HEADER, sizeof(header.magic));
+        header.version = SESSION_FILE_VERSION;
+        header.recordSize = sizeof(SessionRecord);
+        header.records = records;
+        header.liveCount = liveCount;
+        header.freeHead = freeHead;
+        for (uint32_t base = 0; base < records; base += SLAB_SIZE) {
+            uint32_t count = (std::min)(SLAB_SIZE, records - base);
+            header.recordsChecksum = Crc32c::Compute(slabs[base >> SLAB_BITS].get(), count * sizeof(SessionRecord),
+                header.recordsChecksum);
+        }
+        header.checksum = Crc32c::Compute(&header, offsetof(SessionFileHeader, checksum));
+
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                throw std::runtime_error("cannot write " + temporary);
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (uint32_t base = 0; base < records; base += SLAB_SIZE) {
+                uint32_t count = (std::min)(SLAB_SIZE, records - base);
+                out.write(reinterpret_cast<const char*>(slabs[base >> SLAB_BITS].get()), count * sizeof(SessionRecord));
+            }
+            out.flush();
+            if (out.fail()) {
+                out.close();
+                std::remove(temporary.c_str());
+                throw std::runtime_error("failed writing " + temporary);
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("cannot replace " + path + ": " + error.message());
+        }
+    }
+
+    // ÿ滻ǰݣļʱ׳쳣ԭݲ
+    void Load(const std::string& path) {
+        MappedFile file(path);
+        SessionFileHeader header;
+        if (file.GetSize() < sizeof(header)) {
+            throw std::runtime_error("not a session snapshot: " + path);
+        }
+        memcpy(&header, file.GetData(), sizeof(header));
+        if (memcmp(header.magic, SESSION_FILE_HEADER, sizeof(header.magic)) != 0 ||
+            header.checksum != Crc32c::Compute(&header, offsetof(SessionFileHeader, checksum))) {
+            throw std::runtime_error("not a session snapshot: " + path);
+        }
+        if (header.version != SESSION_FILE_VERSION || header.recordSize != sizeof(SessionRecord) ||
+            header.records >= SESSION_NO_SLOT || header.liveCount > header.records ||
+            (header.freeHead != SESSION_NO_SLOT && header.freeHead >= header.records) ||
+            file.GetSize() != sizeof(header) + header.records * sizeof(SessionRecord)) {
+            throw std::runtime_error("unsupported or truncated session snapshot: " + path);
+        }
+        const uint8_t* data = file.GetData() + sizeof(header);
+        if (Crc32c::Compute(data, static_cast<size_t>(header.records * sizeof(SessionRecord))) != header.recordsChecksum) {
+            throw std::runtime_error("session snapshot checksum mismatch: " + path);
+        }
+
+        uint32_t count = static_cast<uint32_t>(header.records);
+        std::vector<std::unique_ptr<SessionRecord[]>> loaded;
+        for (uint32_t base = 0; base < count; base += SLAB_SIZE) {
+            loaded.push_back(std::make_unique<SessionRecord[]>(SLAB_SIZE));
+            uint32_t slabCount = (std::min)(SLAB_SIZE, count - base);
+            memcpy(loaded.back().get(), data + static_cast<size_t>(base) * sizeof(SessionRecord),
+                slabCount * sizeof(SessionRecord));
+        }
+
+        slabs = std::move(loaded);
+        records = count;
+        freeHead = header.freeHead;
+        liveCount = static_cast<size_t>(header.liveCount);
+    }
+
+private:
+    static Handle MakeHandle(uint32_t slot, uint32_t generation) {
+        return (static_cast<uint64_t>(generation) << 32) | slot;
+    }
+
+    SessionRecord& At(uint32_t slot) {
+        return slabs[slot >> SLAB_BITS][slot & (SLAB_SIZE - 1)];
+    }
+
+    const SessionRecord& At(uint32_t slot) const {
+        return slabs[slot >> SLAB_BITS][slot & (SLAB_SIZE - 1)];
+    }
+
+    //  GameEngine::AddRandomTile ͬλָѡֻ SplitMix64 
+    static void AddRandomTile(SessionRecord& record) {
+        Layout::EmptyCells empty = Layout::FindEmpty(record.board);
+        int count = Layout::CountCells(empty);
+        if (count == 0) return;
+
+        uint64_t random = SplitMix64(record.random);
+        record.random += 0x9E3779B97F4A7C15ULL;
+        Layout::PlaceTile(record.board, empty, RandomBelow(static_cast<uint32_t>(random >> 32), count),
+            StandardSpawn::Exponent(static_cast<uint32_t>(random)));
+    }
+};
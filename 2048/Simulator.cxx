@@ -0,0 +1,391 @@
+// ޽ģ̲߳Ծ֣ͳֲ󷽿ֲ
+// 룺g++ -std=c++20 -O2 -DNDEBUG -pthread Simulator.cxx -o simulator
+
+#include "MovePolicy.h"
+#include "ParallelSearch.h"
+#include "ReplayJournal.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct SimulationOptions {
+    int games = 100;
+    int threads = 0;    // 0 ʾʹȫӲ߳
+    uint64_t seed = 2048;
+    std::string policy = "expectimax";
+    int depth = 0;
+    int bucketWidth = 10000;
+    std::string journalPath;    // ǿʱÿдط־
+    bool journalSpawns = false;
+    std::string variant = "4x4";    // ̱壬 4x4 ֻ֧ random  greedy 
+    std::string weightsPath;    // ntuple ԵȨļ
+    std::string cachePath;      // expectimax Եĳ־ûֵ棬̹
+    int cacheMegabytes = 64;    // ½ļĴС
+    std::string heuristicPath;  // expectimax ֵ̬ȨãΪʱĬȨ
+    int checkThreads = 0;       //  0 ʱø߳һ飬ֱȽϽǷ߳޹
+    int checkParallel = 0;      //  0 ʱ 12 ͸̵߳Ĳÿ棬봮Ƚ
+};
+
+struct GameRecord {
+    int score;
+    int maxExponent;
+    int moves;
+};
+
+// ӺͶԾÿֶ߳޹
+static uint64_t GameSeed(uint64_t masterSeed, uint64_t gameIndex) {
+    return SplitMix64(masterSeed ^ SplitMix64(gameIndex));
+}
+
+// replay ǿʱͬʱ¼ط
+static GameRecord PlayGame(MovePolicy& policy, uint64_t seed, ReplayGame* replay, bool recordSpawns) {
+    GameEngine game(seed);
+    game.NewGame();
+    policy.NewGame();
+    // ʹöϷֻɷ飬طʱƾӼ
+    GameRandom policyRandom(SplitMix64(seed));
+    if (replay) replay->Begin(seed, game.GetBoard(), recordSpawns);
+
+    int moves = 0;
+    while (!game.IsGameOver()) {
+        Direction move;
+        if (!policy.ChooseMove(game.GetBoard(), policyRandom, move) || !game.Move(move)) {
+            break;
+        }
+
+        Board before = game.GetBoard();
+        game.AddRandomTile();
+        game.CheckGameOver();
+        moves++;
+        if (replay) {
+            replay->AddMove(move);
+            replay->AddSpawn(before, game.GetBoard());
+        }
+    }
+    if (replay) replay->Finish(game);
+
+    return { game.GetScore(), BitBoard::MaxExponent(game.GetBoard()), moves };
+}
+
+// ģô߸֣ÿٽ̳߳شСĲֵ봮ͬľ
+static int CheckParallel(const SimulationOptions& options) {
+    const int poolSizes[] = { 1, 2, options.checkParallel };
+    std::vector<std::unique_ptr<WorkStealingPool>> pools;
+    std::vector<std::unique_ptr<ParallelExpectimax>> searches;
+    for (int size : poolSizes) {
+        pools.push_back(std::make_unique<WorkStealingPool>(size));
+        searches.push_back(std::make_unique<ParallelExpectimax>(*pools.back()));
+    }
+
+    ExpectimaxSearch serial;
+    uint64_t boards = 0;
+    uint64_t differing = 0;
+    for (int i = 0; i < options.games; i++) {
+        GameEngine game(GameSeed(options.seed, static_cast<uint64_t>(i)));
+        game.NewGame();
+        serial.GetTable().Clear();
+        for (auto& search : searches) search->GetTable().Clear();
+
+        while (!game.IsGameOver()) {
+            SearchResult expected = serial.BestMove(game.GetBoard(), options.depth);
+            bool same = true;
+            for (auto& search : searches) {
+                SearchResult result = search->BestMove(game.GetBoard(), options.depth);
+                same = same && result.found == expected.found && result.move == expected.move &&
+                    result.value == expected.value;
+            }
+            boards++;
+            if (!same) differing++;
+            if (!expected.found || !game.Move(expected.move)) break;
+            game.AddRandomTile();
+            game.CheckGameOver();
+        }
+    }
+
+    printf("\nparallel    : %llu boards in %d games, serial vs pools of 1, 2 and %d threads, %llu differ\n",
+        static_cast<unsigned long long>(boards), options.games, options.checkParallel,
+        static_cast<unsigned long long>(differing));
+    return differing ? 2 : 0;
+}
+
+// ̱ĶԾ֣Զʵûʱ
+template <typename Engine>
+static GameRecord PlayVariantGame(bool greedy, uint64_t seed) {
+    using Layout = typename Engine::Layout;
+
+    Engine game(seed);
+    game.NewGame();
+    GameRandom policyRandom(SplitMix64(seed));
+
+    int moves = 0;
+    while (!game.IsGameOver()) {
+        Direction move;
+        bool found = greedy ? ChooseGreedyMove<Layout>(game.GetBoard(), move)
+            : ChooseRandomMove<Layout>(game.GetBoard(), policyRandom, move);
+        if (!found || !game.Move(move)) {
+            break;
+        }
+
+        game.AddRandomTile();
+        game.CheckGameOver();
+        moves++;
+    }
+
+    return { game.GetScore(), Layout::MaxExponent(game.GetBoard()), moves };
+}
+
+using VariantGameFunction = GameRecord (*)(bool greedy, uint64_t seed);
+
+// 4x4  nullptr PlayGame ͨ·δ֪׳쳣
+static VariantGameFunction FindVariant(const std::string& name) {
+    if (name == "4x4") return nullptr;
+    if (name == "3x3") return PlayVariantGame<GameEngine3x3>;
+    if (name == "5x5") return PlayVariantGame<GameEngine5x5>;
+    if (name == "6x6") return PlayVariantGame<GameEngine6x6>;
+    throw std::runtime_error("unknown variant " + name);
+}
+
+static std::vector<GameRecord> RunSimulation(const SimulationOptions& options, EvaluationCache* cache) {
+    std::vector<GameRecord> records(options.games);
+    std::atomic<int> nextGame(0);
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    // ط־Ծ˳дɵĶԾݴ棬ǰĶдд߳޹
+    std::unique_ptr<ReplayWriter> journal;
+    std::vector<ReplayGame> pendingReplays;
+    std::vector<char> replayReady;
+    int nextReplay = 0;
+    std::mutex journalMutex;
+    if (!options.journalPath.empty()) {
+        journal = std::make_unique<ReplayWriter>(options.journalPath);
+        if (journal->GetDiscardedBytes() > 0) {
+            fprintf(stderr, "journal: discarded %zu bytes of an incomplete record at the end of %s\n",
+                journal->GetDiscardedBytes(), options.journalPath.c_str());
+        }
+        pendingReplays.resize(options.games);
+        replayReady.resize(options.games, 0);
+    }
+
+    VariantGameFunction playVariant = FindVariant(options.variant);
+    bool greedy = options.policy == "greedy";
+
+    auto worker = [&]() {
+        try {
+            std::unique_ptr<MovePolicy> policy = MovePolicy::Create(options.policy, options.depth, options.weightsPath, cache);
+            for (;;) {
+                int index = nextGame.fetch_add(1, std::memory_order_relaxed);
+                if (index >= options.games) break;
+                if (playVariant) {
+                    records[index] = playVariant(greedy, GameSeed(options.seed, index));
+                    continue;
+                }
+                if (!journal) {
+                    records[index] = PlayGame(*policy, GameSeed(options.seed, index), nullptr, false);
+                    continue;
+                }
+
+                ReplayGame replay;
+                records[index] = PlayGame(*policy, GameSeed(options.seed, index), &replay, options.journalSpawns);
+
+                std::lock_guard<std::mutex> lock(journalMutex);
+                pendingReplays[index] = std::move(replay);
+                replayReady[index] = 1;
+                while (nextReplay < options.games && replayReady[nextReplay]) {
+                    journal->Append(pendingReplays[nextReplay]);
+                    pendingReplays[nextReplay] = ReplayGame();
+                    nextReplay++;
+                }
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure) failure = std::current_exception();
+            nextGame.store(options.games, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < options.threads; i++) {
+        pool.emplace_back(worker);
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    if (journal) {
+        journal->Flush();
+    }
+    return records;
+}
+
+static void PrintReport(const SimulationOptions& options, const std::vector<GameRecord>& records, double seconds) {
+    uint64_t totalMoves = 0;
+    uint64_t totalScore = 0;
+    int minScore = records.empty() ? 0 : records[0].score;
+    int maxScore = 0;
+    int exponentCounts[MAX_TILE_EXPONENT + 1] = {};
+
+    for (const GameRecord& record : records) {
+        totalMoves += record.moves;
+        totalScore += record.score;
+        if (record.score < minScore) minScore = record.score;
+        if (record.score > maxScore) maxScore = record.score;
+        exponentCounts[record.maxExponent]++;
+    }
+
+    int games = static_cast<int>(records.size());
+    printf("policy      : %s (depth %d), board %s\n", options.policy.c_str(), options.depth, options.variant.c_str());
+    printf("games       : %d on %d threads, seed %llu\n", games, options.threads,
+        static_cast<unsigned long long>(options.seed));
+    printf("elapsed     : %.3f s\n", seconds);
+    printf("throughput  : %.1f games/s, %.0f moves/s\n", games / seconds, totalMoves / seconds);
+    printf("score       : mean %.1f, min %d, max %d\n",
+        games ? static_cast<double>(totalScore) / games : 0.0, minScore, maxScore);
+
+    printf("\nscore histogram (bucket %d)\n", options.bucketWidth);
+    std::vector<int> buckets(maxScore / options.bucketWidth + 1, 0);
+    for (const GameRecord& record : records) {
+        buckets[record.score / options.bucketWidth]++;
+    }
+    for (size_t i = 0; i < buckets.size(); i++) {
+        if (buckets[i] == 0) continue;
+        printf("  %7zu - %7zu : %6d\n", i * options.bucketWidth, (i + 1) * options.bucketWidth - 1, buckets[i]);
+    }
+
+    printf("\nmax tile distribution\n");
+    int reached = games;
+    for (int exponent = 0; exponent <= MAX_TILE_EXPONENT; exponent++) {
+        if (exponentCounts[exponent] > 0) {
+            printf("  %6d : %6d (%5.1f%%), reached by %5.1f%%\n", exponent ? 1 << exponent : 0,
+                exponentCounts[exponent], 100.0 * exponentCounts[exponent] / games, 100.0 * reached / games);
+        }
+        reached -= exponentCounts[exponent];
+    }
+}
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr,
+        "usage: %s [--games N] [--threads N] [--seed N] [--policy random|greedy|expectimax|ntuple]\n"
+        "          [--depth N] [--bucket N] [--journal FILE] [--journal-spawns 0|1]\n"
+        "          [--variant 3x3|4x4|5x5|6x6] [--weights FILE] [--cache FILE] [--cache-mb N]\n"
+        "          [--heuristic FILE] [--check-threads N] [--check-parallel N]\n", program);
+}
+
+int main(int argc, char** argv) {
+    SimulationOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        if (strcmp(arg, "--games") == 0) options.games = atoi(value);
+        else if (strcmp(arg, "--threads") == 0) options.threads = atoi(value);
+        else if (strcmp(arg, "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--policy") == 0) options.policy = value;
+        else if (strcmp(arg, "--depth") == 0) options.depth = atoi(value);
+        else if (strcmp(arg, "--bucket") == 0) options.bucketWidth = atoi(value);
+        else if (strcmp(arg, "--journal") == 0) options.journalPath = value;
+        else if (strcmp(arg, "--journal-spawns") == 0) options.journalSpawns = atoi(value) != 0;
+        else if (strcmp(arg, "--variant") == 0) options.variant = value;
+        else if (strcmp(arg, "--weights") == 0) options.weightsPath = value;
+        else if (strcmp(arg, "--cache") == 0) options.cachePath = value;
+        else if (strcmp(arg, "--cache-mb") == 0) options.cacheMegabytes = atoi(value);
+        else if (strcmp(arg, "--heuristic") == 0) options.heuristicPath = value;
+        else if (strcmp(arg, "--check-threads") == 0) options.checkThreads = atoi(value);
+        else if (strcmp(arg, "--check-parallel") == 0) options.checkParallel = atoi(value);
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    if (options.threads <= 0) {
+        options.threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (options.threads <= 0) options.threads = 1;
+    }
+    // ־ûȡڸ̵߳˳򣬲ܲȷԼ
+    if (options.games <= 0 || options.bucketWidth <= 0 || options.cacheMegabytes <= 0 || options.checkThreads < 0 ||
+        options.checkParallel < 0 || ((options.checkThreads > 0 || options.checkParallel > 0) && !options.cachePath.empty()) ||
+        (options.checkParallel > 0 && options.policy != "expectimax") ||
+        ((!options.cachePath.empty() || !options.heuristicPath.empty()) && options.policy != "expectimax") ||
+        !MovePolicy::IsKnown(options.policy) || (options.policy == "ntuple" && options.weightsPath.empty())) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    // ûN Ԫͻط־ 64 λ 4x4 
+    if (options.variant != "4x4" &&
+        (options.policy == "expectimax" || options.policy == "ntuple" || !options.journalPath.empty())) {
+        fprintf(stderr, "variant %s supports only the random and greedy policies without a journal\n",
+            options.variant.c_str());
+        return 1;
+    }
+
+    try {
+        // ļͷ¼ֵʶȨ
+        Heuristic::LoadActive(options.heuristicPath);
+        std::unique_ptr<EvaluationCache> cache;
+        if (!options.cachePath.empty()) {
+            cache = std::make_unique<EvaluationCache>(options.cachePath, static_cast<size_t>(options.cacheMegabytes),
+                ExpectimaxSearch::EvaluatorId());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<GameRecord> records = RunSimulation(options, cache.get());
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        PrintReport(options, records, seconds);
+        if (cache) {
+            EvalCacheStats stats = cache->GetStats();
+            printf("\neval cache  : %s, %llu probes, %.1f%% hits, %llu stores\n", options.cachePath.c_str(),
+                static_cast<unsigned long long>(stats.probes), 100.0 * stats.HitRate(),
+                static_cast<unsigned long long>(stats.stores));
+        }
+
+        if (options.checkThreads > 0) {
+            SimulationOptions check = options;
+            check.threads = options.checkThreads;
+            check.journalPath.clear();
+            std::vector<GameRecord> again = RunSimulation(check, nullptr);
+            int differing = 0;
+            int first = -1;
+            for (size_t i = 0; i < records.size(); i++) {
+                if (records[i].score != again[i].score || records[i].moves != again[i].moves ||
+                    records[i].maxExponent != again[i].maxExponent) {
+                    if (first < 0) first = static_cast<int>(i);
+                    differing++;
+                }
+            }
+            printf("\ndeterminism : %d vs %d threads, %d of %d games differ", options.threads, check.threads, differing,
+                options.games);
+            if (first >= 0) printf(" (first: game %d, score %d vs %d)", first, records[first].score, again[first].score);
+            printf("\n");
+            if (differing) return 2;
+        }
+        if (options.checkParallel > 0) {
+            return CheckParallel(options);
+        }
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "simulation failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,450 @@
+#pragma once
+
+#include "BitBoard.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ֳͻأGUI Ⱦ
+const int TILE_SIZE = 80;
+const int BOARD_MARGIN = 10;
+const int BOARD_TOP = 60;
+const int BOARD_PIXELS = BOARD_SIZE * TILE_SIZE + (BOARD_SIZE + 1) * BOARD_MARGIN;
+const int TILE_BORDER = 2;
+
+// 500x500 Ĭϱ߿µĿͻСȾʱʹ
+const int DEFAULT_FRAME_WIDTH = 484;
+const int DEFAULT_FRAME_HEIGHT = 461;
+
+// ظʽΪ 0xAARRGGBBСڴеֽ˳ 32 λ DIB ֱͬӽ Win32 ʾ
+constexpr uint32_t MakeColor(int r, int g, int b) {
+    return 0xFF000000u | (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | static_cast<uint32_t>(b);
+}
+
+const uint32_t BACKGROUND_COLOR = MakeColor(187, 173, 160);
+const uint32_t SCORE_COLOR = MakeColor(255, 255, 255);
+const uint32_t MESSAGE_BAND_COLOR = MakeColor(60, 58, 50);
+
+// ָ0 Ϊո11 Ϊ 2048ķ鹲ɫ
+const uint32_t TILE_COLORS[MAX_TILE_EXPONENT + 1] = {
+    MakeColor(205, 193, 180),   // 0
+    MakeColor(238, 228, 218),   // 2
+    MakeColor(237, 224, 200),   // 4
+    MakeColor(242, 177, 121),   // 8
+    MakeColor(245, 149, 99),    // 16
+    MakeColor(246, 124, 95),    // 32
+    MakeColor(246, 94, 59),     // 64
+    MakeColor(237, 207, 114),   // 128
+    MakeColor(237, 204, 97),    // 256
+    MakeColor(237, 200, 80),    // 512
+    MakeColor(237, 197, 63),    // 1024
+    MakeColor(237, 194, 46),    // 2048
+    MakeColor(60, 58, 50),      // 4096
+    MakeColor(60, 58, 50),      // 8192
+    MakeColor(60, 58, 50),      // 16384
+    MakeColor(60, 58, 50)       // 32768
+};
+
+const uint32_t TEXT_COLORS[] = {
+    MakeColor(119, 110, 101),   // 2  4
+    MakeColor(249, 246, 242)
+};
+
+struct RenderRect {
+    int left;
+    int top;
+    int right;
+    int bottom;
+};
+
+// һ֡Ҫȫ״̬hint ֻжϱǷҪػ棬ʾƽ̨
+struct RenderState {
+    Board board;
+    int score;
+    int hint;
+    bool gameOver;
+    bool won;
+};
+
+// ڴе 32 λ֡
+class Framebuffer {
+private:
+    int width;
+    int height;
+    std::vector<uint32_t> pixels;
+
+public:
+    Framebuffer() : width(0), height(0) {
+    }
+
+    void Resize(int newWidth, int newHeight) {
+        width = newWidth > 0 ? newWidth : 0;
+        height = newHeight > 0 ? newHeight : 0;
+        pixels.assign(static_cast<size_t>(width) * height, BACKGROUND_COLOR);
+    }
+
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+    const uint32_t* GetPixels() const { return pixels.data(); }
+    uint32_t* GetRow(int y) { return pixels.data() + static_cast<size_t>(y) * width; }
+    const uint32_t* GetRow(int y) const { return pixels.data() + static_cast<size_t>(y) * width; }
+
+    // üڣǷʣ
+    bool Clip(RenderRect& rect) const {
+        if (rect.left < 0) rect.left = 0;
+        if (rect.top < 0) rect.top = 0;
+        if (rect.right > width) rect.right = width;
+        if (rect.bottom > height) rect.bottom = height;
+        return rect.left < rect.right && rect.top < rect.bottom;
+    }
+
+    void FillRect(RenderRect rect, uint32_t color) {
+        if (!Clip(rect)) return;
+        for (int y = rect.top; y < rect.bottom; y++) {
+            uint32_t* row = GetRow(y);
+            for (int x = rect.left; x < rect.right; x++) {
+                row[x] = color;
+            }
+        }
+    }
+
+    //  alpha0..255 color ϵ
+    void BlendRect(RenderRect rect, uint32_t color, int alpha) {
+        if (!Clip(rect)) return;
+        for (int y = rect.top; y < rect.bottom; y++) {
+            uint32_t* row = GetRow(y);
+            for (int x = rect.left; x < rect.right; x++) {
+                row[x] = Blend(row[x], color, alpha);
+            }
+        }
+    }
+
+    //  source п sourceWidth ͼ (x, y)ֲõ
+    void Copy(int x, int y, const uint32_t* source, int sourceWidth, int sourceHeight) {
+        RenderRect rect = { x, y, x + sourceWidth, y + sourceHeight };
+        if (!Clip(rect)) return;
+        size_t rowBytes = static_cast<size_t>(rect.right - rect.left) * sizeof(uint32_t);
+        for (int row = rect.top; row < rect.bottom; row++) {
+            const uint32_t* from = source + static_cast<size_t>(row - y) * sourceWidth + (rect.left - x);
+            memcpy(GetRow(row) + rect.left, from, rowBytes);
+        }
+    }
+
+    static uint32_t Blend(uint32_t background, uint32_t foreground, int alpha) {
+        uint32_t result = 0xFF000000u;
+        for (int shift = 0; shift < 24; shift += 8) {
+            int b = (background >> shift) & 0xFF;
+            int f = (foreground >> shift) & 0xFF;
+            result |= static_cast<uint32_t>(b + ((f - b) * alpha + 127) / 255) << shift;
+        }
+        return result;
+    }
+
+    //  PPMP6ûдϵͳĻмȾ
+    void WritePpm(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("cannot create " + path);
+        }
+
+        file << "P6\n" << width << " " << height << "\n255\n";
+        std::vector<char> line(static_cast<size_t>(width) * 3);
+        for (int y = 0; y < height; y++) {
+            const uint32_t* row = GetRow(y);
+            for (int x = 0; x < width; x++) {
+                line[x * 3] = static_cast<char>(row[x] >> 16);
+                line[x * 3 + 1] = static_cast<char>(row[x] >> 8);
+                line[x * 3 + 2] = static_cast<char>(row[x]);
+            }
+            file.write(line.data(), line.size());
+        }
+        if (file.fail()) {
+            throw std::runtime_error("failed writing " + path);
+        }
+    }
+};
+
+// 5x7 ֣ÿе 5 λ
+const uint8_t DIGIT_FONT[10][7] = {
+    { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E },
+    { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F },
+    { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },
+    { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 },
+    { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },
+    { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E },
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E },
+    { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }
+};
+const int DIGIT_FONT_WIDTH = 5;
+const int DIGIT_FONT_HEIGHT = 7;
+
+// ĳһֺ 0-9 ĸλͼʱ 4x4 դһΣʱֻ
+class GlyphAtlas {
+private:
+    static const int SAMPLES = 4;
+
+    double scale;
+    int glyphWidth;
+    int glyphHeight;
+    std::vector<uint8_t> coverage;  // 10 Уÿ glyphWidth * glyphHeight
+
+public:
+    explicit GlyphAtlas(double pixelScale)
+        : scale(pixelScale),
+        glyphWidth(static_cast<int>(DIGIT_FONT_WIDTH * pixelScale + 0.999)),
+        glyphHeight(static_cast<int>(DIGIT_FONT_HEIGHT * pixelScale + 0.999)) {
+        coverage.resize(static_cast<size_t>(10) * glyphWidth * glyphHeight);
+        for (int digit = 0; digit < 10; digit++) {
+            uint8_t* glyph = &coverage[static_cast<size_t>(digit) * glyphWidth * glyphHeight];
+            for (int y = 0; y < glyphHeight; y++) {
+                for (int x = 0; x < glyphWidth; x++) {
+                    glyph[y * glyphWidth + x] = static_cast<uint8_t>(Rasterize(digit, x, y));
+                }
+            }
+        }
+    }
+
+    int GetGlyphHeight() const { return glyphHeight; }
+
+    // ַһ
+    int GetAdvance(int index) const {
+        return static_cast<int>(index * (DIGIT_FONT_WIDTH + 1) * scale + 0.5);
+    }
+
+    int MeasureText(const char* text) const {
+        int length = static_cast<int>(strlen(text));
+        return length ? GetAdvance(length - 1) + glyphWidth : 0;
+    }
+
+    //  (x, y) ΪϽǻʮִ
+    void DrawDigits(Framebuffer& target, int x, int y, const char* text, uint32_t color) const {
+        for (int i = 0; text[i]; i++) {
+            int digit = text[i] - '0';
+            if (digit < 0 || digit > 9) continue;
+
+            const uint8_t* glyph = &coverage[static_cast<size_t>(digit) * glyphWidth * glyphHeight];
+            int left = x + GetAdvance(i);
+            for (int row = 0; row < glyphHeight; row++) {
+                int py = y + row;
+                if (py < 0 || py >= target.GetHeight()) continue;
+                uint32_t* pixels = target.GetRow(py);
+                for (int col = 0; col < glyphWidth; col++) {
+                    int px = left + col;
+                    int alpha = glyph[row * glyphWidth + col];
+                    if (alpha == 0 || px < 0 || px >= target.GetWidth()) continue;
+                    pixels[px] = Framebuffer::Blend(pixels[px], color, alpha);
+                }
+            }
+        }
+    }
+
+private:
+    int Rasterize(int digit, int x, int y) const {
+        int hits = 0;
+        for (int sy = 0; sy < SAMPLES; sy++) {
+            int fontRow = static_cast<int>((y + (sy + 0.5) / SAMPLES) / scale);
+            if (fontRow >= DIGIT_FONT_HEIGHT) continue;
+            for (int sx = 0; sx < SAMPLES; sx++) {
+                int fontCol = static_cast<int>((x + (sx + 0.5) / SAMPLES) / scale);
+                if (fontCol < DIGIT_FONT_WIDTH && (DIGIT_FONT[digit][fontRow] >> (DIGIT_FONT_WIDTH - 1 - fontCol)) & 1) {
+                    hits++;
+                }
+            }
+        }
+        return hits * 255 / (SAMPLES * SAMPLES);
+    }
+};
+
+// ƽ̨޹صȾڴ֡壬Win32 ֻѻϡ
+// ÿָͼ񣨵ɫ߿֣ڹʱԤȺϳɣƷֻиƣ
+// Render һ֡Ƚϣֻػ仯ķ鲢Ҫˢµ
+class SoftwareRenderer {
+private:
+    Framebuffer frame;
+    std::vector<uint32_t> tileImages;   // MAX_TILE_EXPONENT + 1  TILE_SIZE x TILE_SIZE ͼ
+    GlyphAtlas scoreGlyphs;
+    std::vector<RenderRect> dirty;
+    RenderState last;
+    bool valid;
+
+public:
+    SoftwareRenderer() : scoreGlyphs(2.5), last(), valid(false) {
+        BuildTileImages();
+        dirty.reserve(BOARD_SIZE * BOARD_SIZE + 2);
+    }
+
+    void Resize(int width, int height) {
+        if (width == frame.GetWidth() && height == frame.GetHeight()) return;
+        frame.Resize(width, height);
+        valid = false;
+    }
+
+    // һ֡ȫػ
+    void Invalidate() {
+        valid = false;
+    }
+
+    const Framebuffer& GetFramebuffer() const { return frame; }
+
+    RenderRect GetTileRect(int row, int col) const {
+        int x = GetBoardLeft() + BOARD_MARGIN + col * (TILE_SIZE + BOARD_MARGIN);
+        int y = BOARD_TOP + BOARD_MARGIN + row * (TILE_SIZE + BOARD_MARGIN);
+        return { x, y, x + TILE_SIZE, y + TILE_SIZE };
+    }
+
+    // ֵ":" ǩ
+    static RenderRect GetScoreRect() { return { 76, 10, 210, 50 }; }
+
+    RenderRect GetHeaderRect() const {
+        return { 0, 0, frame.GetWidth(), BOARD_TOP };
+    }
+
+    // Ϸʤʱڵĺ
+    RenderRect GetMessageRect() const {
+        int top = frame.GetHeight() - 100;
+        return { 0, top, frame.GetWidth(), top + 48 };
+    }
+
+    //  state ֡壬ر֡Ķ֡ߴ仯Ϊͻ
+    const std::vector<RenderRect>& Render(const RenderState& state) {
+        dirty.clear();
+        bool overlay = state.gameOver || state.won;
+        bool overlayChanged = !valid || overlay != (last.gameOver || last.won);
+
+        if (!valid) {
+            frame.FillRect({ 0, 0, frame.GetWidth(), frame.GetHeight() }, BACKGROUND_COLOR);
+            dirty.push_back({ 0, 0, frame.GetWidth(), frame.GetHeight() });
+        }
+
+        if (!valid || state.score != last.score || state.hint != last.hint) {
+            DrawHeader(state.score);
+            if (valid) dirty.push_back(GetHeaderRect());
+        }
+
+        // ֻʧʱµķػֻ仯ĸ
+        RenderRect band = GetMessageRect();
+        if (overlayChanged && valid) {
+            frame.FillRect(band, BACKGROUND_COLOR);
+            dirty.push_back(band);
+        }
+
+        Board changed = valid ? state.board ^ last.board : ~Board(0);
+        for (int row = 0; row < BOARD_SIZE; row++) {
+            for (int col = 0; col < BOARD_SIZE; col++) {
+                RenderRect tile = GetTileRect(row, col);
+                bool underBand = tile.bottom > band.top && tile.top < band.bottom;
+                bool cellChanged = (changed >> ((row * BOARD_SIZE + col) * 4)) & 0xF;
+                if (!cellChanged && !(overlayChanged && underBand)) continue;
+
+                DrawTile(tile, BitBoard::GetExponent(state.board, row, col));
+                if (overlay && underBand) {
+                    frame.BlendRect(Intersect(tile, band), MESSAGE_BAND_COLOR, 160);
+                }
+                if (valid && cellChanged) dirty.push_back(tile);
+            }
+        }
+
+        // ػʱٻϷ֮Ŀ϶
+        if (overlay && overlayChanged) {
+            BlendBandGaps(band);
+        }
+
+        last = state;
+        valid = true;
+        return dirty;
+    }
+
+private:
+    int GetBoardLeft() const {
+        return (frame.GetWidth() - BOARD_PIXELS) / 2;
+    }
+
+    static RenderRect Intersect(RenderRect a, const RenderRect& b) {
+        if (a.left < b.left) a.left = b.left;
+        if (a.top < b.top) a.top = b.top;
+        if (a.right > b.right) a.right = b.right;
+        if (a.bottom > b.bottom) a.bottom = b.bottom;
+        return a;
+    }
+
+    // ֻзȾƣಿʼǱɫ
+    void DrawHeader(int score) {
+        RenderRect rect = GetScoreRect();
+        frame.FillRect(rect, BACKGROUND_COLOR);
+
+        char text[16];
+        snprintf(text, sizeof(text), "%d", score);
+        int y = rect.top + (rect.bottom - rect.top - scoreGlyphs.GetGlyphHeight()) / 2;
+        scoreGlyphs.DrawDigits(frame, rect.left, y, text, SCORE_COLOR);
+    }
+
+    void DrawTile(const RenderRect& tile, int exponent) {
+        const uint32_t* image = &tileImages[static_cast<size_t>(exponent) * TILE_SIZE * TILE_SIZE];
+        frame.Copy(tile.left, tile.top, image, TILE_SIZE, TILE_SIZE);
+    }
+
+    // 鲿 DrawTile ֮ϣֻɫĿ϶
+    void BlendBandGaps(const RenderRect& band) {
+        RenderRect clipped = band;
+        if (!frame.Clip(clipped)) return;
+        for (int y = clipped.top; y < clipped.bottom; y++) {
+            uint32_t* row = frame.GetRow(y);
+            for (int x = clipped.left; x < clipped.right; x++) {
+                if (!InsideTile(x, y)) {
+                    row[x] = Framebuffer::Blend(row[x], MESSAGE_BAND_COLOR, 160);
+                }
+            }
+        }
+    }
+
+    bool InsideTile(int x, int y) const {
+        int bx = x - GetBoardLeft() - BOARD_MARGIN;
+        int by = y - BOARD_TOP - BOARD_MARGIN;
+        if (bx < 0 || by < 0) return false;
+        int stride = TILE_SIZE + BOARD_MARGIN;
+        return bx / stride < BOARD_SIZE && by / stride < BOARD_SIZE &&
+            bx % stride < TILE_SIZE && by % stride < TILE_SIZE;
+    }
+
+    // ԽֺԽСԭ 32/28/24 ֵĹ۸нӽ
+    static double TileGlyphScale(int digits) {
+        if (digits <= 2) return 4.0;
+        if (digits == 3) return 3.5;
+        if (digits == 4) return 2.75;
+        return 2.25;
+    }
+
+    void BuildTileImages() {
+        tileImages.resize(static_cast<size_t>(MAX_TILE_EXPONENT + 1) * TILE_SIZE * TILE_SIZE);
+        GlyphAtlas atlases[] = { GlyphAtlas(TileGlyphScale(1)), GlyphAtlas(TileGlyphScale(3)),
+            GlyphAtlas(TileGlyphScale(4)), GlyphAtlas(TileGlyphScale(5)) };
+
+        Framebuffer tile;
+        tile.Resize(TILE_SIZE, TILE_SIZE);
+        for (int exponent = 0; exponent <= MAX_TILE_EXPONENT; exponent++) {
+            tile.FillRect({ 0, 0, TILE_SIZE, TILE_SIZE }, BACKGROUND_COLOR);
+            tile.FillRect({ TILE_BORDER, TILE_BORDER, TILE_SIZE - TILE_BORDER, TILE_SIZE - TILE_BORDER },
+                TILE_COLORS[exponent]);
+
+            if (exponent > 0) {
+                char text[8];
+                snprintf(text, sizeof(text), "%d", 1 << exponent);
+                int digits = static_cast<int>(strlen(text));
+                const GlyphAtlas& atlas = atlases[digits <= 2 ? 0 : digits - 2];
+                int x = (TILE_SIZE - atlas.MeasureText(text)) / 2;
+                int y = (TILE_SIZE - atlas.GetGlyphHeight()) / 2;
+                atlas.DrawDigits(tile, x, y, text, exponent <= 2 ? TEXT_COLORS[0] : TEXT_COLORS[1]);
+            }
+
+            memcpy(&tileImages[static_cast<size_t>(exponent) * TILE_SIZE * TILE_SIZE], tile.GetPixels(),
+                sizeof(uint32_t) * TILE_SIZE * TILE_SIZE);
+        }
+    }
+};
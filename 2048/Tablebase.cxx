@@ -0,0 +1,220 @@
+// Сȫ⹤ߣ 2x22x33x3 ȫɴ沢дѯѯ棬
+// 򰴱еŲҶģʵƽʤʺͱеĿ
+// 룺g++ -std=c++20 -O2 -DNDEBUG -pthread Tablebase.cxx -o tablebase
+
+#include "GameEngine.h"
+#include "Tablebase.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+using Rules2x2 = GameRules<2, 2, 5>;
+using Rules2x3 = GameRules<2, 3, 7>;
+using Rules3x3 = GameRules<3, 3, 8>;
+
+struct TablebaseOptions {
+    int threads = 0;    // 0 ʾʹȫӲ߳
+    uint64_t games = 100000;
+    uint64_t seed = 2048;
+    TablebaseObjective objective = TablebaseObjective::Score;
+};
+
+static const char* DIRECTION_NAMES[DIRECTION_COUNT] = { "left", "right", "up", "down" };
+
+template <typename Rules>
+static int SolveVariant(const std::string& path, const TablebaseOptions& options) {
+    WorkStealingPool pool(options.threads);
+    TablebaseSolver<Rules> solver(pool, true);
+
+    auto start = std::chrono::steady_clock::now();
+    solver.Solve(path);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    BasicTablebase<Rules> table(path);
+    const TablebaseFileHeader& header = table.GetHeader();
+    printf("positions   : %llu canonical, %llu slots\n", static_cast<unsigned long long>(header.positions),
+        static_cast<unsigned long long>(header.slots));
+    printf("new game    : expected score %.3f, win probability %.6f\n", header.newGameScore, header.newGameWin);
+    printf("solve       : %.3f s on %d threads, %.1f MB\n", seconds, pool.GetThreadCount(),
+        BasicTablebase<Rules>::FileSize(header.buckets, header.slots) / 1048576.0);
+    return 0;
+}
+
+template <typename Rules>
+static int QueryVariant(const std::string& path, uint64_t board) {
+    BasicTablebase<Rules> table(path);
+    TablebaseEntry entry;
+    if (!table.Lookup(board, entry)) {
+        printf("board %llx is not reachable\n", static_cast<unsigned long long>(board));
+        return 2;
+    }
+
+    printf("canonical   : %llx\n", static_cast<unsigned long long>(entry.board));
+    printf("expected    : score %.3f, win probability %.6f\n", entry.expectedScore, entry.winProbability);
+    Direction move;
+    double value = 0.0;
+    if (table.BestMove(board, TablebaseObjective::Score, move, &value)) {
+        printf("best score  : %s (%.3f)\n", DIRECTION_NAMES[static_cast<int>(move)], value);
+    }
+    if (table.BestMove(board, TablebaseObjective::Win, move, &value)) {
+        printf("best win    : %s (%.6f)\n", DIRECTION_NAMES[static_cast<int>(move)], value);
+    }
+    return 0;
+}
+
+template <typename Rules>
+static int PlayVariant(const std::string& path, const TablebaseOptions& options) {
+    BasicTablebase<Rules> table(path);
+    const TablebaseFileHeader& header = table.GetHeader();
+
+    double totalScore = 0.0;
+    double totalSquares = 0.0;
+    uint64_t wins = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < options.games; i++) {
+        BasicGameEngine<Rules> game(SplitMix64(options.seed ^ SplitMix64(i)));
+        game.NewGame();
+        while (!game.IsGameOver()) {
+            Direction move;
+            if (!table.BestMove(game.GetBoard(), options.objective, move) || !game.Move(move)) {
+                throw std::runtime_error("tablebase has no move for a reachable position");
+            }
+            game.AddRandomTile();
+            game.CheckGameOver();
+        }
+        totalScore += game.GetScore();
+        totalSquares += static_cast<double>(game.GetScore()) * game.GetScore();
+        if (game.IsWon()) wins++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // ƽֵı׼жƫǷֻǳ
+    double games = static_cast<double>(options.games);
+    double mean = totalScore / games;
+    double error = std::sqrt((std::max)(0.0, totalSquares / games - mean * mean) / games);
+    printf("objective   : %s, %llu games in %.3f s\n", options.objective == TablebaseObjective::Score ? "score" : "win",
+        static_cast<unsigned long long>(options.games), seconds);
+    printf("score       : mean %.3f +- %.3f, table %.3f\n", mean, error, header.newGameScore);
+    printf("win rate    : %.6f, table %.6f\n", wins / games, header.newGameWin);
+    return 0;
+}
+
+static int PrintInfo(const std::string& path) {
+    MappedFile file(path);
+    TablebaseFileHeader header;
+    if (file.GetSize() < sizeof(header)) {
+        throw std::runtime_error("not a tablebase: " + path);
+    }
+    memcpy(&header, file.GetData(), sizeof(header));
+    if (memcmp(header.magic, TABLEBASE_FILE_HEADER, sizeof(header.magic)) != 0 ||
+        header.checksum != Crc32c::Compute(&header, offsetof(TablebaseFileHeader, checksum))) {
+        throw std::runtime_error("not a tablebase: " + path);
+    }
+
+    printf("board       : %dx%d, win tile %d, P(2) %.6f\n", header.rows, header.columns, 1 << header.winExponent,
+        header.twoProbability);
+    printf("positions   : %llu canonical, %llu slots, %llu buckets\n", static_cast<unsigned long long>(header.positions),
+        static_cast<unsigned long long>(header.slots), static_cast<unsigned long long>(header.buckets));
+    printf("new game    : expected score %.3f, win probability %.6f\n", header.newGameScore, header.newGameWin);
+    return 0;
+}
+
+// ļͷеѡʵ
+static std::string VariantOf(const std::string& path) {
+    MappedFile file(path);
+    if (file.GetSize() < sizeof(TablebaseFileHeader)) {
+        throw std::runtime_error("not a tablebase: " + path);
+    }
+    const TablebaseFileHeader* header = reinterpret_cast<const TablebaseFileHeader*>(file.GetData());
+    return std::to_string(header->rows) + "x" + std::to_string(header->columns);
+}
+
+template <template <typename> class Command, typename... Args>
+static int Dispatch(const std::string& variant, Args&&... args) {
+    if (variant == "2x2") return Command<Rules2x2>::Run(args...);
+    if (variant == "2x3") return Command<Rules2x3>::Run(args...);
+    if (variant == "3x3") return Command<Rules3x3>::Run(args...);
+    throw std::runtime_error("unsupported variant " + variant);
+}
+
+template <typename Rules>
+struct SolveCommand {
+    static int Run(const std::string& path, const TablebaseOptions& options) { return SolveVariant<Rules>(path, options); }
+};
+
+template <typename Rules>
+struct QueryCommand {
+    static int Run(const std::string& path, uint64_t board) { return QueryVariant<Rules>(path, board); }
+};
+
+template <typename Rules>
+struct PlayCommand {
+    static int Run(const std::string& path, const TablebaseOptions& options) { return PlayVariant<Rules>(path, options); }
+};
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr, "usage: %s solve 2x2|2x3|3x3 FILE [--threads N]\n", program);
+    fprintf(stderr, "       %s query FILE BOARD\n", program);
+    fprintf(stderr, "       %s play FILE [--games N] [--seed N] [--objective score|win]\n", program);
+    fprintf(stderr, "       %s info FILE\n", program);
+}
+
+// ɶԳֵѡ
+static bool ParseOptions(int argc, char** argv, int first, TablebaseOptions& options) {
+    for (int i = first; i < argc; i += 2) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) return false;
+
+        if (strcmp(arg, "--threads") == 0) options.threads = atoi(value);
+        else if (strcmp(arg, "--games") == 0) options.games = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--objective") == 0 && strcmp(value, "score") == 0) options.objective = TablebaseObjective::Score;
+        else if (strcmp(arg, "--objective") == 0 && strcmp(value, "win") == 0) options.objective = TablebaseObjective::Win;
+        else return false;
+    }
+    return options.games > 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::string command = argv[1];
+    TablebaseOptions options;
+    try {
+        if (command == "solve" && argc >= 4 && ParseOptions(argc, argv, 4, options)) {
+            return Dispatch<SolveCommand>(argv[2], std::string(argv[3]), options);
+        }
+        if (command == "query" && argc == 4) {
+            char* end = nullptr;
+            uint64_t board = strtoull(argv[3], &end, 16);
+            if (*end != '\0') {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+            return Dispatch<QueryCommand>(VariantOf(argv[2]), std::string(argv[2]), board);
+        }
+        if (command == "play" && ParseOptions(argc, argv, 3, options)) {
+            return Dispatch<PlayCommand>(VariantOf(argv[2]), std::string(argv[2]), options);
+        }
+        if (command == "info" && argc == 3) {
+            return PrintInfo(argv[2]);
+        }
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "tablebase failed: %s\n", e.what());
+        return 1;
+    }
+
+    PrintUsage(argv[0]);
+    return 1;
+}
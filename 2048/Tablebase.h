@@ -0,0 +1,633 @@
+#pragma once
+
+#include "Crc32c.h"
+#include "GameEngine.h"
+#include "MappedFile.h"
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// С̣2x22x33x3ȫ⣺öٰ MoveLeft/AddRandomTile ɴȫ棬
+// ӷܺһ㿪ʼƣõŲµյ÷ֺʤʡ
+// дڴӳϣ O(1) ѯ
+const char TABLEBASE_FILE_HEADER[8] = { '2', '0', '4', '8', 'T', 'B', 'A', 'S' };
+const uint32_t TABLEBASE_FILE_VERSION = 1;
+const uint64_t TABLEBASE_EMPTY_SLOT = UINT64_MAX;
+
+#pragma pack(push, 1)
+struct TablebaseFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint8_t rows;
+    uint8_t columns;
+    uint8_t winExponent;
+    uint8_t reserved0;
+    double twoProbability;
+    uint64_t positions;     // 淶
+    uint64_t slots;         // ԶھΪ
+    uint64_t buckets;       // ϣͰÿͰһ 32 λƫ
+    uint64_t hashSeed;
+    double newGameScore;    // ¿һ֣飩÷
+    double newGameWin;      // ¿һֵʤ
+    uint32_t reserved[13];
+    uint32_t checksum;      // CRC32Cǰֶ
+};
+
+// Ϊ淶ʽ÷ָӸþܵõķз
+struct TablebaseEntry {
+    uint64_t board;
+    float expectedScore;
+    float winProbability;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TablebaseFileHeader) == 128 && sizeof(TablebaseEntry) == 16, "tablebase layout changed");
+
+// С̷һ 64 λУ row * Columns + col λڵ 4 * (row * Columns + col) λ
+// ԳƱ任ȫǰλҾÿһΣ·תÿһΣתãÿԽһ
+template <int Rows, int Columns>
+class SmallBoardSymmetry {
+public:
+    static_assert(Rows * Columns <= 16, "board does not fit in one word");
+
+    static constexpr int COUNT = Rows == Columns ? 8 : 4;
+
+    static constexpr uint64_t MirrorColumns(uint64_t x) {
+        uint64_t result = 0;
+        for (int col = 0; col < Columns; col++) {
+            result |= ((x >> (col * 4)) & COLUMN_MASK) << ((Columns - 1 - col) * 4);
+        }
+        return result;
+    }
+
+    static constexpr uint64_t FlipRows(uint64_t x) {
+        uint64_t result = 0;
+        for (int row = 0; row < Rows; row++) {
+            result |= ((x >> (row * ROW_BITS)) & ROW_MASK) << ((Rows - 1 - row) * ROW_BITS);
+        }
+        return result;
+    }
+
+    //  k Խߣcol - row = kϵĸתúƶ k * (N - 1) 
+    static constexpr uint64_t Transpose(uint64_t x) {
+        static_assert(Rows == Columns, "only square boards can be transposed");
+        uint64_t result = 0;
+        for (int k = 1 - Columns; k < Columns; k++) {
+            uint64_t cells = x & DiagonalMask(k);
+            int shift = k * (Columns - 1) * 4;
+            result |= shift >= 0 ? cells << shift : cells >> -shift;
+        }
+        return result;
+    }
+
+    //  BitBoard::Symmetries ͬıţbit0 Ҿbit1 ·תbit2 ת
+    static constexpr void Symmetries(uint64_t board, uint64_t variants[COUNT]) {
+        variants[0] = board;
+        variants[1] = MirrorColumns(board);
+        variants[2] = FlipRows(board);
+        variants[3] = FlipRows(variants[1]);
+        if constexpr (COUNT == 8) {
+            uint64_t transposed = Transpose(board);
+            variants[4] = transposed;
+            variants[5] = MirrorColumns(transposed);
+            variants[6] = FlipRows(transposed);
+            variants[7] = FlipRows(variants[5]);
+        }
+    }
+
+    static constexpr uint64_t Canonical(uint64_t board) {
+        uint64_t variants[COUNT] = {};
+        Symmetries(board, variants);
+        uint64_t best = variants[0];
+        for (int i = 1; i < COUNT; i++) {
+            if (variants[i] < best) best = variants[i];
+        }
+        return best;
+    }
+
+private:
+    static constexpr int ROW_BITS = Columns * 4;
+    static constexpr uint64_t ROW_MASK = (uint64_t(1) << ROW_BITS) - 1;
+
+    static constexpr uint64_t BuildColumnMask() {
+        uint64_t mask = 0;
+        for (int row = 0; row < Rows; row++) {
+            mask |= uint64_t(0xF) << (row * ROW_BITS);
+        }
+        return mask;
+    }
+
+    static constexpr uint64_t COLUMN_MASK = BuildColumnMask();
+
+    static constexpr uint64_t DiagonalMask(int k) {
+        uint64_t mask = 0;
+        for (int row = 0; row < Rows; row++) {
+            int col = row + k;
+            if (col >= 0 && col < Columns) {
+                mask |= uint64_t(0xF) << ((row * Columns + col) * 4);
+            }
+        }
+        return mask;
+    }
+};
+
+// PTHash ʽϣȰϣֵͰÿͰѡһƫӣpilot
+// ʹͰм mix(hash + pilot) ӳ䵽ͬδռõıͬһͰĹϣֵλͬ
+// »ϺȡλֻڵλͬκӶ䵽ͬһ
+struct TablebaseHash {
+    uint64_t seed;
+    uint64_t buckets;
+    uint64_t slots;
+    const uint32_t* pilots;
+
+    static uint64_t Reduce(uint64_t x, uint64_t range) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return __umulh(x, range);
+#else
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(x) * range) >> 64);
+#endif
+    }
+
+    uint64_t Hash(uint64_t key) const {
+        return SplitMix64(key ^ seed);
+    }
+
+    uint64_t Bucket(uint64_t hash) const {
+        return Reduce(hash, buckets);
+    }
+
+    static uint64_t Place(uint64_t hash, uint32_t pilot, uint64_t slotCount) {
+        return Reduce(SplitMix64(hash + pilot), slotCount);
+    }
+
+    uint64_t Slot(uint64_t key) const {
+        uint64_t hash = Hash(key);
+        return Place(hash, pilots[Bucket(hash)], slots);
+    }
+};
+
+// ÷֣ScoreʤʣWinѡ
+enum class TablebaseObjective {
+    Score,
+    Win
+};
+
+// ڴӳȫRules ʱһ£ʱʤɸ
+template <typename Rules>
+class BasicTablebase {
+public:
+    using Layout = typename Rules::Layout;
+    using Symmetry = SmallBoardSymmetry<Layout::ROWS, Layout::COLUMNS>;
+
+private:
+    MappedFile file;
+    TablebaseFileHeader header;
+    TablebaseHash hash;
+    const TablebaseEntry* entries;
+
+public:
+    explicit BasicTablebase(const std::string& path) : file(path), entries(nullptr) {
+        if (file.GetSize() < sizeof(TablebaseFileHeader)) {
+            throw std::runtime_error("not a tablebase: " + path);
+        }
+        memcpy(&header, file.GetData(), sizeof(header));
+        if (memcmp(header.magic, TABLEBASE_FILE_HEADER, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("not a tablebase: " + path);
+        }
+        if (header.version != TABLEBASE_FILE_VERSION) {
+            throw std::runtime_error("unsupported tablebase version");
+        }
+        if (header.checksum != Crc32c::Compute(&header, offsetof(TablebaseFileHeader, checksum)) ||
+            header.buckets == 0 || header.slots < header.positions ||
+            file.GetSize() != FileSize(header.buckets, header.slots)) {
+            throw std::runtime_error("corrupt tablebase header");
+        }
+        if (header.rows != Layout::ROWS || header.columns != Layout::COLUMNS ||
+            header.winExponent != Rules::WIN_EXPONENT || header.twoProbability != Rules::SpawnPolicy::TWO_PROBABILITY) {
+            throw std::runtime_error("tablebase was solved for different rules");
+        }
+
+        hash = { header.hashSeed, header.buckets, header.slots,
+            reinterpret_cast<const uint32_t*>(file.GetData() + sizeof(TablebaseFileHeader)) };
+        entries = reinterpret_cast<const TablebaseEntry*>(file.GetData() + EntriesOffset(header.buckets));
+        file.Prefetch();
+    }
+
+    BasicTablebase(const BasicTablebase&) = delete;
+    BasicTablebase& operator=(const BasicTablebase&) = delete;
+
+    const TablebaseFileHeader& GetHeader() const { return header; }
+
+    static size_t EntriesOffset(uint64_t buckets) {
+        return sizeof(TablebaseFileHeader) + static_cast<size_t>((buckets * sizeof(uint32_t) + 15) / 16 * 16);
+    }
+
+    static size_t FileSize(uint64_t buckets, uint64_t slots) {
+        return EntriesOffset(buckets) + static_cast<size_t>(slots) * sizeof(TablebaseEntry);
+    }
+
+    // ѯ棨ǹ淶ʽɴľ淵 false
+    bool Lookup(uint64_t board, TablebaseEntry& entry) const {
+        uint64_t canonical = Symmetry::Canonical(board);
+        const TablebaseEntry& slot = entries[hash.Slot(canonical)];
+        if (slot.board != canonical) {
+            return false;
+        }
+        entry = slot;
+        return true;
+    }
+
+    // һѡŷ÷ּɽļȨֵ治ɴ·ʱ false
+    bool BestMove(uint64_t board, TablebaseObjective objective, Direction& move, double* value = nullptr) const {
+        bool found = false;
+        double best = 0.0;
+        for (int i = 0; i < DIRECTION_COUNT; i++) {
+            typename Layout::MoveResult result = Layout::Move(board, static_cast<Direction>(i));
+            if (!result.moved) continue;
+
+            double expected = 0.0;
+            if (!ExpectAfterMove(result.board, objective, expected)) {
+                return false;
+            }
+            if (objective == TablebaseObjective::Score) {
+                expected += result.score;
+            }
+            if (!found || expected > best) {
+                found = true;
+                best = expected;
+                move = static_cast<Direction>(i);
+            }
+        }
+        if (value) *value = best;
+        return found;
+    }
+
+private:
+    bool ExpectAfterMove(uint64_t afterstate, TablebaseObjective objective, double& expected) const {
+        typename Layout::EmptyCells empty = Layout::FindEmpty(afterstate);
+        int count = Layout::CountCells(empty);
+        double two = Rules::SpawnPolicy::TWO_PROBABILITY;
+        expected = 0.0;
+        for (int i = 0; i < count; i++) {
+            for (int exponent = 1; exponent <= 2; exponent++) {
+                double weight = exponent == 1 ? two : 1.0 - two;
+                if (weight == 0.0) continue;
+
+                uint64_t child = afterstate;
+                Layout::PlaceTile(child, empty, i, exponent);
+                TablebaseEntry entry;
+                if (!Lookup(child, entry)) {
+                    return false;
+                }
+                expected += weight * (objective == TablebaseObjective::Score ? entry.expectedScore : entry.winProbability);
+            }
+        }
+        expected /= count;
+        return true;
+    }
+};
+
+// ܺͷֲö١ϣƹֵд BasicTablebase ӳļ
+// ÿƶɷܺ 2  4Ժ̾ڸߵĲ㣬ʱÿֻĲ
+template <typename Rules>
+class TablebaseSolver {
+public:
+    using Layout = typename Rules::Layout;
+    using Symmetry = SmallBoardSymmetry<Layout::ROWS, Layout::COLUMNS>;
+    using Table = BasicTablebase<Rules>;
+
+    static constexpr int CELLS = Layout::CELLS;
+
+private:
+    static const size_t CHUNK = 4096;   // ÿľ
+    static constexpr double LOAD_FACTOR = 0.97;
+    static constexpr double BUCKET_SIZE = 4.0;
+
+    WorkStealingPool& pool;
+    std::vector<std::vector<uint64_t>> layers;  // layers[k] Ϊܺ͵ 2k Ĺ淶棬ȥ
+    uint64_t positions;
+    bool verbose;
+
+public:
+    explicit TablebaseSolver(WorkStealingPool& taskPool, bool printProgress = false)
+        : pool(taskPool), positions(0), verbose(printProgress) {
+    }
+
+    uint64_t GetPositionCount() const { return positions; }
+
+    // Ⲣд pathڴ˳дֱڹӳдں˷дҳ
+    // дʱļٸ
+    void Solve(const std::string& path) {
+        Enumerate();
+
+        std::vector<uint32_t> pilots;
+        uint64_t seed = 0;
+        uint64_t slots = 0;
+        BuildHash(pilots, seed, slots);
+        uint64_t buckets = pilots.size();
+        TablebaseHash hash = { seed, buckets, slots, pilots.data() };
+
+        std::vector<TablebaseEntry> entries(slots, TablebaseEntry{ TABLEBASE_EMPTY_SLOT, 0.0f, 0.0f });
+        for (const std::vector<uint64_t>& layer : layers) {
+            for (uint64_t board : layer) {
+                entries[hash.Slot(board)].board = board;
+            }
+        }
+        Retrograde(hash, entries.data());
+        layers.clear();
+        layers.shrink_to_fit();
+
+        TablebaseFileHeader header = {};
+        memcpy(header.magic, TABLEBASE_FILE_HEADER, sizeof(header.magic));
+        header.version = TABLEBASE_FILE_VERSION;
+        header.rows = static_cast<uint8_t>(Layout::ROWS);
+        header.columns = static_cast<uint8_t>(Layout::COLUMNS);
+        header.winExponent = static_cast<uint8_t>(Rules::WIN_EXPONENT);
+        header.twoProbability = Rules::SpawnPolicy::TWO_PROBABILITY;
+        header.positions = positions;
+        header.slots = slots;
+        header.buckets = buckets;
+        header.hashSeed = seed;
+        NewGameValue(hash, entries.data(), header.newGameScore, header.newGameWin);
+        header.checksum = Crc32c::Compute(&header, offsetof(TablebaseFileHeader, checksum));
+
+        std::string temporary = path + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                throw std::runtime_error("cannot write " + temporary);
+            }
+
+            const char padding[16] = {};
+            size_t pilotBytes = pilots.size() * sizeof(uint32_t);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(pilots.data()), pilotBytes);
+            out.write(padding, Table::EntriesOffset(buckets) - sizeof(header) - pilotBytes);
+            out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(TablebaseEntry));
+            out.flush();
+            if (out.fail()) {
+                out.close();
+                std::remove(temporary.c_str());
+                throw std::runtime_error("failed writing " + temporary);
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("cannot replace " + path + ": " + error.message());
+        }
+    }
+
+private:
+    static int LayerOf(uint64_t board) {
+        int sum = 0;
+        for (int i = 0; i < CELLS; i++) {
+            int exponent = static_cast<int>((board >> (i * 4)) & 0xF);
+            if (exponent) sum += 1 << exponent;
+        }
+        return sum / 2;
+    }
+
+    static void SortUnique(std::vector<uint64_t>& boards) {
+        std::sort(boards.begin(), boards.end());
+        boards.erase(std::unique(boards.begin(), boards.end()), boards.end());
+    }
+
+    // һ㰴鲢ִ task(begin, end)
+    template <typename Task>
+    void ForChunks(size_t count, Task task) {
+        TaskGroup group(pool);
+        for (size_t begin = 0; begin < count; begin += CHUNK) {
+            size_t end = (std::min)(count, begin + CHUNK);
+            group.Run([&task, begin, end]() { task(begin, end); });
+        }
+        group.Wait();
+    }
+
+    // ȫ鿪ֳչÿڱȥأٲ
+    void Enumerate() {
+        layers.assign(1, {});
+        for (int a = 0; a < CELLS; a++) {
+            for (int b = a + 1; b < CELLS; b++) {
+                for (int ea = 1; ea <= 2; ea++) {
+                    for (int eb = 1; eb <= 2; eb++) {
+                        uint64_t board = (uint64_t(ea) << (a * 4)) | (uint64_t(eb) << (b * 4));
+                        AddToLayer(Symmetry::Canonical(board), LayerOf(board));
+                    }
+                }
+            }
+        }
+
+        positions = 0;
+        std::mutex merge;
+        for (size_t k = 0; k < layers.size(); k++) {
+            SortUnique(layers[k]);
+            layers[k].shrink_to_fit();
+            positions += layers[k].size();
+            if (layers[k].empty()) continue;
+
+            // ú㣬ڼ layers ·
+            if (layers.size() < k + 3) layers.resize(k + 3);
+            const std::vector<uint64_t>& layer = layers[k];
+
+            ForChunks(layer.size(), [&](size_t begin, size_t end) {
+                std::vector<uint64_t> next[2];
+                for (size_t i = begin; i < end; i++) {
+                    for (int d = 0; d < DIRECTION_COUNT; d++) {
+                        typename Layout::MoveResult result = Layout::Move(layer[i], static_cast<Direction>(d));
+                        if (!result.moved) continue;
+
+                        for (int cell = 0; cell < CELLS; cell++) {
+                            if ((result.board >> (cell * 4)) & 0xF) continue;
+                            for (int exponent = 1; exponent <= 2; exponent++) {
+                                next[exponent - 1].push_back(Symmetry::Canonical(result.board | (uint64_t(exponent) << (cell * 4))));
+                            }
+                        }
+                    }
+                }
+
+                for (int e = 0; e < 2; e++) {
+                    SortUnique(next[e]);
+                }
+                std::lock_guard<std::mutex> lock(merge);
+                for (int e = 0; e < 2; e++) {
+                    layers[k + 1 + e].insert(layers[k + 1 + e].end(), next[e].begin(), next[e].end());
+                }
+            });
+
+            if (verbose && k % 64 == 0) {
+                fprintf(stderr, "enumerate: sum %zu, %llu positions\n", k * 2, static_cast<unsigned long long>(positions));
+            }
+        }
+        while (!layers.empty() && layers.back().empty()) {
+            layers.pop_back();
+        }
+    }
+
+    void AddToLayer(uint64_t board, int layer) {
+        if (layers.size() <= static_cast<size_t>(layer)) layers.resize(layer + 1);
+        layers[layer].push_back(board);
+    }
+
+    // ϣֵͬһͰļУͰó˷ȡλԹϣֵͰȷá
+    //  64 λϣȫͬʱ޷֣һؽ
+    void BuildHash(std::vector<uint32_t>& pilots, uint64_t& seed, uint64_t& slots) {
+        uint64_t buckets = static_cast<uint64_t>(positions / BUCKET_SIZE) + 1;
+        slots = static_cast<uint64_t>(positions / LOAD_FACTOR) + 1;
+
+        for (seed = 0x243F6A8885A308D3ULL;; seed = SplitMix64(seed)) {
+            TablebaseHash hash = { seed, buckets, slots, nullptr };
+            std::vector<uint64_t> hashes;
+            hashes.reserve(positions);
+            for (const std::vector<uint64_t>& layer : layers) {
+                for (uint64_t board : layer) {
+                    hashes.push_back(hash.Hash(board));
+                }
+            }
+            std::sort(hashes.begin(), hashes.end());
+            if (std::adjacent_find(hashes.begin(), hashes.end()) != hashes.end()) {
+                continue;
+            }
+
+            // ÿͰ hashes е㣬ͰСӴС
+            std::vector<uint64_t> starts(buckets + 1, 0);
+            for (uint64_t value : hashes) {
+                starts[hash.Bucket(value) + 1]++;
+            }
+            size_t largest = 0;
+            for (uint64_t b = 0; b < buckets; b++) {
+                largest = (std::max)(largest, static_cast<size_t>(starts[b + 1]));
+                starts[b + 1] += starts[b];
+            }
+            std::vector<std::vector<uint64_t>> bySize(largest + 1);
+            for (uint64_t b = 0; b < buckets; b++) {
+                bySize[starts[b + 1] - starts[b]].push_back(b);
+            }
+
+            pilots.assign(buckets, 0);
+            std::vector<uint64_t> taken((slots + 63) / 64, 0);
+            std::vector<uint64_t> placed;
+            bool complete = true;
+            for (size_t size = largest; size > 0 && complete; size--) {
+                for (size_t i = 0; i < bySize[size].size() && complete; i++) {
+                    uint64_t b = bySize[size][i];
+                    complete = FindPilot(&hashes[starts[b]], size, slots, taken, placed, pilots[b]);
+                }
+            }
+            if (complete) return;
+        }
+    }
+
+    // ԴޣҲʱɵ߻ؽ
+    static bool FindPilot(const uint64_t* hashes, size_t count, uint64_t slots,
+        std::vector<uint64_t>& taken, std::vector<uint64_t>& placed, uint32_t& pilot) {
+        for (pilot = 0; pilot < (1u << 24); pilot++) {
+            placed.clear();
+            bool free = true;
+            for (size_t i = 0; i < count && free; i++) {
+                uint64_t slot = TablebaseHash::Place(hashes[i], pilot, slots);
+                free = !((taken[slot / 64] >> (slot % 64)) & 1) &&
+                    std::find(placed.begin(), placed.end(), slot) == placed.end();
+                placed.push_back(slot);
+            }
+            if (!free) continue;
+
+            for (uint64_t slot : placed) {
+                taken[slot / 64] |= uint64_t(1) << (slot % 64);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    static void Evaluate(uint64_t board, const TablebaseHash& hash, const TablebaseEntry* entries,
+        double& score, double& win) {
+        score = 0.0;
+        win = Layout::MaxExponent(board) >= Rules::WIN_EXPONENT ? 1.0 : 0.0;
+        bool winFixed = win == 1.0;
+        double two = Rules::SpawnPolicy::TWO_PROBABILITY;
+
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            typename Layout::MoveResult result = Layout::Move(board, static_cast<Direction>(d));
+            if (!result.moved) continue;
+
+            double moveScore = 0.0;
+            double moveWin = 0.0;
+            int empty = 0;
+            for (int cell = 0; cell < CELLS; cell++) {
+                if ((result.board >> (cell * 4)) & 0xF) continue;
+                empty++;
+                for (int exponent = 1; exponent <= 2; exponent++) {
+                    double weight = exponent == 1 ? two : 1.0 - two;
+                    if (weight == 0.0) continue;
+
+                    uint64_t child = Symmetry::Canonical(result.board | (uint64_t(exponent) << (cell * 4)));
+                    const TablebaseEntry& entry = entries[hash.Slot(child)];
+                    moveScore += weight * entry.expectedScore;
+                    moveWin += weight * entry.winProbability;
+                }
+            }
+            score = (std::max)(score, result.score + moveScore / empty);
+            if (!winFixed) win = (std::max)(win, moveWin / empty);
+        }
+    }
+
+    void Retrograde(const TablebaseHash& hash, TablebaseEntry* entries) {
+        for (size_t k = layers.size(); k-- > 0;) {
+            const std::vector<uint64_t>& layer = layers[k];
+            ForChunks(layer.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    double score = 0.0;
+                    double win = 0.0;
+                    Evaluate(layer[i], hash, entries, score, win);
+                    TablebaseEntry& entry = entries[hash.Slot(layer[i])];
+                    entry.expectedScore = static_cast<float>(score);
+                    entry.winProbability = static_cast<float>(win);
+                }
+            });
+            if (verbose && k % 64 == 0) {
+                fprintf(stderr, "retrograde: sum %zu\n", k * 2);
+            }
+        }
+    }
+
+    //  NewGame  AddRandomTile 󿪾ֲַ
+    static void NewGameValue(const TablebaseHash& hash, const TablebaseEntry* entries, double& score, double& win) {
+        double two = Rules::SpawnPolicy::TWO_PROBABILITY;
+        score = 0.0;
+        win = 0.0;
+        for (int a = 0; a < CELLS; a++) {
+            for (int b = 0; b < CELLS; b++) {
+                if (a == b) continue;
+                for (int ea = 1; ea <= 2; ea++) {
+                    for (int eb = 1; eb <= 2; eb++) {
+                        double weight = (ea == 1 ? two : 1.0 - two) * (eb == 1 ? two : 1.0 - two) / (CELLS * (CELLS - 1.0));
+                        if (weight == 0.0) continue;
+
+                        uint64_t board = Symmetry::Canonical((uint64_t(ea) << (a * 4)) | (uint64_t(eb) << (b * 4)));
+                        const TablebaseEntry& entry = entries[hash.Slot(board)];
+                        score += weight * entry.expectedScore;
+                        win += weight * entry.winProbability;
+                    }
+                }
+            }
+        }
+    }
+};
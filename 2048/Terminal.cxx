@@ -0,0 +1,506 @@
+// նǰˣ SSH ûдϵͳĻۿԾ֣ GUI ͬ
+// ÿֻ֡ѱ仯ӵתƴһһ write д
+// 룺g++ -std=c++20 -O2 -DNDEBUG -pthread Terminal.cxx -o terminal
+
+#include "ParallelSearch.h"
+#include "TerminalScreen.h"
+#include "UndoHistory.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int AUTOPLAY_INTERVAL_MS = 100;
+const int ESCAPE_TIMEOUT_MS = 25;     // תǰ׺֮ȴֽڵʱޣն˷ķͨһε
+
+struct TerminalOptions {
+    uint64_t seed = 0;          // 0 ʾ
+    bool autoplay = false;      // ǽģʽ̶֡ʰԶϷ׼
+    int fps = 10;
+    int moves = 0;              // ǽģʽߵĲ0 ʾֱϷ
+    int depth = 0;              // 0 ʾԶѡ
+    int threads = 0;
+    std::string tracePath;      // GAME_PROFILE˳ʱд Chrome ٵ·
+    std::string cachePath;      // ʾԶϷõĳ־ûֵ棬Ϊʱ
+    std::string heuristicPath;  // ֵ̬ȨãΪʱĬȨ
+};
+
+enum class Command {
+    None,
+    Left,
+    Right,
+    Up,
+    Down,
+    Hint,
+    AutoPlay,
+    Undo,
+    Redo,
+    NewGame,
+    Quit
+};
+
+static volatile sig_atomic_t quitRequested = 0;
+static volatile sig_atomic_t resized = 0;
+
+static void HandleSignal(int signal) {
+    if (signal == SIGWINCH) resized = 1;
+    else quitRequested = 1;
+}
+
+//  SA_RESTARTźŵʱ poll 
+static void InstallSignalHandlers() {
+    struct sigaction action = {};
+    action.sa_handler = HandleSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    sigaction(SIGWINCH, &action, nullptr);
+}
+
+static void WriteAll(const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = write(STDOUT_FILENO, data.data() + written, data.size() - written);
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("failed writing to terminal");
+        }
+        written += static_cast<size_t>(result);
+    }
+}
+
+// ԭʼģʽرлԣ Ctrl-CлĻع꣬ʱȫָ
+class RawTerminal {
+private:
+    termios original;
+
+public:
+    RawTerminal() {
+        if (tcgetattr(STDIN_FILENO, &original) != 0) {
+            throw std::runtime_error("standard input is not a terminal");
+        }
+
+        termios raw = original;
+        raw.c_iflag &= ~(IXON | ICRNL);
+        raw.c_lflag &= ~(ICANON | ECHO | IEXTEN);
+        raw.c_cc[VMIN] = 0;
+        raw.c_cc[VTIME] = 0;
+        if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) {
+            throw std::runtime_error("cannot switch terminal to raw mode");
+        }
+        WriteAll("\x1b[?1049h\x1b[?25l");
+    }
+
+    ~RawTerminal() {
+        try {
+            WriteAll("\x1b[0m\x1b[?25h\x1b[?1049l");
+        }
+        catch (const std::exception&) {
+        }
+        tcsetattr(STDIN_FILENO, TCSAFLUSH, &original);
+    }
+
+    RawTerminal(const RawTerminal&) = delete;
+    RawTerminal& operator=(const RawTerminal&) = delete;
+};
+
+// һ read õֽڽΪCSI  SS3 ʽWASD  GUI ĸݼ
+// ֻнβǷǰ׺ ESCESC [ESC O ´Σ ESC ֱ
+static size_t DecodeKeys(const char* data, size_t length, std::vector<Command>& commands) {
+    size_t i = 0;
+    while (i < length) {
+        if (data[i] == '\x1b') {
+            bool introducer = i + 1 < length && (data[i + 1] == '[' || data[i + 1] == 'O');
+            if (i + 1 == length || (introducer && i + 2 == length)) break;
+            if (introducer) {
+                switch (data[i + 2]) {
+                case 'A': commands.push_back(Command::Up); break;
+                case 'B': commands.push_back(Command::Down); break;
+                case 'C': commands.push_back(Command::Right); break;
+                case 'D': commands.push_back(Command::Left); break;
+                default: break;
+                }
+                i += 3;
+                continue;
+            }
+            i++;
+            continue;
+        }
+
+        switch (toupper(static_cast<unsigned char>(data[i]))) {
+        case 'A': commands.push_back(Command::Left); break;
+        case 'D': commands.push_back(Command::Right); break;
+        case 'W': commands.push_back(Command::Up); break;
+        case 'S': commands.push_back(Command::Down); break;
+        case 'H': commands.push_back(Command::Hint); break;
+        case 'P': commands.push_back(Command::AutoPlay); break;
+        case 'Z': commands.push_back(Command::Undo); break;
+        case 'Y': commands.push_back(Command::Redo); break;
+        case 'N': commands.push_back(Command::NewGame); break;
+        case 'Q': commands.push_back(Command::Quit); break;
+        default: break;
+        }
+        i++;
+    }
+    return i;
+}
+
+//  GUI  Game2048 ͬϷ̣ƶɷ鲢볷ʷʾԶϷʹò
+class TerminalGame {
+private:
+    GameEngine engine;
+    WorkStealingPool pool;
+    ParallelExpectimax solver;
+    std::unique_ptr<EvaluationCache> cache;
+    UndoHistory history;
+    int depth;
+    int hintDirection;
+    bool autoPlay;
+
+public:
+    TerminalGame(uint64_t seed, int threads, int searchDepth, const std::string& cachePath)
+        : engine(seed), pool(threads), solver(pool),
+        history(1024, std::filesystem::temp_directory_path() / ("2048-undo-" + std::to_string(getpid()))),
+        depth(searchDepth), hintDirection(-1), autoPlay(false) {
+        if (!cachePath.empty()) {
+            cache = std::make_unique<EvaluationCache>(cachePath, 64, ExpectimaxSearch::EvaluatorId());
+            solver.SetCache(cache.get());
+        }
+        NewGame();
+    }
+
+    void NewGame() {
+        hintDirection = -1;
+        engine.NewGame();
+        history.Reset(UndoHistory::MakeEntry(engine));
+    }
+
+    bool IsAutoPlaying() const { return autoPlay; }
+    bool IsGameOver() const { return engine.IsGameOver(); }
+
+    RenderState GetState() const {
+        return { engine.GetBoard(), engine.GetScore(), hintDirection, engine.IsGameOver(), engine.IsWon() };
+    }
+
+    // ػǷҪ£Quit ɵ÷
+    bool Handle(Command command) {
+        PROFILE_ZONE("HandleKeyPress");
+        switch (command) {
+        case Command::Undo:
+        case Command::Redo:
+            return StepHistory(command == Command::Redo);
+        case Command::NewGame:
+            autoPlay = false;
+            NewGame();
+            return true;
+        case Command::AutoPlay:
+            autoPlay = !autoPlay;
+            return true;
+        default:
+            break;
+        }
+
+        if (engine.IsGameOver()) return false;
+
+        bool moved = false;
+        switch (command) {
+        case Command::Left: moved = engine.MoveLeft(); break;
+        case Command::Right: moved = engine.MoveRight(); break;
+        case Command::Up: moved = engine.MoveUp(); break;
+        case Command::Down: moved = engine.MoveDown(); break;
+        case Command::Hint:
+        {
+            SearchResult best = solver.BestMove(engine.GetBoard(), depth);
+            hintDirection = best.found ? static_cast<int>(best.move) : -1;
+            return true;
+        }
+        default:
+            return false;
+        }
+
+        if (moved) {
+            hintDirection = -1;
+            engine.AddRandomTile();
+            engine.CheckGameOver();
+            history.Push(UndoHistory::MakeEntry(engine));
+        }
+        return moved;
+    }
+
+    bool AutoPlayStep() {
+        PROFILE_ZONE("AutoPlayStep");
+        hintDirection = -1;
+        if (solver.PlayMove(engine, depth)) {
+            history.Push(UndoHistory::MakeEntry(engine));
+            return true;
+        }
+        autoPlay = false;
+        return false;
+    }
+
+private:
+    bool StepHistory(bool redo) {
+        autoPlay = false;
+        HistoryEntry state;
+        if (redo ? history.Redo(state) : history.Undo(state)) {
+            UndoHistory::ApplyEntry(state, engine);
+            hintDirection = -1;
+            return true;
+        }
+        return false;
+    }
+};
+
+// ѵǰ״̬д죬дֽ
+static size_t PresentFrame(TerminalScreen& screen, const RenderState& state, const char* status, std::string& out) {
+    PROFILE_ZONE("Draw");
+    TerminalView::Draw(screen, state, status);
+    out.clear();
+    screen.Present(out);
+    if (!out.empty()) {
+        WriteAll(out);
+    }
+    return out.size();
+}
+
+static double Percentile(std::vector<double>& samples, double fraction) {
+    if (samples.empty()) return 0.0;
+    size_t index = static_cast<size_t>(fraction * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+static int RunInteractive(const TerminalOptions& options) {
+    const char* HELP = "Arrows/WASD move  H hint  P auto  Z/Y undo/redo  N new  Q quit";
+    const char* AUTOPLAY_HELP = "Autoplay on: P to stop, Q to quit";
+
+    TerminalGame game(options.seed, options.threads, options.depth, options.cachePath);
+    TerminalScreen screen(TERMINAL_SCREEN_COLUMNS, TERMINAL_SCREEN_ROWS);
+    std::string out;
+    out.reserve(64 * 1024);
+
+    std::vector<double> latencies;  // Ӷ֡д΢
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    {
+        RawTerminal raw;
+        auto status = [&]() { return game.IsAutoPlaying() ? AUTOPLAY_HELP : HELP; };
+        bytes += PresentFrame(screen, game.GetState(), status(), out);
+        frames++;
+
+        char input[256];
+        size_t pending = 0;
+        auto escapeDeadline = std::chrono::steady_clock::time_point::max();
+        std::vector<Command> commands;
+        auto nextStep = std::chrono::steady_clock::now();
+        while (!quitRequested) {
+            int timeout = -1;
+            if (game.IsAutoPlaying()) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextStep - std::chrono::steady_clock::now());
+                timeout = static_cast<int>(std::max<int64_t>(0, wait.count()));
+            }
+            // ŵתǰ׺ʱûеȵֽڣǵµ Esc Alt ϼ
+            if (pending > 0) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    escapeDeadline - std::chrono::steady_clock::now());
+                int escapeTimeout = static_cast<int>(std::max<int64_t>(0, wait.count()));
+                timeout = timeout < 0 ? escapeTimeout : (std::min)(timeout, escapeTimeout);
+            }
+
+            pollfd descriptor = { STDIN_FILENO, POLLIN, 0 };
+            int ready = poll(&descriptor, 1, timeout);
+            if (ready < 0 && errno != EINTR) {
+                throw std::runtime_error("poll failed");
+            }
+
+            bool redraw = false;
+            if (resized) {
+                resized = 0;
+                screen.Invalidate();
+                redraw = true;
+            }
+
+            auto received = std::chrono::steady_clock::now();
+            if (pending > 0 && ready == 0 && received >= escapeDeadline) {
+                pending = 0;
+            }
+            if (ready > 0 && (descriptor.revents & POLLIN)) {
+                ssize_t count = read(STDIN_FILENO, input + pending, sizeof(input) - pending);
+                if (count > 0) {
+                    size_t length = pending + static_cast<size_t>(count);
+                    commands.clear();
+                    size_t used = DecodeKeys(input, length, commands);
+                    if (length - used > 0 && pending == 0) {
+                        escapeDeadline = received + std::chrono::milliseconds(ESCAPE_TIMEOUT_MS);
+                    }
+                    pending = length - used;
+                    memmove(input, input + used, pending);
+
+                    bool wasAutoPlaying = game.IsAutoPlaying();
+                    for (Command command : commands) {
+                        if (command == Command::Quit) {
+                            quitRequested = 1;
+                            break;
+                        }
+                        redraw |= game.Handle(command);
+                    }
+                    if (game.IsAutoPlaying() && !wasAutoPlaying) {
+                        nextStep = received;
+                    }
+
+                    if (redraw && !quitRequested) {
+                        bytes += PresentFrame(screen, game.GetState(), status(), out);
+                        frames++;
+                        latencies.push_back(std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - received).count());
+                        redraw = false;
+                    }
+                }
+            }
+
+            if (game.IsAutoPlaying() && std::chrono::steady_clock::now() >= nextStep) {
+                game.AutoPlayStep();
+                nextStep += std::chrono::milliseconds(AUTOPLAY_INTERVAL_MS);
+                redraw = true;
+            }
+
+            if (redraw && !quitRequested) {
+                bytes += PresentFrame(screen, game.GetState(), status(), out);
+                frames++;
+            }
+        }
+    }
+
+    fprintf(stderr, "frames      : %llu, %.0f bytes per frame\n", static_cast<unsigned long long>(frames),
+        frames ? static_cast<double>(bytes) / frames : 0.0);
+    if (!latencies.empty()) {
+        double p50 = Percentile(latencies, 0.5);
+        double p99 = Percentile(latencies, 0.99);
+        double worst = *std::max_element(latencies.begin(), latencies.end());
+        fprintf(stderr, "key latency : p50 %.0f us, p99 %.0f us, max %.0f us\n", p50, p99, worst);
+    }
+    return 0;
+}
+
+// ǽģʽȡ룬̶֡ԶϷÿһ׼Բն
+static int RunAutoplay(const TerminalOptions& options) {
+    TerminalGame game(options.seed, options.threads, options.depth, options.cachePath);
+    TerminalScreen screen(TERMINAL_SCREEN_COLUMNS, TERMINAL_SCREEN_ROWS);
+    std::string out;
+    out.reserve(64 * 1024);
+
+    auto period = std::chrono::microseconds(1000000 / options.fps);
+    auto nextFrame = std::chrono::steady_clock::now();
+    uint64_t bytes = 0;
+    int moves = 0;
+    char status[64];
+
+    WriteAll("\x1b[?25l");
+    while (!quitRequested) {
+        snprintf(status, sizeof(status), "Autoplay: move %d", moves);
+        bytes += PresentFrame(screen, game.GetState(), status, out);
+
+        if (game.IsGameOver() || (options.moves > 0 && moves >= options.moves)) break;
+
+        // ʱ֡ʱӵǰʱ¼ʱ֡
+        nextFrame += period;
+        if (!game.AutoPlayStep()) break;
+        moves++;
+        auto now = std::chrono::steady_clock::now();
+        if (nextFrame < now) {
+            nextFrame = now;
+        }
+        std::this_thread::sleep_until(nextFrame);
+    }
+
+    char tail[32];
+    snprintf(tail, sizeof(tail), "\x1b[%d;1H\x1b[?25h\n", TERMINAL_SCREEN_ROWS);
+    WriteAll(tail);
+    fprintf(stderr, "moves       : %d, score %d, %.0f bytes per frame\n", moves, game.GetState().score,
+        static_cast<double>(bytes) / (moves + 1));
+    return 0;
+}
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr,
+        "usage: %s [--seed N] [--depth N] [--threads N] [--cache FILE] [--heuristic FILE] [--trace FILE]\n"
+        "       %s --autoplay 1 [--fps N] [--moves N] [--seed N] [--depth N] [--threads N] [--cache FILE]\n"
+        "          [--heuristic FILE] [--trace FILE]\n",
+        program, program);
+}
+
+int main(int argc, char** argv) {
+    TerminalOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        if (strcmp(arg, "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--autoplay") == 0) options.autoplay = atoi(value) != 0;
+        else if (strcmp(arg, "--fps") == 0) options.fps = atoi(value);
+        else if (strcmp(arg, "--moves") == 0) options.moves = atoi(value);
+        else if (strcmp(arg, "--depth") == 0) options.depth = atoi(value);
+        else if (strcmp(arg, "--threads") == 0) options.threads = atoi(value);
+        else if (strcmp(arg, "--trace") == 0) options.tracePath = value;
+        else if (strcmp(arg, "--cache") == 0) options.cachePath = value;
+        else if (strcmp(arg, "--heuristic") == 0) options.heuristicPath = value;
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    if (options.fps <= 0 || options.fps > 1000 || options.moves < 0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+#if !defined(GAME_PROFILE)
+    if (!options.tracePath.empty()) {
+        fprintf(stderr, "--trace needs a build with -DGAME_PROFILE\n");
+        return 1;
+    }
+#endif
+    if (options.seed == 0) {
+        options.seed = (static_cast<uint64_t>(std::random_device()()) << 32) | std::random_device()();
+    }
+
+    InstallSignalHandlers();
+    try {
+        Heuristic::LoadActive(options.heuristicPath);
+        int result = options.autoplay ? RunAutoplay(options) : RunInteractive(options);
+#if defined(GAME_PROFILE)
+        fprintf(stderr, "\n%s", Profiler::Get().FormatSummary().c_str());
+        if (!options.tracePath.empty()) {
+            Profiler::Get().WriteChromeTrace(options.tracePath);
+        }
+#endif
+        return result;
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "terminal failed: %s\n", e.what());
+        return 1;
+    }
+}
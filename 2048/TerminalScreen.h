@@ -0,0 +1,211 @@
+#pragma once
+
+#include "SoftwareRenderer.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// նַһ ASCII ַǰɫ0xAARRGGBB0 ʾնĬɫ
+struct TerminalCell {
+    char ch;
+    uint32_t foreground;
+    uint32_t background;
+
+    bool operator==(const TerminalCell& other) const {
+        return ch == other.ch && foreground == other.foreground && background == other.background;
+    }
+    bool operator!=(const TerminalCell& other) const { return !(*this == other); }
+};
+
+const uint32_t TERMINAL_DEFAULT_COLOR = 0;
+
+// ˫նַ񣺻ֻĺ̨壬Present һǰ̨Ƚϣ
+// ֻΪ仯ĸɹƶɫлַ׷ӵһַɵ÷һд
+class TerminalScreen {
+private:
+    int width;
+    int height;
+    std::vector<TerminalCell> front;    // նϵǰʾ
+    std::vector<TerminalCell> back;     // һ֡
+    bool cleared;                       // false ʱһ֡ػȫ
+
+public:
+    TerminalScreen(int columns, int rows)
+        : width(columns), height(rows),
+        front(static_cast<size_t>(columns) * rows), back(static_cast<size_t>(columns) * rows), cleared(false) {
+        Clear();
+    }
+
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+
+    // նݲţ細ڴСı䣩ʱãһ֡ȫػ
+    void Invalidate() {
+        cleared = false;
+    }
+
+    void Clear() {
+        for (TerminalCell& cell : back) {
+            cell = { ' ', TERMINAL_DEFAULT_COLOR, TERMINAL_DEFAULT_COLOR };
+        }
+    }
+
+    void Fill(int x, int y, int columns, int rows, uint32_t background) {
+        for (int row = y; row < y + rows; row++) {
+            for (int col = x; col < x + columns; col++) {
+                Put(col, row, ' ', TERMINAL_DEFAULT_COLOR, background);
+            }
+        }
+    }
+
+    void Put(int x, int y, char ch, uint32_t foreground, uint32_t background) {
+        if (x < 0 || y < 0 || x >= width || y >= height) return;
+        back[static_cast<size_t>(y) * width + x] = { ch, foreground, background };
+    }
+
+    void Print(int x, int y, const char* text, uint32_t foreground, uint32_t background) {
+        for (int i = 0; text[i]; i++) {
+            Put(x + i, y, text[i], foreground, background);
+        }
+    }
+
+    // ֮֡ĲΪ ANSI ת׷ӵ outر仯ĸ
+    int Present(std::string& out) {
+        int changed = 0;
+        int cursorX = -1;
+        int cursorY = -1;
+        uint32_t foreground = 1;    // ֵܳɫ֤һɫ
+        uint32_t background = 1;
+
+        if (!cleared) {
+            out += "\x1b[0m\x1b[2J";
+        }
+
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                size_t index = static_cast<size_t>(y) * width + x;
+                const TerminalCell& cell = back[index];
+                if (cleared && cell == front[index]) continue;
+                if (!cleared && cell == TerminalCell{ ' ', TERMINAL_DEFAULT_COLOR, TERMINAL_DEFAULT_COLOR }) {
+                    front[index] = cell;
+                    continue;
+                }
+
+                if (x != cursorX || y != cursorY) {
+                    AppendFormat(out, "\x1b[%d;%dH", y + 1, x + 1);
+                }
+                if (cell.foreground != foreground || cell.background != background) {
+                    AppendColors(out, cell.foreground, cell.background);
+                    foreground = cell.foreground;
+                    background = cell.background;
+                }
+                out += cell.ch;
+                cursorX = x + 1;
+                cursorY = y;
+                front[index] = cell;
+                changed++;
+            }
+        }
+
+        // ֡ʱָĬɫӰնϵ
+        if (changed > 0 && (foreground != TERMINAL_DEFAULT_COLOR || background != TERMINAL_DEFAULT_COLOR)) {
+            out += "\x1b[0m";
+        }
+        cleared = true;
+        return changed;
+    }
+
+private:
+    static void AppendFormat(std::string& out, const char* format, int a, int b) {
+        char buffer[32];
+        int length = snprintf(buffer, sizeof(buffer), format, a, b);
+        out.append(buffer, length);
+    }
+
+    // 24 λɫ
+    static void AppendColors(std::string& out, uint32_t foreground, uint32_t background) {
+        char buffer[64];
+        int length = 0;
+        buffer[length++] = '\x1b';
+        buffer[length++] = '[';
+        length += ColorCode(buffer + length, foreground, 38);
+        buffer[length++] = ';';
+        length += ColorCode(buffer + length, background, 48);
+        buffer[length++] = 'm';
+        out.append(buffer, length);
+    }
+
+    static int ColorCode(char* buffer, uint32_t color, int base) {
+        if (color == TERMINAL_DEFAULT_COLOR) {
+            return snprintf(buffer, 8, "%d", base + 1);
+        }
+        return snprintf(buffer, 24, "%d;2;%u;%u;%u", base, (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF);
+    }
+};
+
+const int TERMINAL_TILE_WIDTH = 8;
+const int TERMINAL_TILE_HEIGHT = 3;
+const int TERMINAL_BOARD_TOP = 2;
+const int TERMINAL_BOARD_COLUMNS = BOARD_SIZE * TERMINAL_TILE_WIDTH + BOARD_SIZE + 1;
+const int TERMINAL_BOARD_ROWS = BOARD_SIZE * TERMINAL_TILE_HEIGHT + BOARD_SIZE + 1;
+const int TERMINAL_MESSAGE_ROW = TERMINAL_BOARD_TOP + TERMINAL_BOARD_ROWS + 1;
+const int TERMINAL_SCREEN_COLUMNS = 64;     // ״̬еĿ
+const int TERMINAL_SCREEN_ROWS = TERMINAL_MESSAGE_ROW + 2;
+
+const char* const TERMINAL_DIRECTION_NAMES[] = { "Left", "Right", "Up", "Down" };
+
+//  GUI Ĳְһ֡ն񣺱Ƿʾ̣ǽʤϢ
+// ɫȡȾĵɫ
+class TerminalView {
+public:
+    static void Draw(TerminalScreen& screen, const RenderState& state, const char* status) {
+        char text[64];
+        screen.Clear();
+        snprintf(text, sizeof(text), "Score: %d", state.score);
+        screen.Print(1, 0, text, TERMINAL_DEFAULT_COLOR, TERMINAL_DEFAULT_COLOR);
+        if (state.hint >= 0 && state.hint < DIRECTION_COUNT) {
+            snprintf(text, sizeof(text), "Hint: %s", TERMINAL_DIRECTION_NAMES[state.hint]);
+            screen.Print(22, 0, text, TERMINAL_DEFAULT_COLOR, TERMINAL_DEFAULT_COLOR);
+        }
+
+        int left = 1;
+        screen.Fill(left, TERMINAL_BOARD_TOP, TERMINAL_BOARD_COLUMNS, TERMINAL_BOARD_ROWS, BACKGROUND_COLOR);
+        for (int row = 0; row < BOARD_SIZE; row++) {
+            for (int col = 0; col < BOARD_SIZE; col++) {
+                int x = left + 1 + col * (TERMINAL_TILE_WIDTH + 1);
+                int y = TERMINAL_BOARD_TOP + 1 + row * (TERMINAL_TILE_HEIGHT + 1);
+                DrawTile(screen, x, y, BitBoard::GetExponent(state.board, row, col));
+            }
+        }
+
+        if (state.gameOver) {
+            PrintCentered(screen, left, TERMINAL_MESSAGE_ROW, "Game over!", MakeColor(255, 255, 255));
+        }
+        else if (state.won) {
+            PrintCentered(screen, left, TERMINAL_MESSAGE_ROW, "You win!", MakeColor(255, 215, 0));
+        }
+        if (status) {
+            screen.Print(left, TERMINAL_MESSAGE_ROW + 1, status, TERMINAL_DEFAULT_COLOR, TERMINAL_DEFAULT_COLOR);
+        }
+    }
+
+private:
+    static void PrintCentered(TerminalScreen& screen, int left, int y, const char* text, uint32_t foreground) {
+        int x = left + (TERMINAL_BOARD_COLUMNS - static_cast<int>(strlen(text))) / 2;
+        screen.Print(x, y, text, foreground, TERMINAL_DEFAULT_COLOR);
+    }
+
+    static void DrawTile(TerminalScreen& screen, int x, int y, int exponent) {
+        uint32_t background = TILE_COLORS[exponent];
+        screen.Fill(x, y, TERMINAL_TILE_WIDTH, TERMINAL_TILE_HEIGHT, background);
+        if (exponent == 0) return;
+
+        char text[8];
+        int length = snprintf(text, sizeof(text), "%d", 1 << exponent);
+        uint32_t foreground = exponent <= 2 ? TEXT_COLORS[0] : TEXT_COLORS[1];
+        screen.Print(x + (TERMINAL_TILE_WIDTH - length) / 2, y + TERMINAL_TILE_HEIGHT / 2, text, foreground, background);
+    }
+};
@@ -0,0 +1,234 @@
+// N Ԫʱѵ̲߳ҶģظͬһȨأHogwildд
+// 룺g++ -std=c++20 -O2 -DNDEBUG -pthread Train.cxx -o train
+
+#include "GameEngine.h"
+#include "NTupleNetwork.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct TrainOptions {
+    uint64_t games = 100000;
+    int threads = 0;    // 0 ʾʹȫӲ߳
+    uint64_t seed = 2048;
+    double alpha = 0.1;     // ѧϰʣƽ̯ÿȨ
+    std::string weightsPath = "ntuple.bin";     // Ѵʱмѵ
+    std::string network = "standard";       // Ԫϣstandard  small
+    uint64_t checkpointGames = 10000;
+    uint64_t reportGames = 1000;
+};
+
+// ܵĶԾͳ
+struct TrainWindow {
+    std::atomic<uint64_t> games{ 0 };
+    std::atomic<uint64_t> score{ 0 };
+    std::atomic<uint64_t> moves{ 0 };
+    std::atomic<uint64_t> wins{ 0 };
+    std::atomic<int> maxScore{ 0 };
+};
+
+static uint64_t GameSeed(uint64_t masterSeed, uint64_t gameIndex) {
+    return SplitMix64(masterSeed ^ SplitMix64(gameIndex));
+}
+
+// ƶ棨afterstateϵ TD(0)V(s')  r' + V(s'') s'' Ϊһѡеƶ棬վĿΪ 0
+static void TrainGame(NTupleNetwork& network, float rate, uint64_t seed, TrainWindow& window) {
+    GameEngine game(seed);
+    game.NewGame();
+
+    Board previous = 0;
+    bool hasPrevious = false;
+    uint64_t moves = 0;
+    while (!game.IsGameOver()) {
+        Direction move;
+        float value = 0.0f;
+        if (!network.ChooseMove(game.GetBoard(), move, &value)) {
+            break;
+        }
+        if (hasPrevious) {
+            network.Update(previous, rate * (value - network.Evaluate(previous)));
+        }
+
+        game.Move(move);
+        previous = game.GetBoard();
+        hasPrevious = true;
+        game.AddRandomTile();
+        game.CheckGameOver();
+        moves++;
+    }
+    if (hasPrevious) {
+        network.Update(previous, rate * -network.Evaluate(previous));
+    }
+
+    int score = game.GetScore();
+    window.games.fetch_add(1, std::memory_order_relaxed);
+    window.score.fetch_add(static_cast<uint64_t>(score), std::memory_order_relaxed);
+    window.moves.fetch_add(moves, std::memory_order_relaxed);
+    if (game.IsWon()) window.wins.fetch_add(1, std::memory_order_relaxed);
+    int best = window.maxScore.load(std::memory_order_relaxed);
+    while (score > best && !window.maxScore.compare_exchange_weak(best, score, std::memory_order_relaxed)) {
+    }
+}
+
+static std::unique_ptr<NTupleNetwork> OpenNetwork(const TrainOptions& options) {
+    std::error_code error;
+    if (std::filesystem::exists(options.weightsPath, error)) {
+        return std::make_unique<NTupleNetwork>(options.weightsPath, true);
+    }
+    if (options.network == "small") {
+        return std::make_unique<NTupleNetwork>(NTupleNetwork::SmallShapes());
+    }
+    return std::make_unique<NTupleNetwork>(NTupleNetwork::StandardShapes());
+}
+
+static void PrintUsage(const char* program) {
+    fprintf(stderr,
+        "usage: %s [--games N] [--threads N] [--seed N] [--alpha X] [--weights FILE]\n"
+        "          [--network standard|small] [--checkpoint N] [--report N]\n", program);
+}
+
+int main(int argc, char** argv) {
+    TrainOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        if (strcmp(arg, "--games") == 0) options.games = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--threads") == 0) options.threads = atoi(value);
+        else if (strcmp(arg, "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--alpha") == 0) options.alpha = atof(value);
+        else if (strcmp(arg, "--weights") == 0) options.weightsPath = value;
+        else if (strcmp(arg, "--network") == 0) options.network = value;
+        else if (strcmp(arg, "--checkpoint") == 0) options.checkpointGames = strtoull(value, nullptr, 10);
+        else if (strcmp(arg, "--report") == 0) options.reportGames = strtoull(value, nullptr, 10);
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    if (options.threads <= 0) {
+        options.threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (options.threads <= 0) options.threads = 1;
+    }
+    if (options.games == 0 || options.alpha <= 0.0 || options.reportGames == 0 ||
+        (options.network != "standard" && options.network != "small")) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        std::unique_ptr<NTupleNetwork> network = OpenNetwork(options);
+        uint64_t firstGame = network->GetTrainedGames();
+        float rate = static_cast<float>(options.alpha / network->GetFeatureCount());
+        printf("network     : %zu tuples, %zu weights (%.1f MB), %s gather\n", network->GetShapes().size(),
+            network->GetWeightCount(), network->GetWeightCount() * sizeof(float) / 1048576.0,
+            network->UsesGather() ? "avx2" : "scalar");
+        printf("training    : %llu games on %d threads from game %llu, alpha %g\n\n",
+            static_cast<unsigned long long>(options.games), options.threads,
+            static_cast<unsigned long long>(firstGame), options.alpha);
+
+        // ѵʱѵĶԾӣظ֮ǰĶԾ
+        std::atomic<uint64_t> nextGame(0);
+        std::atomic<uint64_t> finished(0);
+        std::atomic<int> running(options.threads);
+        TrainWindow window;
+        std::exception_ptr failure;
+        std::mutex failureMutex;
+
+        auto worker = [&]() {
+            try {
+                for (;;) {
+                    uint64_t index = nextGame.fetch_add(1, std::memory_order_relaxed);
+                    if (index >= options.games) break;
+                    TrainGame(*network, rate, GameSeed(options.seed, firstGame + index), window);
+                    finished.fetch_add(1, std::memory_order_release);
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+                nextGame.store(options.games, std::memory_order_relaxed);
+            }
+            running.fetch_sub(1, std::memory_order_release);
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> pool;
+        for (int i = 0; i < options.threads; i++) {
+            pool.emplace_back(worker);
+        }
+
+        // ̸߳𱨸㣬ѵ̲߳Ϊдļͣ
+        uint64_t nextReport = options.reportGames;
+        uint64_t nextCheckpoint = options.checkpointGames ? options.checkpointGames : UINT64_MAX;
+        for (;;) {
+            bool complete = running.load(std::memory_order_acquire) == 0;
+            uint64_t done = finished.load(std::memory_order_acquire);
+            if (done >= nextReport || (complete && window.games.load(std::memory_order_relaxed) > 0)) {
+                uint64_t games = window.games.exchange(0, std::memory_order_relaxed);
+                uint64_t score = window.score.exchange(0, std::memory_order_relaxed);
+                uint64_t moves = window.moves.exchange(0, std::memory_order_relaxed);
+                uint64_t wins = window.wins.exchange(0, std::memory_order_relaxed);
+                int maxScore = window.maxScore.exchange(0, std::memory_order_relaxed);
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                printf("%10llu games  mean %9.1f  max %7d  2048 %5.1f%%  %8.0f moves/game  %7.1f games/s\n",
+                    static_cast<unsigned long long>(firstGame + done), games ? static_cast<double>(score) / games : 0.0,
+                    maxScore, games ? 100.0 * wins / games : 0.0, games ? static_cast<double>(moves) / games : 0.0,
+                    done / seconds);
+                fflush(stdout);
+                while (nextReport <= done) nextReport += options.reportGames;
+            }
+            if (done >= nextCheckpoint && !complete) {
+                // дʧܣ·Чʱѵ̳߳һѵ߳ͣ£Ϻٱ
+                try {
+                    network->SetTrainedGames(firstGame + done);
+                    network->Save(options.weightsPath);
+                    while (nextCheckpoint <= done) nextCheckpoint += options.checkpointGames;
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(failureMutex);
+                    if (!failure) failure = std::current_exception();
+                    nextGame.store(options.games, std::memory_order_relaxed);
+                    nextCheckpoint = UINT64_MAX;
+                }
+            }
+            if (complete) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+
+        network->SetTrainedGames(firstGame + finished.load());
+        network->Save(options.weightsPath);
+        printf("\nsaved %s after %llu games\n", options.weightsPath.c_str(),
+            static_cast<unsigned long long>(network->GetTrainedGames()));
+    }
+    catch (const std::exception& e) {
+        fprintf(stderr, "training failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "BitBoard.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// ûͳƣ߳ڱۼƣʱһԺϲ
+struct TableStats {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    uint64_t stores = 0;
+
+    double HitRate() const {
+        return probes ? static_cast<double>(hits) / probes : 0.0;
+    }
+};
+
+// û̶СÿͰ 4 ռһ 64 ֽڻ
+// Ϊ淶̣8 ֶԳƾ湲һÿ key ^ data  data
+// ȡʱ򲻵ڼΪд˺ѣδд˲Ҫκ
+class TranspositionTable {
+public:
+    static const int NO_MOVE = -1;
+
+    struct Entry {
+        double value;
+        int depth;
+        int move;   // 淶ϵѷNO_MOVE ʾû
+    };
+
+private:
+    static const int BUCKET_ENTRIES = 4;
+
+    struct alignas(64) Bucket {
+        std::atomic<uint64_t> check[BUCKET_ENTRIES];
+        std::atomic<uint64_t> data[BUCKET_ENTRIES];
+    };
+
+    std::vector<Bucket> buckets;
+    uint64_t bucketMask;
+    std::atomic<uint8_t> generation;
+    std::atomic<uint64_t> probes;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> stores;
+
+    // data ֣[31:0] ֵfloat  [39:32]   [47:40]   [50:48] ѷ + 1  [51] Чλ
+    static const uint64_t VALID_BIT = uint64_t(1) << 51;
+
+    static uint64_t Pack(double value, int depth, int move, uint8_t age) {
+        float narrowed = static_cast<float>(value);
+        uint32_t bits = 0;
+        memcpy(&bits, &narrowed, sizeof(bits));
+        return bits |
+            (static_cast<uint64_t>(depth & 0xFF) << 32) |
+            (static_cast<uint64_t>(age) << 40) |
+            (static_cast<uint64_t>(move + 1) << 48) |
+            VALID_BIT;
+    }
+
+    static Entry Unpack(uint64_t data) {
+        uint32_t bits = static_cast<uint32_t>(data);
+        float value = 0.0f;
+        memcpy(&value, &bits, sizeof(value));
+        return { value, static_cast<int>((data >> 32) & 0xFF), static_cast<int>((data >> 48) & 0x7) - 1 };
+    }
+
+    static int DepthOf(uint64_t data) { return static_cast<int>((data >> 32) & 0xFF); }
+    static uint8_t AgeOf(uint64_t data) { return static_cast<uint8_t>(data >> 40); }
+
+    Bucket& GetBucket(uint64_t key) {
+        return buckets[(key * 0x9E3779B97F4A7C15ULL >> 32) & bucketMask];
+    }
+
+public:
+    // megabytes ȡ 2 ݸͰ
+    explicit TranspositionTable(size_t megabytes = 16) : bucketMask(0), generation(0), probes(0), hits(0), stores(0) {
+        Resize(megabytes);
+    }
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    void Resize(size_t megabytes) {
+        size_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024) {
+            count *= 2;
+        }
+        buckets = std::vector<Bucket>(count);
+        bucketMask = count - 1;
+        Clear();
+    }
+
+    size_t GetSizeBytes() const { return buckets.size() * sizeof(Bucket); }
+    size_t GetCapacity() const { return buckets.size() * BUCKET_ENTRIES; }
+
+    void Clear() {
+        for (Bucket& bucket : buckets) {
+            for (int i = 0; i < BUCKET_ENTRIES; i++) {
+                bucket.check[i].store(0, std::memory_order_relaxed);
+                bucket.data[i].store(0, std::memory_order_relaxed);
+            }
+        }
+        probes = 0;
+        hits = 0;
+        stores = 0;
+    }
+
+    // ÿʼʱãɴȱ滻Կ
+    void NewSearch() {
+        generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // key ӦΪ淶̣ɸֽڵ͵ֵ
+    bool Probe(uint64_t key, Entry& entry) {
+        Bucket& bucket = GetBucket(key);
+        for (int i = 0; i < BUCKET_ENTRIES; i++) {
+            uint64_t data = bucket.data[i].load(std::memory_order_relaxed);
+            uint64_t check = bucket.check[i].load(std::memory_order_relaxed);
+            if (data != 0 && (check ^ data) == key) {
+                entry = Unpack(data);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 滻ԣֻͬǳĽǣÿٷ滻ɡǳ
+    void Store(uint64_t key, double value, int depth, int move = NO_MOVE) {
+        Bucket& bucket = GetBucket(key);
+        uint8_t age = generation.load(std::memory_order_relaxed);
+        uint64_t packed = Pack(value, depth, move, age);
+
+        int victim = 0;
+        int victimScore = INT32_MAX;
+        for (int i = 0; i < BUCKET_ENTRIES; i++) {
+            uint64_t data = bucket.data[i].load(std::memory_order_relaxed);
+            uint64_t check = bucket.check[i].load(std::memory_order_relaxed);
+
+            if (data != 0 && (check ^ data) == key) {
+                if (DepthOf(data) > depth) {
+                    return;
+                }
+                victim = i;
+                break;
+            }
+
+            int score = data == 0 ? -1024 : DepthOf(data) - 16 * static_cast<uint8_t>(age - AgeOf(data));
+            if (score < victimScore) {
+                victimScore = score;
+                victim = i;
+            }
+        }
+
+        bucket.data[victim].store(packed, std::memory_order_relaxed);
+        bucket.check[victim].store(key ^ packed, std::memory_order_relaxed);
+    }
+
+    void RecordStats(const TableStats& local) {
+        probes.fetch_add(local.probes, std::memory_order_relaxed);
+        hits.fetch_add(local.hits, std::memory_order_relaxed);
+        stores.fetch_add(local.stores, std::memory_order_relaxed);
+    }
+
+    TableStats GetStats() const {
+        TableStats stats;
+        stats.probes = probes.load(std::memory_order_relaxed);
+        stats.hits = hits.load(std::memory_order_relaxed);
+        stats.stores = stores.load(std::memory_order_relaxed);
+        return stats;
+    }
+};
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "SaveFormat.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ʷеһ棺̡״̬־SAVE_FLAG_* 13 ֽ
+#pragma pack(push, 1)
+struct HistoryEntry {
+    uint64_t board;
+    uint32_t score;
+    uint8_t flags;
+};
+#pragma pack(pop)
+
+// /ʷ̶Ļλľ棬ÿֻһγʱдȡڴ档
+// ļʱλװɣܶಽ£һдϵջļУ
+// Ҫʱأ˳Ȳڴƣδʱɵľ档
+// ߿ Push ߡGetPosition/RewindTo صֲ
+class UndoHistory {
+private:
+    // Թ̶ȼ¼ΪλĴջѹ͵
+    class SpillStack {
+    private:
+        std::filesystem::path path;
+        std::fstream file;
+        uint64_t count;
+
+    public:
+        SpillStack() : count(0) {
+        }
+
+        ~SpillStack() {
+            if (file.is_open()) {
+                file.close();
+                std::error_code ignored;
+                std::filesystem::remove(path, ignored);
+            }
+        }
+
+        void SetPath(const std::filesystem::path& filePath) {
+            path = filePath;
+        }
+
+        bool IsEnabled() const { return !path.empty(); }
+        uint64_t GetCount() const { return count; }
+
+        void Clear() {
+            count = 0;
+        }
+
+        void Push(const HistoryEntry* entries, size_t entryCount) {
+            Open();
+            file.seekp(static_cast<std::streamoff>(count * sizeof(HistoryEntry)));
+            file.write(reinterpret_cast<const char*>(entries), entryCount * sizeof(HistoryEntry));
+            if (file.fail()) {
+                throw std::runtime_error("failed writing undo history spill file");
+            }
+            count += entryCount;
+        }
+
+        void Pop(HistoryEntry* entries, size_t entryCount) {
+            if (entryCount > count) {
+                throw std::logic_error("undo history spill underflow");
+            }
+            count -= entryCount;
+            file.seekg(static_cast<std::streamoff>(count * sizeof(HistoryEntry)));
+            file.read(reinterpret_cast<char*>(entries), entryCount * sizeof(HistoryEntry));
+            if (file.fail()) {
+                throw std::runtime_error("failed reading undo history spill file");
+            }
+        }
+
+    private:
+        void Open() {
+            if (file.is_open()) return;
+
+            file.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                throw std::runtime_error("cannot create undo history spill file");
+            }
+        }
+    };
+
+    std::vector<HistoryEntry> ring;
+    std::vector<HistoryEntry> transfer;     // ʱתʱһη
+    uint64_t mask;
+    uint64_t chunk;
+    // б [begin, end) ľ棬current Ϊǰ棻 < begin  older>= end  newer
+    uint64_t begin;
+    uint64_t current;
+    uint64_t end;
+    SpillStack older;
+    SpillStack newer;
+
+public:
+    // capacity ȡ 2 ݣ 4spillPath Ϊʱд̣ɾ汻
+    explicit UndoHistory(size_t capacity = 1024, const std::filesystem::path& spillPath = {})
+        : mask(0), chunk(0), begin(0), current(0), end(1) {
+        size_t size = 4;
+        while (size < capacity) size *= 2;
+        ring.resize(size);
+        mask = size - 1;
+        chunk = size / 4;
+        transfer.resize(chunk);
+
+        if (!spillPath.empty()) {
+            older.SetPath(spillPath.string() + ".older");
+            newer.SetPath(spillPath.string() + ".newer");
+        }
+        ring[0] = HistoryEntry();
+    }
+
+    UndoHistory(const UndoHistory&) = delete;
+    UndoHistory& operator=(const UndoHistory&) = delete;
+
+    static HistoryEntry MakeEntry(const GameEngine& engine) {
+        HistoryEntry entry;
+        entry.board = engine.GetBoard();
+        entry.score = static_cast<uint32_t>(engine.GetScore());
+        entry.flags = (engine.IsGameOver() ? SAVE_FLAG_GAME_OVER : 0) | (engine.IsWon() ? SAVE_FLAG_WON : 0);
+        return entry;
+    }
+
+    static void ApplyEntry(const HistoryEntry& entry, GameEngine& engine) {
+        engine.SetState(entry.board, static_cast<int>(entry.score),
+            (entry.flags & SAVE_FLAG_GAME_OVER) != 0, (entry.flags & SAVE_FLAG_WON) != 0);
+    }
+
+    // ʷ state ΪΨһľ棨Ϸã
+    void Reset(const HistoryEntry& state) {
+        begin = 0;
+        current = 0;
+        end = 1;
+        older.Clear();
+        newer.Clear();
+        ring[0] = state;
+    }
+
+    // ߳µһãпľ
+    void Push(const HistoryEntry& state) {
+        end = current + 1;
+        newer.Clear();
+        if (end - begin == ring.size()) {
+            if (older.IsEnabled()) {
+                SpillOldest();
+            }
+            else {
+                begin++;
+            }
+        }
+
+        ring[end & mask] = state;
+        current = end;
+        end++;
+    }
+
+    const HistoryEntry& GetCurrent() const { return ring[current & mask]; }
+
+    bool CanUndo() const { return current > begin || older.GetCount() > 0; }
+    bool CanRedo() const { return current + 1 < end || newer.GetCount() > 0; }
+
+    // ǰţReset ֮߹Ĳ
+    uint64_t GetPosition() const { return current; }
+
+    bool Undo(HistoryEntry& state) {
+        if (current == begin) {
+            if (older.GetCount() == 0) {
+                return false;
+            }
+            LoadOlder();
+        }
+
+        current--;
+        state = ring[current & mask];
+        return true;
+    }
+
+    bool Redo(HistoryEntry& state) {
+        if (current + 1 == end) {
+            if (newer.GetCount() == 0) {
+                return false;
+            }
+            LoadNewer();
+        }
+
+        current++;
+        state = ring[current & mask];
+        return true;
+    }
+
+    // ˻ǰ֮ǰµţþѱʱ false ͣܵ
+    bool RewindTo(uint64_t position, HistoryEntry& state) {
+        state = GetCurrent();
+        while (current > position) {
+            if (!Undo(state)) return false;
+        }
+        while (current < position) {
+            if (!Redo(state)) return false;
+        }
+        return true;
+    }
+
+private:
+    void CopyOut(uint64_t first, HistoryEntry* entries) const {
+        for (uint64_t i = 0; i < chunk; i++) {
+            entries[i] = ring[(first + i) & mask];
+        }
+    }
+
+    void CopyIn(uint64_t first, const HistoryEntry* entries) {
+        for (uint64_t i = 0; i < chunk; i++) {
+            ring[(first + i) & mask] = entries[i];
+        }
+    }
+
+    void SpillOldest() {
+        CopyOut(begin, transfer.data());
+        older.Push(transfer.data(), chunk);
+        begin += chunk;
+    }
+
+    void SpillNewest() {
+        CopyOut(end - chunk, transfer.data());
+        newer.Push(transfer.data(), chunk);
+        end -= chunk;
+    }
+
+    // ʱȰһ˵һдڳλãǰڻһˣᱻд
+    void LoadOlder() {
+        if (end - begin + chunk > ring.size()) {
+            SpillNewest();
+        }
+        older.Pop(transfer.data(), chunk);
+        begin -= chunk;
+        CopyIn(begin, transfer.data());
+    }
+
+    void LoadNewer() {
+        if (end - begin + chunk > ring.size()) {
+            SpillOldest();
+        }
+        newer.Pop(transfer.data(), chunk);
+        CopyIn(end, transfer.data());
+        end += chunk;
+    }
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "BitBoard.h"
+#include "GameEngine.h"
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+// ǿѧϰõһεƽ֣ǵṩ飨± i Ӧ i ֣
+// м䲻κο GameEngine ȫͬΪϲ÷֣ CanMove Ϊ١
+// Ծֽһ done = 1ؿͬһ̺ͺϷѾ¾ֵ
+class VectorEnvironment {
+public:
+    static const size_t PARALLEL_CHUNK = 1024;  // ÿ̳߳ľ
+
+private:
+    struct Slot {
+        GameEngine game;
+        uint64_t seed;
+        uint64_t episode;
+
+        explicit Slot(uint64_t initialSeed) : game(initialSeed), seed(initialSeed), episode(0) {
+        }
+    };
+
+    std::vector<Slot> slots;
+    std::unique_ptr<WorkStealingPool> pool;
+
+public:
+    // threads  1 ʱȫڵִ߳У򴴽ӦĹ߳
+    explicit VectorEnvironment(int threads = 1) {
+        if (threads > 1) {
+            pool = std::make_unique<WorkStealingPool>(threads);
+        }
+    }
+
+    size_t GetCount() const { return slots.size(); }
+
+    // ؽ count ֲ֣seeds Ϊʱ i ֵΪ SplitMix64(i)Ϊ
+    void Reset(size_t count, const uint64_t* seeds, uint64_t* outBoards, uint8_t* outLegalMask) {
+        slots.clear();
+        slots.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            slots.emplace_back(seeds ? seeds[i] : SplitMix64(i));
+        }
+
+        ForChunks([&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                slots[i].game.NewGame();
+                if (outBoards) outBoards[i] = slots[i].game.GetBoard();
+                if (outLegalMask) outLegalMask[i] = static_cast<uint8_t>(slots[i].game.GetLegalMoves());
+            }
+        });
+    }
+
+    // actions[i] Ϊ i ֵķ0 1 ҡ2 ϡ3 £Ϸ߷ı̣Ϊ 0
+    // һԽʱ׳ std::invalid_argumentʱжԾֶûбƽΪ
+    void Step(const uint8_t* actions, uint64_t* outBoards, float* outRewards, uint8_t* outDone, uint8_t* outLegalMask) {
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (actions[i] >= DIRECTION_COUNT) {
+                throw std::invalid_argument("action out of range");
+            }
+        }
+
+        ForChunks([&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                Slot& slot = slots[i];
+                int before = slot.game.GetScore();
+                bool done = false;
+                if (slot.game.Move(static_cast<Direction>(actions[i]))) {
+                    slot.game.AddRandomTile();
+                    slot.game.CheckGameOver();
+                    done = slot.game.IsGameOver();
+                }
+                if (outRewards) outRewards[i] = static_cast<float>(slot.game.GetScore() - before);
+                if (outDone) outDone[i] = done;
+
+                if (done) {
+                    slot.episode++;
+                    slot.game.Seed(SplitMix64(slot.seed + slot.episode * 0x9E3779B97F4A7C15ULL));
+                    slot.game.NewGame();
+                }
+                // CheckGameOver Ѿ룬ﲻٲϷ߷һ
+                if (outBoards) outBoards[i] = slot.game.GetBoard();
+                if (outLegalMask) outLegalMask[i] = static_cast<uint8_t>(slot.game.GetLegalMoves());
+            }
+        });
+    }
+
+private:
+    // û̳߳ʱֱڵִ߳
+    template <typename Body>
+    void ForChunks(Body body) {
+        size_t count = slots.size();
+        if (!pool || count < 2 * PARALLEL_CHUNK) {
+            body(0, count);
+            return;
+        }
+
+        TaskGroup group(*pool);
+        for (size_t begin = 0; begin < count; begin += PARALLEL_CHUNK) {
+            size_t end = (std::min)(count, begin + PARALLEL_CHUNK);
+            group.Run([&body, begin, end]() { body(begin, end); });
+        }
+        group.Wait();
+    }
+};
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ȡ̳߳أÿ߳ԼУӶβȡԼ񣬿ʱжȡ
+class WorkStealingPool {
+public:
+    typedef std::function<void()> Task;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<int> queuedTasks;
+    std::atomic<unsigned> nextQueue;
+    std::atomic<bool> stopping;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    static thread_local WorkStealingPool* currentPool;
+    static thread_local int currentIndex;
+
+public:
+    // threadCount Ϊ 0 ʱʹȫӲ߳
+    explicit WorkStealingPool(int threadCount = 0) : queuedTasks(0), nextQueue(0), stopping(false) {
+        if (threadCount <= 0) {
+            threadCount = static_cast<int>(std::thread::hardware_concurrency());
+            if (threadCount <= 0) threadCount = 1;
+        }
+
+        for (int i = 0; i < threadCount; i++) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        for (int i = 0; i < threadCount; i++) {
+            threads.emplace_back([this, i]() { WorkerLoop(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int GetThreadCount() const { return static_cast<int>(threads.size()); }
+
+    // ߳ύԼĶУⲿ߳ύ
+    void Submit(Task task) {
+        int index = currentPool == this
+            ? currentIndex
+            : static_cast<int>(nextQueue.fetch_add(1, std::memory_order_relaxed) % workers.size());
+        {
+            std::lock_guard<std::mutex> lock(workers[index]->mutex);
+            workers[index]->tasks.push_back(std::move(task));
+        }
+        queuedTasks.fetch_add(1, std::memory_order_release);
+        {
+            //  WorkerLoop ежͬⶪʧ
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wake.notify_one();
+    }
+
+    // ִһԼĻȡģûʱ falseȴʱɵ߳Эִ
+    bool RunOne() {
+        Task task;
+        if (!TakeTask(task)) {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+private:
+    bool TakeTask(Task& task) {
+        if (queuedTasks.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+
+        int count = static_cast<int>(workers.size());
+        int self = currentPool == this ? currentIndex : -1;
+
+        if (self >= 0) {
+            Worker& own = *workers[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        int start = self >= 0 ? self + 1 : 0;
+        for (int i = 0; i < count; i++) {
+            Worker& victim = *workers[(start + i) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void WorkerLoop(int index) {
+        currentPool = this;
+        currentIndex = index;
+
+        while (!stopping) {
+            if (RunOne()) continue;
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this]() {
+                return stopping || queuedTasks.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+};
+
+inline thread_local WorkStealingPool* WorkStealingPool::currentPool = nullptr;
+inline thread_local int WorkStealingPool::currentIndex = -1;
+
+// һɵȴWait ڼ߳ҲִгеǶײֲ
+class TaskGroup {
+private:
+    WorkStealingPool& pool;
+    std::atomic<int> pending;
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+public:
+    explicit TaskGroup(WorkStealingPool& taskPool) : pool(taskPool), pending(0) {
+    }
+
+    ~TaskGroup() {
+        WaitQuietly();
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void Run(std::function<void()> task) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        pool.Submit([this, task = std::move(task)]() {
+            try {
+                task();
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+            }
+            pending.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    void Wait() {
+        WaitQuietly();
+        if (failure) {
+            std::exception_ptr error = failure;
+            failure = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    void WaitQuietly() {
+        while (pending.load(std::memory_order_acquire) > 0) {
+            if (!pool.RunOne()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+};
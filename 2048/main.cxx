@@ -11,7 +11,12 @@
 #include <memory>
 #include <algorithm>
 #include <cstdint>
-#include <cmath>
+
+#include "AutoSave.h"
+#include "SaveFormat.h"
+#include "SoftwareRenderer.h"
+#include "UndoHistory.h"
+#include "ParallelSearch.h"
 
 #pragma comment(lib, "comctl32.lib")
 #pragma comment(linker, "/manifestdependency:\"type='win32' name='Microsoft.Windows.Common-Controls' version='6.0.0.0' processorArchitecture='*' publicKeyToken='6595b64144ccf1df' language='*'\"")
@@ -20,108 +25,17 @@
 #define COMPILE_TIME __DATE__ " " __TIME__
 
 // Ϸ
-const int BOARD_SIZE = 4;
-const int TILE_SIZE = 80;
-const int BOARD_MARGIN = 10;
 const int WINDOW_WIDTH = 500;
 const int WINDOW_HEIGHT = 500;
-const uint32_t SAVE_FILE_VERSION = 1;
-const char SAVE_FILE_HEADER[9] = "2048SAVE";
-
-// ɫ
-COLORREF TILE_COLORS[] = {
-    RGB(205, 193, 180), // 0
-    RGB(238, 228, 218), // 2
-    RGB(237, 224, 200), // 4
-    RGB(242, 177, 121), // 8
-    RGB(245, 149, 99),  // 16
-    RGB(246, 124, 95),  // 32
-    RGB(246, 94, 59),   // 64
-    RGB(237, 207, 114), // 128
-    RGB(237, 204, 97),  // 256
-    RGB(237, 200, 80),  // 512
-    RGB(237, 197, 63),  // 1024
-    RGB(237, 194, 46)   // 2048
-};
+const UINT_PTR AUTOPLAY_TIMER_ID = 1;
+const UINT AUTOPLAY_INTERVAL_MS = 100;
+const char* AUTOSAVE_FILE_NAME = "2048-autosave.bin";
+const char* EVAL_CACHE_FILE_NAME = "2048-evalcache.bin";  // ʾԶϷĳ־ûֵ
+const char* HEURISTIC_FILE_NAME = "2048-heuristic.txt";   // ѡľֵ̬Ȩ
 
-COLORREF TEXT_COLORS[] = {
-    RGB(119, 110, 101),
-    RGB(249, 246, 242)
-};
+const wchar_t* DIRECTION_NAMES[] = { L"", L"", L"", L"" };
 
 // RAIIԴ
-class GDIBrush {
-private:
-    HBRUSH hBrush;
-public:
-    explicit GDIBrush(COLORREF color) : hBrush(CreateSolidBrush(color)) {
-        if (!hBrush) {
-            throw std::runtime_error("Failed to create GDI brush");
-        }
-    }
-
-    ~GDIBrush() {
-        if (hBrush) {
-            DeleteObject(hBrush);
-        }
-    }
-
-    GDIBrush(GDIBrush&& other) noexcept : hBrush(other.hBrush) {
-        other.hBrush = nullptr;
-    }
-
-    GDIBrush& operator=(GDIBrush&& other) noexcept {
-        if (this != &other) {
-            if (hBrush) DeleteObject(hBrush);
-            hBrush = other.hBrush;
-            other.hBrush = nullptr;
-        }
-        return *this;
-    }
-
-    GDIBrush(const GDIBrush&) = delete;
-    GDIBrush& operator=(const GDIBrush&) = delete;
-
-    operator HBRUSH() const { return hBrush; }
-    HBRUSH Get() const { return hBrush; }
-};
-
-class GDIPen {
-private:
-    HPEN hPen;
-public:
-    explicit GDIPen(int style, int width, COLORREF color) : hPen(CreatePen(style, width, color)) {
-        if (!hPen) {
-            throw std::runtime_error("Failed to create GDI pen");
-        }
-    }
-
-    ~GDIPen() {
-        if (hPen) {
-            DeleteObject(hPen);
-        }
-    }
-
-    GDIPen(GDIPen&& other) noexcept : hPen(other.hPen) {
-        other.hPen = nullptr;
-    }
-
-    GDIPen& operator=(GDIPen&& other) noexcept {
-        if (this != &other) {
-            if (hPen) DeleteObject(hPen);
-            hPen = other.hPen;
-            other.hPen = nullptr;
-        }
-        return *this;
-    }
-
-    GDIPen(const GDIPen&) = delete;
-    GDIPen& operator=(const GDIPen&) = delete;
-
-    operator HPEN() const { return hPen; }
-    HPEN Get() const { return hPen; }
-};
-
 class GDIFont {
 private:
     HFONT hFont;
@@ -162,63 +76,93 @@ public:
     HFONT Get() const { return hFont; }
 };
 
-// Ϸ״̬ṹ
-#pragma pack(push, 1)
-struct GameState {
-    int board[BOARD_SIZE][BOARD_SIZE];
-    int score;
-    bool gameOver;
-    bool won;
-    uint32_t checksum;
-};
-#pragma pack(pop)
-
 class Game2048 {
 private:
-    GameState state;
+    GameEngine engine;
+    std::unique_ptr<WorkStealingPool> searchPool;
+    std::unique_ptr<EvaluationCache> evalCache;
+    std::unique_ptr<ParallelExpectimax> solver;
+    std::unique_ptr<UndoHistory> history;
+    std::unique_ptr<AutoSaver> autosave;
+    bool autosaveFailed;    // ǰǷʾԶʧ
+    SoftwareRenderer renderer;
     HWND hwnd;
     std::unique_ptr<GDIFont> hMainFont;
+    std::unique_ptr<GDIFont> hMessageFont;
     bool keyboardEnabled;
     bool keyProcessed; // ٵǰǷѴ
+    bool autoPlay;
+    int hintDirection; // -1 ʾûʾ
 
 public:
-    Game2048() : hwnd(nullptr), keyboardEnabled(true), keyProcessed(false) {
-        ResetState();
+    Game2048() : autosaveFailed(false), hwnd(nullptr), keyboardEnabled(true), keyProcessed(false), autoPlay(false),
+        hintDirection(-1) {
     }
 
     void Initialize(HWND window) {
         hwnd = window;
         try {
             hMainFont = std::make_unique<GDIFont>(24);
-            NewGame();
+            hMessageFont = std::make_unique<GDIFont>(36);
+            RECT clientRect;
+            if (GetClientRect(hwnd, &clientRect)) {
+                renderer.Resize(clientRect.right, clientRect.bottom);
+            }
+            // Ȩڴǰ룬ļͷ¼ĹֵʶȨļЧʱĬȨ
+            if (std::filesystem::exists(HEURISTIC_FILE_NAME)) {
+                try {
+                    Heuristic::LoadActive(HEURISTIC_FILE_NAME);
+                }
+                catch (const std::exception&) {
+                    MessageBox(hwnd, L"ֵȨļЧʹĬȨ", L"", MB_OK | MB_ICONWARNING);
+                }
+            }
+            searchPool = std::make_unique<WorkStealingPool>();
+            solver = std::make_unique<ParallelExpectimax>(*searchPool);
+            // ֻǼ٣ļ𻵻汾Ĺֵдʱ
+            try {
+                evalCache = std::make_unique<EvaluationCache>(EVAL_CACHE_FILE_NAME, 64, ExpectimaxSearch::EvaluatorId());
+                solver->SetCache(evalCache.get());
+            }
+            catch (const std::exception&) {
+                evalCache.reset();
+            }
+            // ڴ 1024 ʷдʱĿ¼ļ
+            history = std::make_unique<UndoHistory>(1024, std::filesystem::temp_directory_path() /
+                (L"2048-undo-" + std::to_wstring(GetCurrentProcessId())));
+            autosave = std::make_unique<AutoSaver>(AUTOSAVE_FILE_NAME);
+
+            // ϴ˳ʱδĶԾִԶ浵
+            PackedGameState saved;
+            if (AutoSaver::Load(AUTOSAVE_FILE_NAME, saved) && !(saved.flags & SAVE_FLAG_GAME_OVER)) {
+                SaveFormat::ApplyPackedState(saved, engine);
+                history->Reset(UndoHistory::MakeEntry(engine));
+                Refresh();
+            }
+            else {
+                NewGame();
+            }
         }
         catch (const std::exception&) {
             throw;
         }
     }
 
-    void ResetState() {
-        memset(&state, 0, sizeof(state));
-        state.gameOver = false;
-        state.won = false;
-        state.score = 0;
-        state.checksum = 0;
-        keyProcessed = false;
-    }
-
     void NewGame() {
-        ResetState();
+        keyProcessed = false;
         keyboardEnabled = true;
+        hintDirection = -1;
 
         try {
-            AddRandomTile();
-            AddRandomTile();
+            engine.NewGame();
+            history->Reset(UndoHistory::MakeEntry(engine));
         }
         catch (const std::exception&) {
             throw;
         }
 
-        InvalidateRect(hwnd, NULL, TRUE);
+        Autosave();
+        Refresh();
     }
 
     void EnableKeyboard() {
@@ -226,208 +170,95 @@ public:
         SetFocus(hwnd);
     }
 
-    bool IsValidTileValue(int value) const {
-        if (value == 0) return true;
-        if (value < 0) return false;
-        return (value & (value - 1)) == 0;
+    void ShowHint() {
+        SearchResult best = solver->BestMove(engine.GetBoard());
+        hintDirection = best.found ? static_cast<int>(best.move) : -1;
+        Refresh();
     }
 
-    bool ValidateGameState() const {
-        if (state.score < 0) {
-            return false;
+    void ToggleAutoPlay() {
+        if (autoPlay) {
+            StopAutoPlay();
         }
-
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            for (int j = 0; j < BOARD_SIZE; j++) {
-                if (!IsValidTileValue(state.board[i][j])) {
-                    return false;
-                }
-            }
+        else {
+            autoPlay = SetTimer(hwnd, AUTOPLAY_TIMER_ID, AUTOPLAY_INTERVAL_MS, NULL) != 0;
         }
-
-        return true;
-    }
-
-    uint32_t CalculateChecksum() const {
-        uint32_t checksum = 0;
-        const uint8_t* data = reinterpret_cast<const uint8_t*>(&state);
-        size_t dataSize = sizeof(state) - sizeof(state.checksum);
-
-        for (size_t i = 0; i < dataSize; ++i) {
-            checksum = (checksum << 5) + checksum + data[i];
-        }
-
-        return checksum;
     }
 
-    void AddRandomTile() {
-        std::vector<std::pair<int, int>> emptyCells;
-
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            for (int j = 0; j < BOARD_SIZE; j++) {
-                if (state.board[i][j] == 0) {
-                    emptyCells.push_back(std::make_pair(i, j));
-                }
-            }
-        }
-
-        if (emptyCells.empty()) {
-            throw std::runtime_error("No empty cells available for new tile");
-        }
-
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, static_cast<int>(emptyCells.size()) - 1);
-        int index = dis(gen);
-        int row = emptyCells[index].first;
-        int col = emptyCells[index].second;
-
-        std::uniform_real_distribution<> prob(0.0, 1.0);
-        state.board[row][col] = (prob(gen) < 0.9) ? 2 : 4;
-
-        if (!ValidateGameState()) {
-            throw std::runtime_error("Game state invalid after adding random tile");
+    void StopAutoPlay() {
+        if (autoPlay) {
+            KillTimer(hwnd, AUTOPLAY_TIMER_ID);
+            autoPlay = false;
         }
     }
 
-    bool MoveLeft() {
-        bool moved = false;
-
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            int writePos = 0;
-            for (int j = 0; j < BOARD_SIZE; j++) {
-                if (state.board[i][j] != 0) {
-                    if (j != writePos) moved = true;
-                    state.board[i][writePos++] = state.board[i][j];
-                }
-            }
-            while (writePos < BOARD_SIZE) {
-                state.board[i][writePos++] = 0;
-            }
-
-            for (int j = 0; j < BOARD_SIZE - 1; j++) {
-                if (state.board[i][j] != 0 && state.board[i][j] == state.board[i][j + 1]) {
-                    state.board[i][j] *= 2;
-                    state.score += state.board[i][j];
-                    state.board[i][j + 1] = 0;
-
-                    if (state.board[i][j] == 2048 && !state.won) {
-                        state.won = true;
-                    }
-
-                    moved = true;
-
-                    for (int k = j + 1; k < BOARD_SIZE - 1; k++) {
-                        state.board[i][k] = state.board[i][k + 1];
-                    }
-                    state.board[i][BOARD_SIZE - 1] = 0;
-                }
+    void AutoPlayStep() {
+        try {
+            hintDirection = -1;
+            if (solver->PlayMove(engine)) {
+                history->Push(UndoHistory::MakeEntry(engine));
+                Autosave();
             }
-        }
-
-        return moved;
-    }
-
-    bool MoveRight() {
-        ReverseRows();
-        bool moved = MoveLeft();
-        ReverseRows();
-        return moved;
-    }
-
-    bool MoveUp() {
-        Transpose();
-        bool moved = MoveLeft();
-        Transpose();
-        return moved;
-    }
-
-    bool MoveDown() {
-        Transpose();
-        ReverseRows();
-        bool moved = MoveLeft();
-        ReverseRows();
-        Transpose();
-        return moved;
-    }
-
-    void ReverseRows() {
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            for (int j = 0; j < BOARD_SIZE / 2; j++) {
-                std::swap(state.board[i][j], state.board[i][BOARD_SIZE - 1 - j]);
+            else {
+                StopAutoPlay();
             }
+            Refresh();
         }
-    }
-
-    void Transpose() {
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            for (int j = i + 1; j < BOARD_SIZE; j++) {
-                std::swap(state.board[i][j], state.board[j][i]);
-            }
+        catch (const std::exception&) {
+            StopAutoPlay();
+            MessageBox(hwnd, L"ԶϷʧ", L"", MB_OK | MB_ICONERROR);
         }
     }
 
-    bool CanMove() {
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            for (int j = 0; j < BOARD_SIZE; j++) {
-                if (state.board[i][j] == 0) {
-                    return true;
-                }
-            }
-        }
-
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            for (int j = 0; j < BOARD_SIZE; j++) {
-                if ((j < BOARD_SIZE - 1 && state.board[i][j] == state.board[i][j + 1]) ||
-                    (i < BOARD_SIZE - 1 && state.board[i][j] == state.board[i + 1][j])) {
-                    return true;
-                }
-            }
-        }
-
-        return false;
+    void Resize(int width, int height) {
+        renderer.Resize(width, height);
+        Refresh();
     }
 
-    void CheckGameOver() {
-        if (!CanMove()) {
-            state.gameOver = true;
+    // 仯״̬֡壬ֻøĶʧЧWM_PAINT ʱ
+    void Refresh() {
+        PROFILE_ZONE("Render");
+        RenderState state = { engine.GetBoard(), engine.GetScore(), hintDirection, engine.IsGameOver(), engine.IsWon() };
+        for (const RenderRect& rect : renderer.Render(state)) {
+            RECT dirtyRect = { rect.left, rect.top, rect.right, rect.bottom };
+            InvalidateRect(hwnd, &dirtyRect, FALSE);
         }
     }
 
     void Draw(HDC hdc) {
+        PROFILE_ZONE("Draw");
         try {
-            RECT clientRect;
-            if (!GetClientRect(hwnd, &clientRect)) {
-                return;
-            }
-
-            GDIBrush bgBrush(RGB(187, 173, 160));
-            FillRect(hdc, &clientRect, bgBrush);
-
+            // ֡彻 GDIʵֻд BeginPaint Ч
+            const Framebuffer& frame = renderer.GetFramebuffer();
+            BITMAPINFO bitmapInfo = {};
+            bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+            bitmapInfo.bmiHeader.biWidth = frame.GetWidth();
+            bitmapInfo.bmiHeader.biHeight = -frame.GetHeight();    // ϶µ˳
+            bitmapInfo.bmiHeader.biPlanes = 1;
+            bitmapInfo.bmiHeader.biBitCount = 32;
+            bitmapInfo.bmiHeader.biCompression = BI_RGB;
+            SetDIBitsToDevice(hdc, 0, 0, frame.GetWidth(), frame.GetHeight(), 0, 0, 0, frame.GetHeight(),
+                frame.GetPixels(), &bitmapInfo, DIB_RGB_COLORS);
+
+            // Ⱦƣֻ
             HFONT hOldFont = (HFONT)SelectObject(hdc, *hMainFont);
             SetTextColor(hdc, RGB(255, 255, 255));
             SetBkMode(hdc, TRANSPARENT);
 
-            std::wstring scoreText = L": " + std::to_wstring(state.score);
-            RECT scoreRect = { 10, 10, 200, 50 };
-            DrawText(hdc, scoreText.c_str(), -1, &scoreRect, DT_LEFT | DT_VCENTER);
-
-            int boardX = (clientRect.right - (BOARD_SIZE * TILE_SIZE + (BOARD_SIZE + 1) * BOARD_MARGIN)) / 2;
-            int boardY = 60;
+            RECT labelRect = { 10, 10, SoftwareRenderer::GetScoreRect().left, 50 };
+            DrawText(hdc, L":", -1, &labelRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
 
-            for (int i = 0; i < BOARD_SIZE; i++) {
-                for (int j = 0; j < BOARD_SIZE; j++) {
-                    int x = boardX + j * (TILE_SIZE + BOARD_MARGIN);
-                    int y = boardY + i * (TILE_SIZE + BOARD_MARGIN);
-                    DrawTile(hdc, x, y, state.board[i][j]);
-                }
+            if (hintDirection >= 0) {
+                std::wstring hintText = std::wstring(L"ʾ: ") + DIRECTION_NAMES[hintDirection];
+                RECT hintRect = { 220, 10, 480, 50 };
+                DrawText(hdc, hintText.c_str(), -1, &hintRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
             }
 
-            if (state.gameOver) {
-                DrawGameOver(hdc, clientRect);
+            if (engine.IsGameOver()) {
+                DrawMessage(hdc, L"Ϸ!", RGB(255, 255, 255));
             }
-            else if (state.won) {
-                DrawWinMessage(hdc, clientRect);
+            else if (engine.IsWon()) {
+                DrawMessage(hdc, L"ϲʤ!", RGB(255, 215, 0));
             }
 
             SelectObject(hdc, hOldFont);
@@ -437,85 +268,15 @@ public:
         }
     }
 
-    void DrawTile(HDC hdc, int x, int y, int value) {
-        try {
-            int colorIndex = 0;
-            if (value > 0) {
-                colorIndex = static_cast<int>(log(value) / log(2));
-                if (colorIndex < 0) colorIndex = 0;
-                if (colorIndex >= sizeof(TILE_COLORS) / sizeof(COLORREF)) {
-                    colorIndex = sizeof(TILE_COLORS) / sizeof(COLORREF) - 1;
-                }
-            }
-
-            GDIBrush tileBrush(TILE_COLORS[colorIndex]);
-            RECT tileRect = { x, y, x + TILE_SIZE, y + TILE_SIZE };
-            FillRect(hdc, &tileRect, tileBrush);
-
-            GDIPen borderPen(PS_SOLID, 2, RGB(187, 173, 160));
-            HPEN hOldPen = (HPEN)SelectObject(hdc, borderPen);
-            HBRUSH hOldBrush = (HBRUSH)SelectObject(hdc, GetStockObject(NULL_BRUSH));
-            Rectangle(hdc, x, y, x + TILE_SIZE, y + TILE_SIZE);
-            SelectObject(hdc, hOldBrush);
-            SelectObject(hdc, hOldPen);
+    void DrawMessage(HDC hdc, const wchar_t* message, COLORREF color) {
+        HFONT hOldFont = (HFONT)SelectObject(hdc, *hMessageFont);
+        SetTextColor(hdc, color);
 
-            if (value > 0) {
-                COLORREF textColor = (value <= 4) ? TEXT_COLORS[0] : TEXT_COLORS[1];
-                SetTextColor(hdc, textColor);
+        RenderRect band = renderer.GetMessageRect();
+        RECT messageRect = { band.left, band.top, band.right, band.bottom };
+        DrawText(hdc, message, -1, &messageRect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
 
-                std::wstring text = std::to_wstring(value);
-                RECT textRect = { x, y, x + TILE_SIZE, y + TILE_SIZE };
-
-                int fontSize = 32;
-                if (value >= 1000) fontSize = 24;
-                else if (value >= 100) fontSize = 28;
-
-                GDIFont tileFont(fontSize);
-                HFONT hOldFont = (HFONT)SelectObject(hdc, tileFont);
-                DrawText(hdc, text.c_str(), -1, &textRect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
-                SelectObject(hdc, hOldFont);
-            }
-        }
-        catch (const std::exception&) {
-        }
-    }
-
-    void DrawGameOver(HDC hdc, RECT& clientRect) {
-        try {
-            GDIFont bigFont(36);
-            HFONT hOldFont = (HFONT)SelectObject(hdc, bigFont);
-
-            SetTextColor(hdc, RGB(255, 255, 255));
-            SetBkMode(hdc, TRANSPARENT);
-
-            std::wstring message = L"Ϸ!";
-            RECT messageRect = clientRect;
-            messageRect.top = clientRect.bottom - 100;
-            DrawText(hdc, message.c_str(), -1, &messageRect, DT_CENTER | DT_VCENTER);
-
-            SelectObject(hdc, hOldFont);
-        }
-        catch (const std::exception&) {
-        }
-    }
-
-    void DrawWinMessage(HDC hdc, RECT& clientRect) {
-        try {
-            GDIFont bigFont(36);
-            HFONT hOldFont = (HFONT)SelectObject(hdc, bigFont);
-
-            SetTextColor(hdc, RGB(255, 215, 0));
-            SetBkMode(hdc, TRANSPARENT);
-
-            std::wstring message = L"ϲʤ!";
-            RECT messageRect = clientRect;
-            messageRect.top = clientRect.bottom - 100;
-            DrawText(hdc, message.c_str(), -1, &messageRect, DT_CENTER | DT_VCENTER);
-
-            SelectObject(hdc, hOldFont);
-        }
-        catch (const std::exception&) {
-        }
+        SelectObject(hdc, hOldFont);
     }
 
     std::wstring GetDefaultSaveFileName() {
@@ -545,7 +306,8 @@ public:
 
     bool SaveGameWithDialog() {
         try {
-            if (!ValidateGameState()) {
+            PackedGameState snapshot = SaveFormat::CreatePackedSnapshot(engine);
+            if (!SaveFormat::ValidatePackedState(snapshot)) {
                 MessageBox(hwnd, L"Ϸ״̬Ч޷", L"", MB_OK | MB_ICONERROR);
                 return false;
             }
@@ -572,8 +334,7 @@ public:
                 file.write(SAVE_FILE_HEADER, sizeof(SAVE_FILE_HEADER));
                 file.write(reinterpret_cast<const char*>(&SAVE_FILE_VERSION), sizeof(SAVE_FILE_VERSION));
 
-                state.checksum = CalculateChecksum();
-                file.write(reinterpret_cast<const char*>(&state), sizeof(state));
+                file.write(reinterpret_cast<const char*>(&snapshot), sizeof(snapshot));
 
                 if (file.fail()) {
                     file.close();
@@ -613,9 +374,9 @@ public:
                 }
 
                 std::streamsize fileSize = file.tellg();
-                size_t expectedSize = sizeof(SAVE_FILE_HEADER) + sizeof(SAVE_FILE_VERSION) + sizeof(GameState);
+                size_t prefixSize = sizeof(SAVE_FILE_HEADER) + sizeof(SAVE_FILE_VERSION);
 
-                if (fileSize != static_cast<std::streamsize>(expectedSize)) {
+                if (fileSize < static_cast<std::streamsize>(prefixSize)) {
                     MessageBox(hwnd, L"ļСƥ", L"", MB_OK | MB_ICONERROR);
                     return false;
                 }
@@ -629,15 +390,42 @@ public:
                     return false;
                 }
 
+                // 汾 1 Ϊ̣汾 2 Ϊֶ̣Զȡ
                 uint32_t fileVersion;
                 file.read(reinterpret_cast<char*>(&fileVersion), sizeof(fileVersion));
-                if (fileVersion != SAVE_FILE_VERSION) {
+                size_t payloadSize = 0;
+                if (fileVersion == SAVE_FILE_VERSION_1) payloadSize = sizeof(GameState);
+                else if (fileVersion == SAVE_FILE_VERSION_2) payloadSize = sizeof(PackedGameState);
+                else {
                     MessageBox(hwnd, L"ֵ֧ļ汾", L"", MB_OK | MB_ICONERROR);
                     return false;
                 }
 
-                GameState loadedState;
-                file.read(reinterpret_cast<char*>(&loadedState), sizeof(loadedState));
+                if (fileSize != static_cast<std::streamsize>(prefixSize + payloadSize)) {
+                    MessageBox(hwnd, L"ļСƥ", L"", MB_OK | MB_ICONERROR);
+                    return false;
+                }
+
+                PackedGameState loadedState;
+                bool checksumValid = false;
+                bool stateValid = false;
+                if (fileVersion == SAVE_FILE_VERSION_1) {
+                    GameState legacyState;
+                    file.read(reinterpret_cast<char*>(&legacyState), sizeof(legacyState));
+
+                    uint32_t calculatedChecksum = legacyState.checksum;
+                    legacyState.checksum = 0;
+                    checksumValid = calculatedChecksum == SaveFormat::CalculateChecksum(legacyState);
+                    stateValid = SaveFormat::ValidateGameState(legacyState);
+                    if (checksumValid && stateValid) {
+                        loadedState = SaveFormat::UpgradeState(legacyState);
+                    }
+                }
+                else {
+                    file.read(reinterpret_cast<char*>(&loadedState), sizeof(loadedState));
+                    checksumValid = loadedState.checksum == SaveFormat::CalculateCrc(loadedState);
+                    stateValid = SaveFormat::ValidatePackedState(loadedState);
+                }
 
                 if (file.fail()) {
                     MessageBox(hwnd, L"ļȡʧ", L"", MB_OK | MB_ICONERROR);
@@ -646,26 +434,26 @@ public:
 
                 file.close();
 
-                uint32_t calculatedChecksum = loadedState.checksum;
-                loadedState.checksum = 0;
-                uint32_t expectedChecksum = CalculateChecksum(loadedState);
-
-                if (calculatedChecksum != expectedChecksum) {
+                if (!checksumValid) {
                     MessageBox(hwnd, L"ļУʧ", L"", MB_OK | MB_ICONERROR);
                     return false;
                 }
 
-                if (!ValidateGameState(loadedState)) {
+                if (!stateValid) {
                     MessageBox(hwnd, L"صϷ״̬Ч", L"", MB_OK | MB_ICONERROR);
                     return false;
                 }
 
-                state = loadedState;
+                SaveFormat::ApplyPackedState(loadedState, engine);
+                history->Reset(UndoHistory::MakeEntry(engine));
                 keyboardEnabled = true;
                 keyProcessed = false;
+                hintDirection = -1;
+                StopAutoPlay();
                 SetFocus(hwnd);
 
-                InvalidateRect(hwnd, NULL, TRUE);
+                Autosave();
+                Refresh();
                 return true;
             }
             return false;
@@ -676,70 +464,71 @@ public:
         }
     }
 
-    uint32_t CalculateChecksum(const GameState& gameState) const {
-        uint32_t checksum = 0;
-        const uint8_t* data = reinterpret_cast<const uint8_t*>(&gameState);
-        size_t dataSize = sizeof(gameState) - sizeof(gameState.checksum);
-
-        for (size_t i = 0; i < dataSize; ++i) {
-            checksum = (checksum << 5) + checksum + data[i];
-        }
-
-        return checksum;
-    }
-
-    bool ValidateGameState(const GameState& gameState) const {
-        if (gameState.score < 0) {
-            return false;
-        }
-
-        for (int i = 0; i < BOARD_SIZE; i++) {
-            for (int j = 0; j < BOARD_SIZE; j++) {
-                if (!IsValidTileValue(gameState.board[i][j])) {
-                    return false;
-                }
-            }
+    // ָ浫֮ɵķԭͬ
+    void StepHistory(bool redo) {
+        StopAutoPlay();
+        HistoryEntry state;
+        if (redo ? history->Redo(state) : history->Undo(state)) {
+            UndoHistory::ApplyEntry(state, engine);
+            hintDirection = -1;
+            Autosave();
+            Refresh();
         }
-
-        return true;
     }
 
     void HandleKeyPress(WPARAM wParam, LPARAM lParam) {
-        if (state.gameOver || !keyboardEnabled) return;
+        PROFILE_ZONE("HandleKeyPress");
+        if (!keyboardEnabled) return;
 
-        // ǷظϢ30λʾظ
-        if (lParam & 0x40000000) {
+        // ǷظϢ30λʾظסִ
+        if ((lParam & 0x40000000) && wParam != 'Z' && wParam != 'Y') {
             return;
         }
 
         try {
+            // ϷԿɳ
+            if (wParam == 'Z' || wParam == 'Y') {
+                StepHistory(wParam == 'Y');
+                return;
+            }
+            if (engine.IsGameOver()) return;
+
             bool moved = false;
 
             switch (wParam) {
             case VK_LEFT:
             case 'A':
-                moved = MoveLeft();
+                moved = engine.MoveLeft();
                 break;
             case VK_RIGHT:
             case 'D':
-                moved = MoveRight();
+                moved = engine.MoveRight();
                 break;
             case VK_UP:
             case 'W':
-                moved = MoveUp();
+                moved = engine.MoveUp();
                 break;
             case VK_DOWN:
             case 'S':
-                moved = MoveDown();
+                moved = engine.MoveDown();
                 break;
+            case 'H':
+                ShowHint();
+                return;
+            case 'P':
+                ToggleAutoPlay();
+                return;
             default:
                 return;
             }
 
             if (moved) {
-                AddRandomTile();
-                CheckGameOver();
-                InvalidateRect(hwnd, NULL, TRUE);
+                hintDirection = -1;
+                engine.AddRandomTile();
+                engine.CheckGameOver();
+                history->Push(UndoHistory::MakeEntry(engine));
+                Autosave();
+                Refresh();
             }
         }
         catch (const std::exception&) {
@@ -747,8 +536,36 @@ public:
         }
     }
 
+    // ÿθı䶼̨дֻ̣߳״̬ȴ̣
+    // дʧܲϷֻڱʾ֮дɹʱָ
+    void Autosave() {
+        autosave->Submit(SaveFormat::CreatePackedSnapshot(engine));
+
+        bool failed = autosave->GetStatus().lastFailed;
+        if (failed != autosaveFailed) {
+            autosaveFailed = failed;
+            wchar_t title[256];
+            GetWindowText(hwnd, title, 256);
+            std::wstring text = title;
+            const std::wstring suffix = L" - Զʧ";
+            if (failed) text += suffix;
+            else if (text.size() >= suffix.size()) text.resize(text.size() - suffix.size());
+            SetWindowText(hwnd, text.c_str());
+        }
+    }
+
     void Cleanup() {
+        StopAutoPlay();
+        // дľ棻Ժʧʱʾڴʱ
+        if (autosave && autosave->Close().lastFailed) {
+            MessageBox(NULL, L"Զľʧܣ´ӽľ", L"", MB_OK | MB_ICONWARNING);
+        }
+        autosave.reset();
+        solver.reset();
+        searchPool.reset();
+        history.reset();
         hMainFont.reset();
+        hMessageFont.reset();
     }
 };
 
@@ -870,6 +687,14 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             CreateControls(hwnd);
             break;
 
+        case WM_SIZE:
+            g_Game.Resize(LOWORD(lParam), HIWORD(lParam));
+            break;
+
+        // ֡帲ͻҪȲ
+        case WM_ERASEBKGND:
+            return 1;
+
         case WM_PAINT:
         {
             PAINTSTRUCT ps;
@@ -883,6 +708,12 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             g_Game.HandleKeyPress(wParam, lParam);
             break;
 
+        case WM_TIMER:
+            if (wParam == AUTOPLAY_TIMER_ID) {
+                g_Game.AutoPlayStep();
+            }
+            break;
+
         case WM_COMMAND:
             switch (LOWORD(wParam)) {
             case 1:
@@ -914,6 +745,8 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
                     std::wstring(COMPILE_TIME, COMPILE_TIME + strlen(COMPILE_TIME)) +
                     L"\n\n"
                     L"ʹ÷WASDƶ\n"
+                    L"H ʾһP ʼ/ֹͣԶϷ\n"
+                    L"Z Y \n"
                     L"ֵͬķײʱϲ!";
 
                 MessageBox(hwnd, aboutText.c_str(), L"", MB_OK | MB_ICONINFORMATION);
@@ -931,6 +764,15 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             break;
 
         case WM_DESTROY:
+#if defined(GAME_PROFILE)
+            // ˳ʱѸεĻܺ Chrome дǰĿ¼
+            try {
+                std::ofstream("2048-profile.txt") << Profiler::Get().FormatSummary();
+                Profiler::Get().WriteChromeTrace("2048-trace.json");
+            }
+            catch (const std::exception&) {
+            }
+#endif
             PostQuitMessage(0);
             break;
 